@@ -14,7 +14,9 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
+#include <string>
 
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
@@ -31,10 +33,33 @@ static constexpr int INVALID_TXN_ID = -1;                                     //
 static constexpr int INVALID_TIMESTAMP = -1;                                  // invalid transaction timestamp
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int PAGE_SIZE = 4096;                                        // default (and minimum) page size
+static constexpr int MAX_PAGE_SIZE = 32768;                                   // max page size of a database
 static constexpr int BUFFER_POOL_SIZE = 65536;                                // size of buffer pool
+static constexpr size_t BUFFER_POOL_MAX_SIZE = 4 * BUFFER_POOL_SIZE;          // frames reserved for online growth
+static constexpr size_t BUFFER_POOL_INSTANCES = 16;                           // independently latched pool partitions
+static constexpr size_t BUFFER_POOL_PARTITION_MIN_SIZE = 1024;                // min frames per partition of a named pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr unsigned ASYNC_IO_QUEUE_DEPTH = 32;                          // max in-flight async page I/Os
+static constexpr size_t ASYNC_IO_THREADS = 4;                                 // workers of the fallback I/O engine
+static constexpr bool USE_DIRECT_IO = false;                                  // open data files with O_DIRECT
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;                           // buffer/offset alignment for O_DIRECT
+static constexpr size_t CACHE_LINE_SIZE = 64;                                 // alignment of frame descriptors
+static constexpr bool USE_HUGE_PAGES = true;                                  // back the frame arena with huge pages
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;                     // size of a transparent huge page
+static constexpr size_t FILE_EXTENT_SIZE = 1 << 20;                           // data/log files grow by fallocate extents
+static constexpr bool USE_PAGE_COMPRESSION = false;                           // create data files in compressed mode
+static constexpr uint32_t COMPRESSED_SLOT_ALIGNMENT = 512;                    // slot granularity of compressed pages
+static constexpr int READ_AHEAD_MIN_PAGES = 4;                                // initial read-ahead window of scans
+static constexpr int READ_AHEAD_MAX_PAGES = 64;                               // max read-ahead window of scans
+static constexpr size_t BUFFER_RING_SIZE = 256 * 1024;                        // private ring of bulk scans in byte
+static constexpr int PAGE_CLEANER_INTERVAL_MS = 10;                           // idle period of the page cleaner
+static constexpr size_t PAGE_CLEANER_CLEAN_PERCENT = 10;                      // clean evictable frames to keep, in %
+static constexpr size_t PAGE_CLEANER_BATCH_PAGES = 64;                        // max pages per cleaner round
+static constexpr size_t COMPRESSED_PAGE_CACHE_SIZE = 0;                       // compressed page cache in byte, 0 = off
+static constexpr int BUFFER_POOL_DUMP_INTERVAL_MS = 60000;                    // period of the hot page list dump
+static constexpr size_t PREWARM_BATCH_PAGES = 256;                            // pages read per prewarm batch
 
 using frame_id_t = int32_t;  // frame id type, 帧页ID, 页在BufferPool中的存储单元称为帧,一帧对应一页
 using page_id_t = int32_t;   // page id type , 页ID
@@ -47,5 +72,13 @@ using timestamp_t = int32_t;  // timestamp type, used for transaction concurrenc
 // log file
 static const std::string LOG_FILE_NAME = "db.log";
 
-// replacer
-static const std::string REPLACER_TYPE = "LRU";
+// replacer: "LRU", "CLOCK", "CLOCK-LF" (lock-free CLOCK), "ARC", "LRU-K" or "LRU-<K>",
+// overridden by the RUCBASE_REPLACER environment variable
+static const std::string REPLACER_TYPE = "CLOCK-LF";
+static constexpr size_t LRUK_REPLACER_K = 2;  // K of "LRU-K"
+
+// buffer pools: the default pool holds every file that is not assigned to a named pool;
+// named pools are "<name>:<size>[:<replacer>]" separated by ',', overridden by the RUCBASE_BUFFER_POOLS
+// environment variable, e.g. "keep:4096:LRU,recycle:1024:CLOCK"
+static const std::string DEFAULT_BUFFER_POOL = "default";
+static const std::string BUFFER_POOLS = "";
@@ -44,6 +44,26 @@ class FileNotFoundError : public RedBaseError {
     FileNotFoundError(const std::string &filename) : RedBaseError("File not found: " + filename) {}
 };
 
+class InvalidPageSizeError : public RedBaseError {
+   public:
+    InvalidPageSizeError(int page_size) : RedBaseError("Invalid page size: " + std::to_string(page_size)) {}
+};
+
+class InvalidPoolSizeError : public RedBaseError {
+   public:
+    InvalidPoolSizeError(long long pool_size) : RedBaseError("Invalid buffer pool size: " + std::to_string(pool_size)) {}
+};
+
+class BufferPoolNotFoundError : public RedBaseError {
+   public:
+    BufferPoolNotFoundError(const std::string &name) : RedBaseError("Buffer pool not found: " + name) {}
+};
+
+class BufferPoolExistsError : public RedBaseError {
+   public:
+    BufferPoolExistsError(const std::string &name) : RedBaseError("Buffer pool already exists: " + name) {}
+};
+
 // RM errors
 class RecordNotFoundError : public RedBaseError {
    public:
@@ -105,6 +125,11 @@ class IndexExistsError : public RedBaseError {
         : RedBaseError("Index already exists: " + tab_name + '.' + col_name) {}
 };
 
+class UnknownVariableError : public RedBaseError {
+   public:
+    UnknownVariableError(const std::string &name) : RedBaseError("Unknown variable: " + name) {}
+};
+
 // QL errors
 class InvalidValueCountError : public RedBaseError {
    public:
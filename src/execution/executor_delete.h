@@ -11,6 +11,7 @@ class DeleteExecutor : public AbstractExecutor {
     std::vector<Condition> conds_;
     RmFileHandle *fh_;
     std::vector<Rid> rids_;
+    std::unique_ptr<BufferAccessStrategy> strategy_;  // 涉及的页面较多时读取记录使用的环
     std::string tab_name_;
     SmManager *sm_manager_;
 
@@ -24,6 +25,7 @@ class DeleteExecutor : public AbstractExecutor {
         conds_ = conds;
         rids_ = rids;
         context_ = context;
+        strategy_ = fh_->get_access_strategy(rids_);
     }
     std::unique_ptr<RmRecord> Next() override {
         // Get all index files
@@ -37,7 +39,7 @@ class DeleteExecutor : public AbstractExecutor {
         }
         // Delete each rid from record file and index file
         for (auto &rid : rids_) {
-            auto rec = fh_->get_record(rid, context_);
+            auto rec = fh_->get_record(rid, context_, strategy_.get());
             // 查询执行 task3 Todo
             // Delete from index file
             // Delete from record file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include "execution_defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -17,12 +19,18 @@ class SeqScanExecutor : public AbstractExecutor {
 
     Rid rid_;                        // 当前扫描到的记录的rid
     std::unique_ptr<RecScan> scan_;  // table_iterator
+    BufferAccessStrategy *strategy_ = nullptr;  // 扫描大表时 scan_ 使用的环，读取记录时也通过它读取
+
+    bool read_only_;                   // 只读查询可以通过内存映射直接读取已落盘的页面
+    std::unique_ptr<RmMmapView> view_;  // 只读扫描使用的内存映射视图，为 nullptr 时通过缓冲池读取
 
     SmManager *sm_manager_;
 
    public:
-    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context) {
+    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context,
+                    bool read_only = false) {
         sm_manager_ = sm_manager;
+        read_only_ = read_only;
         tab_name_ = std::move(tab_name);
         conds_ = std::move(conds);
         TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
@@ -55,13 +63,24 @@ class SeqScanExecutor : public AbstractExecutor {
     void beginTuple() override {
         check_runtime_conds();
 
-        scan_ = std::make_unique<RmScan>(fh_);
+        if (read_only_) {
+            // 只从映射中读取日志已经落盘的页面
+            lsn_t persistent_lsn = std::numeric_limits<lsn_t>::max();
+            if (context_ != nullptr && context_->log_mgr_ != nullptr) {
+                persistent_lsn = context_->log_mgr_->GetPersistentLsn();
+            }
+            scan_.reset();
+            view_ = fh_->open_read_only_view(persistent_lsn);
+        }
+        auto scan = std::make_unique<RmScan>(fh_, view_.get());
+        strategy_ = scan->get_strategy();
+        scan_ = std::move(scan);
 
         // 得到第一个满足fed_conds_条件的record,并把其rid赋给算子成员rid_
         while (!scan_->is_end()) {
             rid_ = scan_->rid();
             try {
-                auto rec = fh_->get_record(rid_, context_);  // TableHeap->GetTuple() 当前扫描到的记录
+                auto rec = get_record(rid_);  // TableHeap->GetTuple() 当前扫描到的记录
                 // 查询执行 task2 todo
                 // 利用eval_conds判断是否当前记录(rec.get())满足谓词条件
                 // 满足则中止循环
@@ -116,6 +135,16 @@ class SeqScanExecutor : public AbstractExecutor {
 
     Rid &rid() override { return rid_; }
 
+    /**
+     * @brief 读取当前扫描到的记录，只读扫描时优先从内存映射中读取
+     */
+    std::unique_ptr<RmRecord> get_record(const Rid &rid) {
+        if (view_ != nullptr) {
+            return view_->get_record(rid, context_);
+        }
+        return fh_->get_record(rid, context_, strategy_);
+    }
+
     void check_runtime_conds() {
         for (auto &cond : fed_conds_) {
             assert(cond.lhs_col.tab_name == tab_name_);
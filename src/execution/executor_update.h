@@ -11,6 +11,7 @@ class UpdateExecutor : public AbstractExecutor {
     std::vector<Condition> conds_;
     RmFileHandle *fh_;
     std::vector<Rid> rids_;
+    std::unique_ptr<BufferAccessStrategy> strategy_;  // 涉及的页面较多时读取记录使用的环
     std::string tab_name_;
     std::vector<SetClause> set_clauses_;
     SmManager *sm_manager_;
@@ -26,6 +27,7 @@ class UpdateExecutor : public AbstractExecutor {
         conds_ = conds;
         rids_ = rids;
         context_ = context;
+        strategy_ = fh_->get_access_strategy(rids_);
     }
     std::unique_ptr<RmRecord> Next() override {
         // Get all necessary index files
@@ -41,7 +43,7 @@ class UpdateExecutor : public AbstractExecutor {
         }
         // Update each rid from record file and index file
         for (auto &rid : rids_) {
-            auto rec = fh_->get_record(rid, context_);
+            auto rec = fh_->get_record(rid, context_, strategy_.get());
             // 查询执行 task3 Todo
             // Remove old entry from index
             // 查询执行 task3 Todo end
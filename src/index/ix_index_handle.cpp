@@ -6,8 +6,11 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
     : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
     // init file_hdr_
     disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
-    // disk_manager 管理的 fd 对应的文件中，设置从原来编号 +1 开始分配 page_no
-    disk_manager_->set_fd2pageno(fd, disk_manager_->get_fd2pageno(fd) + 1);
+    // 索引文件由 IxManager 创建了空闲页面表，disk_manager 在打开文件时已据此设置好分配的起始 page_no；
+    // 没有空闲页面表的旧索引文件，设置从原来编号 +1 开始分配 page_no
+    if (!disk_manager_->has_free_space_map(fd)) {
+        disk_manager_->set_fd2pageno(fd, disk_manager_->get_fd2pageno(fd) + 1);
+    }
 }
 
 /**
@@ -16,21 +19,18 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
  * @param key 要查找的目标 key 值
  * @param operation 查找到目标键值对后要进行的操作类型
  * @param transaction 事务参数，如果不需要则默认传入 nullptr
- * @return 返回目标叶子结点
- * @note need to Unpin the leaf node outside!
+ * @return 返回目标叶子结点，持有叶子结点的 pin，析构时自动 unpin
  */
-IxNodeHandle *IxIndexHandle::FindLeafPage(const char *key, Operation operation, Transaction *transaction) {
+IxNodeHandle IxIndexHandle::FindLeafPage(const char *key, Operation operation, Transaction *transaction) {
     // Todo:
     // 1. 获取根节点
     // 2. 从根节点开始不断向下查找目标 key
     // 3. 找到包含该 key 值的叶子结点停止查找，并返回叶子节点
-    IxNodeHandle *node = FetchNode(file_hdr_.root_page);
-    while (!node->IsLeafPage()) {
-        IxNodeHandle *parent = node;
-        int ret = node->InternalLookup(key);
-        node = FetchNode(ret);
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
-    } 
+    IxNodeHandle node = ReadNode(file_hdr_.root_page);
+    while (!node.IsLeafPage()) {
+        // 先 pin 住孩子结点，再在赋值时 unpin 父结点
+        node = ReadNode(node.InternalLookup(key));
+    }
     return node;
 }
 
@@ -49,14 +49,12 @@ bool IxIndexHandle::GetValue(const char *key, std::vector<Rid> *result, Transact
     // 3. 把 rid 存入 result 参数中
     // 提示：使用完 buffer_pool 提供的 page 之后，记得 unpin page；记得处理并发的上锁
     std::scoped_lock lock{root_latch_};
-    IxNodeHandle *node = FindLeafPage(key, Operation::FIND, nullptr);
+    IxNodeHandle node = FindLeafPage(key, Operation::FIND, nullptr);
     Rid *ret;
-    if (node->LeafLookup(key, &ret)) {
+    if (node.LeafLookup(key, &ret)) {
         result->push_back(*ret);
-        buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
         return true;
     }
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
     return false;
 }
 
@@ -74,25 +72,22 @@ bool IxIndexHandle::insert_entry(const char *key, const Rid &value, Transaction
     // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
     // 提示：记得 unpin page；若当前叶子节点是最右叶子节点，则需要更新 file_hdr_.last_leaf；记得处理并发的上锁
     std::scoped_lock lock{root_latch_};
-    IxNodeHandle *node = FindLeafPage(key, Operation::INSERT, transaction);
-    int old_size = node->GetSize();
+    IxNodeHandle node = FindLeafPage(key, Operation::INSERT, transaction);
+    int old_size = node.GetSize();
     //printf("before split node = %d node->size=%d node->minsize=%d node->maxsize=%d\n", node->GetPageNo(), node->GetSize(), node->GetMinSize(), node->GetMaxSize());
-    if (node->Insert(key, value) == old_size) {
+    if (node.Insert(key, value) == old_size) {
         //重复键值对，无法插入
-        assert(buffer_pool_manager_->UnpinPage(node->GetPageId(), false));
         return false;
     }
-    if (node->page_hdr->num_key == node->GetMaxSize()) {
-        IxNodeHandle *node2 = Split(node);
-        if (file_hdr_.last_leaf == node->GetPageNo()) {
-            file_hdr_.last_leaf = node2->GetPageNo();
+    node.guard.MarkDirty();
+    if (node.page_hdr->num_key == node.GetMaxSize()) {
+        IxNodeHandle node2 = Split(&node);
+        if (file_hdr_.last_leaf == node.GetPageNo()) {
+            file_hdr_.last_leaf = node2.GetPageNo();
         }
         //printf("after split node = %d node->size=%d node->minsize=%d node->maxsize=%d\n", node->GetPageNo(), node->GetSize(), node->GetMinSize(), node->GetMaxSize());
-        InsertIntoParent(node, node2->get_key(0), node2, transaction);
-        assert(buffer_pool_manager_->UnpinPage(node2->GetPageId(), true));
+        InsertIntoParent(&node, node2.get_key(0), &node2, transaction);
     }
-    
-    assert(buffer_pool_manager_->UnpinPage(node->GetPageId(), true));
     return true;
 }
 
@@ -100,10 +95,9 @@ bool IxIndexHandle::insert_entry(const char *key, const Rid &value, Transaction
  * @brief 将传入的一个 node 拆分 (Split) 成两个结点，在 node 的右边生成一个新结点 new node
  *
  * @param node 需要拆分的结点
- * @return 拆分得到的 new_node
- * @note 本函数执行完毕后，原 node 和 new node 都需要在函数外面进行 unpin
+ * @return 拆分得到的 new_node，持有新结点的 pin
  */
-IxNodeHandle *IxIndexHandle::Split(IxNodeHandle *node) {
+IxNodeHandle IxIndexHandle::Split(IxNodeHandle *node) {
     // Todo:
     // 1. 将原结点的键值对平均分配，右半部分分裂为新的右兄弟结点
     //    需要初始化新节点的 page_hdr 内容
@@ -111,26 +105,26 @@ IxNodeHandle *IxIndexHandle::Split(IxNodeHandle *node) {
     //    为新节点分配键值对，更新旧节点的键值对数记录
     // 3. 如果新的右兄弟结点不是叶子结点，更新该结点的所有孩子结点的父节点信息 (使用 IxIndexHandle::maintain_child())
     
-    IxNodeHandle *new_node = CreateNode(); 
-    new_node->page_hdr->is_leaf = node->page_hdr->is_leaf;
-    new_node->page_hdr->parent = node->page_hdr->parent; 
-    new_node->page_hdr->next_free_page_no = INVALID_PAGE_ID;
-    new_node->page_hdr->num_key = 0;
+    IxNodeHandle new_node = CreateNode(); 
+    new_node.page_hdr->is_leaf = node->page_hdr->is_leaf;
+    new_node.page_hdr->parent = node->page_hdr->parent; 
+    new_node.page_hdr->next_free_page_no = INVALID_PAGE_ID;
+    new_node.page_hdr->num_key = 0;
     int mid = (node->page_hdr->num_key - node->page_hdr->num_key / 2) - 1 , delta = node->page_hdr->num_key - mid - 1;  //[0, mid] 归左边 
-    new_node->insert_pairs(0, node->get_key(mid + 1), node->get_rid(mid + 1), delta);
+    new_node.insert_pairs(0, node->get_key(mid + 1), node->get_rid(mid + 1), delta);
     node->page_hdr->num_key = mid + 1;
+    node->guard.MarkDirty();
     
     if (node->IsLeafPage()) {
-        new_node->page_hdr->next_leaf = node->page_hdr->next_leaf;
-        node->page_hdr->next_leaf = new_node->GetPageNo();
-        new_node->page_hdr->prev_leaf = node->GetPageNo();
+        new_node.page_hdr->next_leaf = node->page_hdr->next_leaf;
+        node->page_hdr->next_leaf = new_node.GetPageNo();
+        new_node.page_hdr->prev_leaf = node->GetPageNo();
         // 还要更新下一个结点的 prev 结点
-        IxNodeHandle* nn_leaf = FetchNode(new_node->page_hdr->next_leaf);
-        nn_leaf->page_hdr->prev_leaf = new_node->GetPageNo();
-        assert(buffer_pool_manager_->UnpinPage(nn_leaf->GetPageId(), true));
+        IxNodeHandle nn_leaf = WriteNode(new_node.page_hdr->next_leaf);
+        nn_leaf.page_hdr->prev_leaf = new_node.GetPageNo();
     } else {
-        for (int i = 0; i < new_node->page_hdr->num_key; i++) {
-            maintain_child(new_node, i);
+        for (int i = 0; i < new_node.page_hdr->num_key; i++) {
+            maintain_child(&new_node, i);
         }
     }
     return new_node;
@@ -147,7 +141,7 @@ IxNodeHandle *IxIndexHandle::Split(IxNodeHandle *node) {
  * @param key 要插入 parent 的 key
  * @note 一个结点插入了键值对之后需要分裂，分裂后左半部分的键值对保留在原结点，在参数中称为 old_node，
  * 右半部分的键值对分裂为新的右兄弟节点，在参数中称为 new_node（参考 Split 函数来理解 old_node 和 new_node）
- * @note 本函数执行完毕后，new node 和 old node 都需要在函数外面进行 unpin
+ * @note old_node 和 new_node 由调用者持有，本函数执行完毕后由调用者 unpin
  */
 void IxIndexHandle::InsertIntoParent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node,
                                      Transaction *transaction) {
@@ -159,26 +153,23 @@ void IxIndexHandle::InsertIntoParent(IxNodeHandle *old_node, const char *key, Ix
     // 提示：记得 unpin page
     if (old_node->IsRootPage()) {
         //如果是根结点，需要新建一个根，作为原本根结点的祖先。
-        IxNodeHandle *new_root = CreateNode();
-        new_root->page_hdr->is_leaf = false;
-        new_root->page_hdr->num_key = 0;
-        new_root->page_hdr->parent = INVALID_PAGE_ID;
-        new_root->page_hdr->next_free_page_no = IX_NO_PAGE;
-        old_node->SetParentPageNo(new_root->GetPageNo());
-        new_node->SetParentPageNo(new_root->GetPageNo());
-        UpdateRootPageNo(new_root->GetPageNo());
-        new_root->insert_pair(0, old_node->get_key(0), (Rid){old_node->GetPageNo(), -1});
-        assert(buffer_pool_manager_->UnpinPage(new_root->GetPageId(), true));
+        IxNodeHandle new_root = CreateNode();
+        new_root.page_hdr->is_leaf = false;
+        new_root.page_hdr->num_key = 0;
+        new_root.page_hdr->parent = INVALID_PAGE_ID;
+        new_root.page_hdr->next_free_page_no = IX_NO_PAGE;
+        old_node->SetParentPageNo(new_root.GetPageNo());
+        new_node->SetParentPageNo(new_root.GetPageNo());
+        UpdateRootPageNo(new_root.GetPageNo());
+        new_root.insert_pair(0, old_node->get_key(0), (Rid){old_node->GetPageNo(), -1});
     }
-    IxNodeHandle *parent = FetchNode(old_node->GetParentPageNo());
-    int pos = parent->find_child(old_node);
-    parent->insert_pair(pos + 1, key, (Rid){new_node->GetPageNo(), -1});
-    if (parent->page_hdr->num_key == file_hdr_.btree_order) {
-        IxNodeHandle *p_newnode = Split(parent);
-        InsertIntoParent(parent, p_newnode->get_key(0), p_newnode, transaction);
-        assert(buffer_pool_manager_->UnpinPage(p_newnode->GetPageId(), true));
+    IxNodeHandle parent = WriteNode(old_node->GetParentPageNo());
+    int pos = parent.find_child(old_node);
+    parent.insert_pair(pos + 1, key, (Rid){new_node->GetPageNo(), -1});
+    if (parent.page_hdr->num_key == file_hdr_.btree_order) {
+        IxNodeHandle p_newnode = Split(&parent);
+        InsertIntoParent(&parent, p_newnode.get_key(0), &p_newnode, transaction);
     }
-    assert(buffer_pool_manager_->UnpinPage(parent->GetPageId(), true));
 }
 
 /**
@@ -195,13 +186,14 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
     // 3. 如果删除成功需要调用 CoalesceOrRedistribute 来进行合并或重分配操作，并根据函数返回结果判断是否有结点需要删除
     // 4. 如果需要并发，并且需要删除叶子结点，则需要在事务的 delete_page_set 中添加删除结点的对应页面；记得处理并发的上锁
     std::scoped_lock lock{root_latch_};
-    IxNodeHandle *leaf = FindLeafPage(key, Operation::DELETE, transaction);
-    int old_num_key = leaf->page_hdr->num_key;
-    int new_num = leaf->Remove(key);
+    IxNodeHandle leaf = FindLeafPage(key, Operation::DELETE, transaction);
+    int old_num_key = leaf.page_hdr->num_key;
+    int new_num = leaf.Remove(key);
     bool ret = (new_num != old_num_key);
-    if (ret) 
-        CoalesceOrRedistribute(leaf, transaction);
-    assert(buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true));
+    if (ret) {
+        leaf.guard.MarkDirty();
+        CoalesceOrRedistribute(&leaf, transaction);
+    }
     return ret;
 }
 
@@ -233,31 +225,29 @@ bool IxIndexHandle::CoalesceOrRedistribute(IxNodeHandle *node, Transaction *tran
             maintain_parent(node);
             return false;
         }
-        IxNodeHandle *parent = FetchNode(node->GetParentPageNo());
-        int sibling = parent->find_child(node);
+        IxNodeHandle parent = ReadNode(node->GetParentPageNo());
+        int sibling = parent.find_child(node);
         if (sibling > 0) {  //存在前驱
             sibling--;
         } else {
             sibling++;
-            if (sibling == parent->page_hdr->num_key && sibling == 1) {
+            if (sibling == parent.page_hdr->num_key && sibling == 1) {
                 //不存在前驱也不存在后继，不需要执行合并或重分配 ???
                 // 但这个点的 size 太小了啊，不应该存在
                 puts("不该出现此情况，当前结点是父节点的唯一孩子");
                 //IxNodeHandle *sibling_node = FetchNode(parent->get_rid(sibling)->page_no);
-                assert(buffer_pool_manager_->UnpinPage(parent->GetPageId(), false));
                 return false;
             }
         }
-        IxNodeHandle *sibling_node = FetchNode(parent->get_rid(sibling)->page_no);
-        if (node->page_hdr->num_key + sibling_node->page_hdr->num_key >= node->GetMinSize() * 2) {
-            Redistribute(sibling_node, node, parent, parent->find_child(node));
-            assert(buffer_pool_manager_->UnpinPage(sibling_node->GetPageId(), true));
-            assert(buffer_pool_manager_->UnpinPage(parent->GetPageId(), true));
+        // 重分配和合并都会修改父结点和兄弟结点
+        parent.guard.MarkDirty();
+        IxNodeHandle sibling_node = WriteNode(parent.get_rid(sibling)->page_no);
+        IxNodeHandle *neighbor = &sibling_node, *p = &parent;
+        if (node->page_hdr->num_key + sibling_node.page_hdr->num_key >= node->GetMinSize() * 2) {
+            Redistribute(neighbor, node, p, parent.find_child(node));
             return false;
         } else {
-            bool ret = Coalesce(&sibling_node, &node, &parent, parent->find_child(node), transaction);
-            assert(buffer_pool_manager_->UnpinPage(sibling_node->GetPageId(), true));
-            assert(buffer_pool_manager_->UnpinPage(parent->GetPageId(), true));
+            Coalesce(&neighbor, &node, &p, parent.find_child(node), transaction);
             return true;
         }
     }
@@ -277,10 +267,9 @@ bool IxIndexHandle::AdjustRoot(IxNodeHandle *old_root_node) {
     // 2. 如果 old_root_node 是叶结点，且大小为 0，则直接更新 root page
     // 3. 除了上述两种情况，不需要进行操作
     if ((!old_root_node->IsLeafPage()) && (old_root_node->GetSize() == 1)) {
-        IxNodeHandle *child = FetchNode(old_root_node->get_rid(0)->page_no);
-        UpdateRootPageNo(child->GetPageNo());
-        child->SetParentPageNo(INVALID_PAGE_ID);
-        assert(buffer_pool_manager_->UnpinPage(child->GetPageId(), false));
+        IxNodeHandle child = WriteNode(old_root_node->get_rid(0)->page_no);
+        UpdateRootPageNo(child.GetPageNo());
+        child.SetParentPageNo(INVALID_PAGE_ID);
         //assert(buffer_pool_manager_->DeletePage(old_root_node->GetPageId()));
         release_node_handle(*old_root_node);
         return true;
@@ -379,7 +368,7 @@ bool IxIndexHandle::Coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
  *
  * @param page_no
  * @return IxNodeHandle*
- * @note pin the page, remember to unpin it outside!
+ * @note pin the page, remember to unpin it outside! 只用于测试中检查树的结构，索引内部使用 ReadNode/WriteNode
  */
 IxNodeHandle *IxIndexHandle::FetchNode(int page_no) const {
     // assert(page_no < file_hdr_.num_pages); // 不再生效，由于删除操作，page_no 可以大于个数
@@ -388,24 +377,46 @@ IxNodeHandle *IxIndexHandle::FetchNode(int page_no) const {
     return node;
 }
 
+/**
+ * @brief 获取一个指定结点用于读取
+ *
+ * @param page_no
+ * @return IxNodeHandle 持有页面的 pin，析构时自动 unpin
+ * @note 只 pin 不加页面 latch：对树的修改由 root_latch_ 串行化，且同一结点可能在一次插入/删除中被重复获取
+ */
+IxNodeHandle IxIndexHandle::ReadNode(int page_no) const {
+    return IxNodeHandle(&file_hdr_, buffer_pool_manager_->FetchPageBasic(PageId{fd_, page_no}));
+}
+
+/**
+ * @brief 获取一个指定结点用于修改
+ *
+ * @param page_no
+ * @return IxNodeHandle 持有页面的 pin，析构时自动 unpin 并将页面置脏
+ */
+IxNodeHandle IxIndexHandle::WriteNode(int page_no) const {
+    IxNodeHandle node = ReadNode(page_no);
+    node.guard.MarkDirty();
+    return node;
+}
+
 /**
  * @brief 创建一个新结点
  *
- * @return IxNodeHandle*
- * @note pin the page, remember to unpin it outside!
- * 注意：对于 Index 的处理是，删除某个页面后，认为该被删除的页面是 free_page
+ * @return IxNodeHandle 持有新页面的 pin，析构时自动 unpin 并将页面置脏
+ * @note 注意：对于 Index 的处理是，删除某个页面后，认为该被删除的页面是 free_page
  * 而 first_free_page 实际上就是最新被删除的页面，初始为 IX_NO_PAGE
  * 在最开始插入时，一直是 create node，那么 first_page_no 一直没变，一直是 IX_NO_PAGE
  * 与 Record 的处理不同，Record 将未插入满的记录页认为是 free_page
  */
-IxNodeHandle *IxIndexHandle::CreateNode() {
+IxNodeHandle IxIndexHandle::CreateNode() {
     file_hdr_.num_pages++;
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
     // 从 3 开始分配 page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
-    Page *page = buffer_pool_manager_->NewPage(&new_page_id);
+    BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(&new_page_id);
+    guard.MarkDirty();
     // 注意，和 Record 的 free_page 定义不同，此处【不能】加上：file_hdr_.first_free_page_no = page->GetPageId().page_no
-    IxNodeHandle *node = new IxNodeHandle(&file_hdr_, page);
-    return node;
+    return IxNodeHandle(&file_hdr_, std::move(guard));
 }
 
 /**
@@ -414,22 +425,22 @@ IxNodeHandle *IxIndexHandle::CreateNode() {
  * @param node
  */
 void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
+    IxNodeHandle ancestor;  // 持有 curr 不是 node 时 curr 的 pin
     IxNodeHandle *curr = node;
     while (curr->GetParentPageNo() != IX_NO_PAGE) {
         // Load its parent
-        IxNodeHandle *parent = FetchNode(curr->GetParentPageNo());
-        int rank = parent->find_child(curr);
-        char *parent_key = parent->get_key(rank);
+        IxNodeHandle parent = ReadNode(curr->GetParentPageNo());
+        int rank = parent.find_child(curr);
+        char *parent_key = parent.get_key(rank);
         // char *child_max_key = curr.get_key(curr.page_hdr->num_key - 1);
         char *child_first_key = curr->get_key(0);
         if (memcmp(parent_key, child_first_key, file_hdr_.col_len) == 0) {
-            assert(buffer_pool_manager_->UnpinPage(parent->GetPageId(), true));
             break;
         }
         memcpy(parent_key, child_first_key, file_hdr_.col_len);  // 修改了 parent node
-        curr = parent;
-
-        assert(buffer_pool_manager_->UnpinPage(parent->GetPageId(), true));
+        parent.guard.MarkDirty();
+        ancestor = std::move(parent);
+        curr = &ancestor;
     }
 }
 
@@ -441,21 +452,25 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
 void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
     assert(leaf->IsLeafPage());
 
-    IxNodeHandle *prev = FetchNode(leaf->GetPrevLeaf());
-    prev->SetNextLeaf(leaf->GetNextLeaf());
-    buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+    {
+        IxNodeHandle prev = WriteNode(leaf->GetPrevLeaf());
+        prev.SetNextLeaf(leaf->GetNextLeaf());
+    }
 
-    IxNodeHandle *next = FetchNode(leaf->GetNextLeaf());
-    next->SetPrevLeaf(leaf->GetPrevLeaf());  // 注意此处是 SetPrevLeaf()
-    buffer_pool_manager_->UnpinPage(next->GetPageId(), true);
+    IxNodeHandle next = WriteNode(leaf->GetNextLeaf());
+    next.SetPrevLeaf(leaf->GetPrevLeaf());  // 注意此处是 SetPrevLeaf()
 }
 
 /**
- * @brief 删除 node 时，更新 file_hdr_.num_pages
+ * @brief 删除 node 时，更新 file_hdr_.num_pages，并将其页面归还给空闲页面表，供之后的 CreateNode 复用
  *
  * @param node
+ * @note node 此时可能仍被调用者 pin 住，所以只释放磁盘上的页面，由 NewPage 在复用时重新初始化其缓冲帧
  */
-void IxIndexHandle::release_node_handle(IxNodeHandle &node) { file_hdr_.num_pages--; }
+void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
+    file_hdr_.num_pages--;
+    disk_manager_->DeallocatePage(fd_, node.GetPageNo());
+}
 
 /**
  * @brief 将 node 的第 child_idx 个孩子结点的父节点置为 node
@@ -464,9 +479,8 @@ void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
     if (!node->IsLeafPage()) {
         //  Current node is inner node, load its child and set its parent to current node
         int child_page_no = node->ValueAt(child_idx);
-        IxNodeHandle *child = FetchNode(child_page_no);
-        child->SetParentPageNo(node->GetPageNo());
-        buffer_pool_manager_->UnpinPage(child->GetPageId(), true);
+        IxNodeHandle child = WriteNode(child_page_no);
+        child.SetParentPageNo(node->GetPageNo());
     }
 }
 
@@ -480,12 +494,11 @@ void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
  * @note iid 和 rid 存的不是一个东西，rid 是上层传过来的记录位置，iid 是索引内部生成的索引槽位置
  */
 Rid IxIndexHandle::get_rid(const Iid &iid) const {
-    IxNodeHandle *node = FetchNode(iid.page_no);
-    if (iid.slot_no >= node->GetSize()) {
+    IxNodeHandle node = ReadNode(iid.page_no);
+    if (iid.slot_no >= node.GetSize()) {
         throw IndexEntryNotFoundError();
     }
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);  // unpin it!
-    return *node->get_rid(iid.slot_no);
+    return *node.get_rid(iid.slot_no);
 }
 
 /** --以下函数将用于 lab3 执行层-- */
@@ -501,13 +514,10 @@ Iid IxIndexHandle::lower_bound(const char *key) {
     // int int_key = *(int *)key;
     // printf("my_lower_bound key=%d\n", int_key);
 
-    IxNodeHandle *node = FindLeafPage(key, Operation::FIND, nullptr);
-    int key_idx = node->lower_bound(key);
-
-    Iid iid = {.page_no = node->GetPageNo(), .slot_no = key_idx};
+    IxNodeHandle node = FindLeafPage(key, Operation::FIND, nullptr);
+    int key_idx = node.lower_bound(key);
 
-    // unpin leaf node
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
+    Iid iid = {.page_no = node.GetPageNo(), .slot_no = key_idx};
     return iid;
 }
 
@@ -521,19 +531,16 @@ Iid IxIndexHandle::upper_bound(const char *key) {
     // int int_key = *(int *)key;
     // printf("my_upper_bound key=%d\n", int_key);
 
-    IxNodeHandle *node = FindLeafPage(key, Operation::FIND, nullptr);
-    int key_idx = node->upper_bound(key);
+    IxNodeHandle node = FindLeafPage(key, Operation::FIND, nullptr);
+    int key_idx = node.upper_bound(key);
 
     Iid iid;
-    if (key_idx == node->GetSize()) {
+    if (key_idx == node.GetSize()) {
         // 这种情况无法根据 iid 找到 rid，即后续无法调用 ih->get_rid(iid)
         iid = leaf_end();
     } else {
-        iid = {.page_no = node->GetPageNo(), .slot_no = key_idx};
+        iid = {.page_no = node.GetPageNo(), .slot_no = key_idx};
     }
-
-    // unpin leaf node
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
     return iid;
 }
 
@@ -555,8 +562,7 @@ Iid IxIndexHandle::leaf_begin() const {
  * @return Iid
  */
 Iid IxIndexHandle::leaf_end() const {
-    IxNodeHandle *node = FetchNode(file_hdr_.last_leaf);
-    Iid iid = {.page_no = file_hdr_.last_leaf, .slot_no = node->GetSize()};
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);  // unpin it!
+    IxNodeHandle node = ReadNode(file_hdr_.last_leaf);
+    Iid iid = {.page_no = file_hdr_.last_leaf, .slot_no = node.GetSize()};
     return iid;
 }
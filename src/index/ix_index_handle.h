@@ -23,15 +23,17 @@ class IxIndexHandle {
    public:
     IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
 
+    int GetFd() const { return fd_; }
+
     // for search
     bool GetValue(const char *key, std::vector<Rid> *result, Transaction *transaction);
 
-    IxNodeHandle *FindLeafPage(const char *key, Operation operation, Transaction *transaction);
+    IxNodeHandle FindLeafPage(const char *key, Operation operation, Transaction *transaction);
 
     // for insert
     bool insert_entry(const char *key, const Rid &value, Transaction *transaction);
 
-    IxNodeHandle *Split(IxNodeHandle *node);
+    IxNodeHandle Split(IxNodeHandle *node);
 
     void InsertIntoParent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node, Transaction *transaction);
 
@@ -65,7 +67,11 @@ class IxIndexHandle {
     // for get/create node
     IxNodeHandle *FetchNode(int page_no) const;
 
-    IxNodeHandle *CreateNode();
+    IxNodeHandle ReadNode(int page_no) const;
+
+    IxNodeHandle WriteNode(int page_no) const;
+
+    IxNodeHandle CreateNode();
 
     // for maintain data structure
     void maintain_parent(IxNodeHandle *node);
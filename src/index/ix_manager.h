@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ix_defs.h"
 #include "ix_index_handle.h"
@@ -32,15 +33,17 @@ class IxManager {
         // Open index file
         int fd = disk_manager_->open_file(ix_name);
         // Create file header and write to file
-        // Theoretically we have: |page_hdr| + (|attr| + |rid|) * n <= PAGE_SIZE
+        // Theoretically we have: |page_hdr| + (|attr| + |rid|) * n <= page_size
         // but we reserve one slot for convenient inserting and deleting, i.e.
-        // |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE
+        // |page_hdr| + (|attr| + |rid|) * (n + 1) <= page_size
         if (col_len > IX_MAX_COL_LEN) {
             throw InvalidColLengthError(col_len);
         }
-        // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE 求得n的最大值btree_order
+        // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= page_size 求得n的最大值btree_order
         // 即 n <= btree_order，那么btree_order就是每个结点最多可插入的键值对数量（实际还多留了一个空位，但其不可插入）
-        int btree_order = static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr)) / (col_len + sizeof(Rid)) - 1);
+        // 页面大小由数据库决定，更大的页面有更大的扇出
+        int page_size = disk_manager_->get_page_size();
+        int btree_order = static_cast<int>((page_size - sizeof(IxPageHdr)) / (col_len + sizeof(Rid)) - 1);
         assert(btree_order > 2);
         // int key_offset = sizeof(IxPageHdr);
         // int rid_offset = key_offset + (btree_order + 1) * col_len;
@@ -61,11 +64,11 @@ class IxManager {
         };
         disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, (const char *)&fhdr, sizeof(fhdr));
 
-        char page_buf[PAGE_SIZE];  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
+        std::vector<char> page_buf(page_size);  // 在内存中初始化page_buf中的内容，然后将其写入磁盘
         // 注意leaf header页号为1，也标记为叶子结点，其前一个/后一个叶子均指向root node
         // Create leaf list header page and write to file
         {
-            auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
+            auto phdr = reinterpret_cast<IxPageHdr *>(page_buf.data());
             *phdr = {
                 .next_free_page_no = IX_NO_PAGE,
                 .parent = IX_NO_PAGE,
@@ -74,12 +77,12 @@ class IxManager {
                 .prev_leaf = IX_INIT_ROOT_PAGE,
                 .next_leaf = IX_INIT_ROOT_PAGE,
             };
-            disk_manager_->write_page(fd, IX_LEAF_HEADER_PAGE, page_buf, PAGE_SIZE);
+            disk_manager_->write_page(fd, IX_LEAF_HEADER_PAGE, page_buf.data(), page_size);
         }
         // 注意root node页号为2，也标记为叶子结点，其前一个/后一个叶子均指向leaf header
         // Create root node and write to file
         {
-            auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
+            auto phdr = reinterpret_cast<IxPageHdr *>(page_buf.data());
             *phdr = {
                 .next_free_page_no = IX_NO_PAGE,
                 .parent = IX_NO_PAGE,
@@ -88,11 +91,13 @@ class IxManager {
                 .prev_leaf = IX_LEAF_HEADER_PAGE,
                 .next_leaf = IX_LEAF_HEADER_PAGE,
             };
-            // Must write PAGE_SIZE here in case of future fetch_node()
-            disk_manager_->write_page(fd, IX_INIT_ROOT_PAGE, page_buf, PAGE_SIZE);
+            // Must write the whole page here in case of future fetch_node()
+            disk_manager_->write_page(fd, IX_INIT_ROOT_PAGE, page_buf.data(), page_size);
         }
 
-        disk_manager_->set_fd2pageno(fd, IX_INIT_NUM_PAGES - 1);  // DEBUG
+        // 在文件头页尾部创建空闲页面表，被删除结点的页面之后可以复用
+        static_assert(sizeof(IxFileHdr) <= FreeSpaceMap::PAGE_OFFSET, "index file header overlaps free space map");
+        disk_manager_->create_free_space_map(fd, IX_INIT_NUM_PAGES);
 
         // Close index file
         disk_manager_->close_file(fd);
@@ -114,6 +119,8 @@ class IxManager {
         disk_manager_->write_page(ih->fd_, IX_FILE_HDR_PAGE, (const char *)&ih->file_hdr_, sizeof(ih->file_hdr_));
         // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
         buffer_pool_manager_->FlushAllPages(ih->fd_);
+        // 之后打开的文件可能复用同一个 fd，不能把旧页面留在缓冲池中
+        buffer_pool_manager_->DiscardPages(ih->fd_);
         disk_manager_->close_file(ih->fd_);
     }
 };
@@ -44,6 +44,8 @@ class IxNodeHandle {
     char *keys;
     /** page->data的第三部分，指针指向首地址，每个rid的长度为sizeof(Rid) */
     Rid *rids;
+    /** 持有page的pin，结点析构时自动unpin；由FetchNode创建的结点为空，需要调用者自行unpin */
+    BasicPageGuard guard;
 
    public:
     IxNodeHandle(const IxFileHdr *file_hdr_, Page *page_) : file_hdr(file_hdr_), page(page_) {
@@ -52,6 +54,10 @@ class IxNodeHandle {
         rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size);
     }
 
+    IxNodeHandle(const IxFileHdr *file_hdr_, BasicPageGuard &&guard_) : IxNodeHandle(file_hdr_, guard_.GetPage()) {
+        guard = std::move(guard_);
+    }
+
     IxNodeHandle() = default;
 
     /**
@@ -5,15 +5,20 @@
  */
 void IxScan::next() {
     assert(!is_end());
-    IxNodeHandle *node = ih_->FetchNode(iid_.page_no);
-    assert(node->IsLeafPage());
-    assert(iid_.slot_no < node->GetSize());
+    IxNodeHandle node = ih_->ReadNode(iid_.page_no);
+    assert(node.IsLeafPage());
+    assert(iid_.slot_no < node.GetSize());
     // increment slot no
     iid_.slot_no++;
-    if (iid_.page_no != ih_->file_hdr_.last_leaf && iid_.slot_no == node->GetSize()) {
+    if (iid_.page_no != ih_->file_hdr_.last_leaf && iid_.slot_no == node.GetSize()) {
         // go to next leaf
         iid_.slot_no = 0;
-        iid_.page_no = node->GetNextLeaf();
+        iid_.page_no = node.GetNextLeaf();
+        page_id_t first;
+        int count = read_ahead_.OnAccess(iid_.page_no, ih_->file_hdr_.num_pages, &first);
+        if (count > 0) {
+            bpm_->PrefetchPages(ih_->fd_, first, count);
+        }
     }
 }
 
@@ -2,6 +2,7 @@
 
 #include "ix_defs.h"
 #include "ix_index_handle.h"
+#include "storage/read_ahead.h"
 
 /**
  * @brief 用于直接遍历叶子结点，而不用FindLeafPage()来得到叶子结点
@@ -11,6 +12,7 @@ class IxScan : public RecScan {
     Iid iid_;  // 初始为lower（用于遍历的指针）
     Iid end_;  // 初始为upper
     BufferPoolManager *bpm_;
+    ReadAheadWindow read_ahead_;  // 叶子结点按页面编号顺序相连时的预读窗口
 
    public:
     IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm)
@@ -12,14 +12,20 @@
 const char *help_info = "Supported SQL syntax:\n"
                    "  command ;\n"
                    "command:\n"
-                   "  CREATE TABLE table_name (column_name type [, column_name type ...])\n"
+                   "  CREATE TABLE table_name (column_name type [, column_name type ...]) [WITH buffer_pool_clause]\n"
                    "  DROP TABLE table_name\n"
-                   "  CREATE INDEX table_name (column_name)\n"
+                   "  CREATE INDEX table_name (column_name) [WITH buffer_pool_clause]\n"
                    "  DROP INDEX table_name (column_name)\n"
+                   "  ALTER TABLE table_name SET buffer_pool_clause\n"
+                   "  ALTER INDEX table_name (column_name) SET buffer_pool_clause\n"
                    "  INSERT INTO table_name VALUES (value [, value ...])\n"
                    "  DELETE FROM table_name [WHERE where_clause]\n"
                    "  UPDATE table_name SET column_name = value [, column_name = value ...] [WHERE where_clause]\n"
                    "  SELECT selector FROM table_name [WHERE where_clause]\n"
+                   "  SET [pool_name_]buffer_pool_size = value\n"
+                   "  SHOW BUFFER_POOLS\n"
+                   "buffer_pool_clause:\n"
+                   "  (buffer_pool = pool_name)\n"
                    "type:\n"
                    "  {INT | FLOAT | CHAR(n)}\n"
                    "where_clause:\n"
@@ -64,6 +70,12 @@ class Interp {
             sm_manager_->show_tables(context);
             if(context->txn_->GetTxnMode() == false)
                 txn_mgr_->Commit(context->txn_, context->log_mgr_);
+        } else if (auto x = std::dynamic_pointer_cast<ast::ShowBufferPools>(root)) {
+            // show buffer_pools;
+            sm_manager_->show_buffer_pools(context);
+        } else if (auto x = std::dynamic_pointer_cast<ast::SetVariable>(root)) {
+            // set variable = value;
+            sm_manager_->set_variable(x->var_name, x->val, context);
         } else if (auto x = std::dynamic_pointer_cast<ast::DescTable>(root)) {
             // desc table;
             SetTransaction(txn_id, context);
@@ -84,7 +96,7 @@ class Interp {
                 }
             }
             SetTransaction(txn_id, context);
-            sm_manager_->create_table(x->tab_name, col_defs, context);
+            sm_manager_->create_table(x->tab_name, col_defs, context, x->buffer_pool);
             if(context->txn_->GetTxnMode() == false)
                 txn_mgr_->Commit(context->txn_, context->log_mgr_);
         } else if (auto x = std::dynamic_pointer_cast<ast::DropTable>(root)) {
@@ -96,7 +108,7 @@ class Interp {
         } else if (auto x = std::dynamic_pointer_cast<ast::CreateIndex>(root)) {
             // create index;
             SetTransaction(txn_id, context);
-            sm_manager_->create_index(x->tab_name, x->col_name, context);
+            sm_manager_->create_index(x->tab_name, x->col_name, context, x->buffer_pool);
             if(context->txn_->GetTxnMode() == false)
                 txn_mgr_->Commit(context->txn_, context->log_mgr_);
         } else if (auto x = std::dynamic_pointer_cast<ast::DropIndex>(root)) {
@@ -105,6 +117,12 @@ class Interp {
             sm_manager_->drop_index(x->tab_name, x->col_name, context);
             if(context->txn_->GetTxnMode() == false)
                 txn_mgr_->Commit(context->txn_, context->log_mgr_);
+        } else if (auto x = std::dynamic_pointer_cast<ast::AlterTable>(root)) {
+            // alter table set (buffer_pool = name);
+            sm_manager_->set_table_buffer_pool(x->tab_name, x->buffer_pool, context);
+        } else if (auto x = std::dynamic_pointer_cast<ast::AlterIndex>(root)) {
+            // alter index set (buffer_pool = name);
+            sm_manager_->set_index_buffer_pool(x->tab_name, x->col_name, x->buffer_pool, context);
         } else if (auto x = std::dynamic_pointer_cast<ast::InsertStmt>(root)) {
             // insert;
             std::vector<Value> values;
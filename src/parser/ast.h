@@ -25,6 +25,16 @@ struct Help : public TreeNode {
 struct ShowTables : public TreeNode {
 };
 
+struct ShowBufferPools : public TreeNode {
+};
+
+struct SetVariable : public TreeNode {
+    std::string var_name;
+    int val;
+
+    SetVariable(std::string var_name_, int val_) : var_name(std::move(var_name_)), val(val_) {}
+};
+
 struct TxnBegin : public TreeNode {
 };
 
@@ -55,12 +65,14 @@ struct ColDef : public Field {
             col_name(std::move(col_name_)), type_len(std::move(type_len_)) {}
 };
 
+// buffer_pool 为空时使用默认缓冲池
 struct CreateTable : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Field>> fields;
+    std::string buffer_pool;
 
-    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_) :
-            tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_, std::string buffer_pool_ = "") :
+            tab_name(std::move(tab_name_)), fields(std::move(fields_)), buffer_pool(std::move(buffer_pool_)) {}
 };
 
 struct DropTable : public TreeNode {
@@ -78,9 +90,10 @@ struct DescTable : public TreeNode {
 struct CreateIndex : public TreeNode {
     std::string tab_name;
     std::string col_name;
+    std::string buffer_pool;
 
-    CreateIndex(std::string tab_name_, std::string col_name_) :
-            tab_name(std::move(tab_name_)), col_name(std::move(col_name_)) {}
+    CreateIndex(std::string tab_name_, std::string col_name_, std::string buffer_pool_ = "") :
+            tab_name(std::move(tab_name_)), col_name(std::move(col_name_)), buffer_pool(std::move(buffer_pool_)) {}
 };
 
 struct DropIndex : public TreeNode {
@@ -91,6 +104,25 @@ struct DropIndex : public TreeNode {
             tab_name(std::move(tab_name_)), col_name(std::move(col_name_)) {}
 };
 
+// 把已有的表移到另一个缓冲池
+struct AlterTable : public TreeNode {
+    std::string tab_name;
+    std::string buffer_pool;
+
+    AlterTable(std::string tab_name_, std::string buffer_pool_) :
+            tab_name(std::move(tab_name_)), buffer_pool(std::move(buffer_pool_)) {}
+};
+
+// 把已有的索引移到另一个缓冲池
+struct AlterIndex : public TreeNode {
+    std::string tab_name;
+    std::string col_name;
+    std::string buffer_pool;
+
+    AlterIndex(std::string tab_name_, std::string col_name_, std::string buffer_pool_) :
+            tab_name(std::move(tab_name_)), col_name(std::move(col_name_)), buffer_pool(std::move(buffer_pool_)) {}
+};
+
 struct Expr : public TreeNode {
 };
 
@@ -70,10 +70,17 @@ private:
             std::cout << "HELP\n";
         } else if (auto x = std::dynamic_pointer_cast<ShowTables>(node)) {
             std::cout << "SHOW_TABLES\n";
+        } else if (auto x = std::dynamic_pointer_cast<ShowBufferPools>(node)) {
+            std::cout << "SHOW_BUFFER_POOLS\n";
+        } else if (auto x = std::dynamic_pointer_cast<SetVariable>(node)) {
+            std::cout << "SET_VARIABLE\n";
+            print_val(x->var_name, offset);
+            print_val(x->val, offset);
         } else if (auto x = std::dynamic_pointer_cast<CreateTable>(node)) {
             std::cout << "CREATE_TABLE\n";
             print_val(x->tab_name, offset);
             print_node_list(x->fields, offset);
+            print_val(x->buffer_pool, offset);
         } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
             std::cout << "DROP_TABLE\n";
             print_val(x->tab_name, offset);
@@ -84,10 +91,20 @@ private:
             std::cout << "CREATE_INDEX\n";
             print_val(x->tab_name, offset);
             print_val(x->col_name, offset);
+            print_val(x->buffer_pool, offset);
         } else if (auto x = std::dynamic_pointer_cast<DropIndex>(node)) {
             std::cout << "DROP_INDEX\n";
             print_val(x->tab_name, offset);
             print_val(x->col_name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<AlterTable>(node)) {
+            std::cout << "ALTER_TABLE\n";
+            print_val(x->tab_name, offset);
+            print_val(x->buffer_pool, offset);
+        } else if (auto x = std::dynamic_pointer_cast<AlterIndex>(node)) {
+            std::cout << "ALTER_INDEX\n";
+            print_val(x->tab_name, offset);
+            print_val(x->col_name, offset);
+            print_val(x->buffer_pool, offset);
         } else if (auto x = std::dynamic_pointer_cast<ColDef>(node)) {
             std::cout << "COL_DEF\n";
             print_val(x->col_name, offset);
@@ -23,6 +23,7 @@ using namespace ast;
 // keywords
 %token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM
 WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK
+ALTER WITH BUFFER_POOL BUFFER_POOLS
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 
@@ -40,7 +41,7 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_CO
 %type <sv_expr> expr
 %type <sv_val> value
 %type <sv_vals> valueList
-%type <sv_str> tbName colName
+%type <sv_str> tbName colName bufferPool optWithBufferPool
 %type <sv_strs> tableList
 %type <sv_col> col
 %type <sv_cols> colList selector
@@ -104,12 +105,20 @@ dbStmt:
     {
         $$ = std::make_shared<ShowTables>();
     }
+    |   SHOW BUFFER_POOLS
+    {
+        $$ = std::make_shared<ShowBufferPools>();
+    }
+    |   SET IDENTIFIER '=' VALUE_INT
+    {
+        $$ = std::make_shared<SetVariable>($2, $4);
+    }
     ;
 
 ddl:
-        CREATE TABLE tbName '(' fieldList ')'
+        CREATE TABLE tbName '(' fieldList ')' optWithBufferPool
     {
-        $$ = std::make_shared<CreateTable>($3, $5);
+        $$ = std::make_shared<CreateTable>($3, $5, $7);
     }
     |   DROP TABLE tbName
     {
@@ -119,14 +128,37 @@ ddl:
     {
         $$ = std::make_shared<DescTable>($2);
     }
-    |   CREATE INDEX tbName '(' colName ')'
+    |   CREATE INDEX tbName '(' colName ')' optWithBufferPool
     {
-        $$ = std::make_shared<CreateIndex>($3, $5);
+        $$ = std::make_shared<CreateIndex>($3, $5, $7);
     }
     |   DROP INDEX tbName '(' colName ')'
     {
         $$ = std::make_shared<DropIndex>($3, $5);
     }
+    |   ALTER TABLE tbName SET bufferPool
+    {
+        $$ = std::make_shared<AlterTable>($3, $5);
+    }
+    |   ALTER INDEX tbName '(' colName ')' SET bufferPool
+    {
+        $$ = std::make_shared<AlterIndex>($3, $5, $8);
+    }
+    ;
+
+bufferPool:
+        '(' BUFFER_POOL '=' IDENTIFIER ')'
+    {
+        $$ = $4;
+    }
+    ;
+
+optWithBufferPool:
+        /* epsilon */ { $$ = ""; }
+    |   WITH bufferPool
+    {
+        $$ = $2;
+    }
     ;
 
 dml:
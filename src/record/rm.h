@@ -1,5 +1,6 @@
 #pragma once
 
 #include "rm_scan.h"
+#include "rm_mmap_view.h"
 #include "rm_manager.h"
 #include "rm_defs.h"
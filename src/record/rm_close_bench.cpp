@@ -0,0 +1,67 @@
+/**
+ * @brief 打开、写入、关闭大量表的微基准：关闭表时的整文件刷盘只访问该文件的页面，耗时与缓冲池大小无关
+ * @note 用法：rm_close_bench [num_tables] [records_per_table] [pool_size]
+ * 先创建 num_tables 个表，再计时：逐个打开表、插入 records_per_table 条记录、关闭表；之后再逐个打开、读取、关闭一遍
+ */
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "rm.h"
+
+static const std::string BENCH_DIR = "rm_close_bench_db";
+
+static std::string table_name(int i) { return BENCH_DIR + "/table_" + std::to_string(i); }
+
+int main(int argc, char **argv) {
+    int num_tables = argc > 1 ? std::stoi(argv[1]) : 1000;
+    int records_per_table = argc > 2 ? std::stoi(argv[2]) : 100;
+    size_t pool_size = argc > 3 ? std::stoul(argv[3]) : BUFFER_POOL_SIZE;
+    const int record_size = 64;
+
+    DiskManager disk_manager;
+    BufferPoolManager bpm(pool_size, &disk_manager, BUFFER_POOL_INSTANCES);
+    RmManager rm_manager(&disk_manager, &bpm);
+    if (disk_manager.is_dir(BENCH_DIR)) {
+        disk_manager.destroy_dir(BENCH_DIR);
+    }
+    disk_manager.create_dir(BENCH_DIR);
+    for (int i = 0; i < num_tables; i++) {
+        rm_manager.create_file(table_name(i), record_size);
+    }
+
+    std::vector<char> buf(record_size, 'x');
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_tables; i++) {
+        auto file_handle = rm_manager.open_file(table_name(i));
+        for (int j = 0; j < records_per_table; j++) {
+            file_handle->insert_record(buf.data(), nullptr);
+        }
+        rm_manager.close_file(file_handle.get());
+    }
+    std::chrono::duration<double, std::milli> write_elapsed = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    size_t num_records = 0;
+    for (int i = 0; i < num_tables; i++) {
+        auto file_handle = rm_manager.open_file(table_name(i));
+        for (RmScan scan(file_handle.get()); !scan.is_end(); scan.next()) {
+            num_records++;
+        }
+        rm_manager.close_file(file_handle.get());
+    }
+    std::chrono::duration<double, std::milli> read_elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("tables = %d, records per table = %d, pool size = %zu\n", num_tables, records_per_table, pool_size);
+    printf("%-32s %10.2f ms %10.2f us/table\n", "open + insert + close", write_elapsed.count(),
+           write_elapsed.count() * 1000 / num_tables);
+    printf("%-32s %10.2f ms %10.2f us/table\n", "open + scan + close", read_elapsed.count(),
+           read_elapsed.count() * 1000 / num_tables);
+    if (num_records != (size_t)num_tables * records_per_table) {
+        printf("unexpected number of records: %zu\n", num_records);
+    }
+
+    disk_manager.destroy_dir(BENCH_DIR);
+    return 0;
+}
@@ -1,18 +1,25 @@
 #include "rm_file_handle.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "rm_mmap_view.h"
+
 /**
  * @brief 由 Rid 得到指向 RmRecord 的指针
  *
  * @param rid 指定记录所在的位置
  * @return std::unique_ptr<RmRecord>
  */
-std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid &rid, Context *context) const {
+std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid &rid, Context *context,
+                                                   BufferAccessStrategy *strategy) const {
     // Todo:
     // 1. 获取指定记录所在的 page handle
     // 2. 初始化一个指向 RmRecord 的指针（赋值其内部的 data 和 size）
     //context 怎么用？
     std::unique_ptr<RmRecord> p = std::make_unique<RmRecord>(file_hdr_.record_size);
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    ReadPageGuard guard = fetch_page_read(rid.page_no, strategy);
+    RmPageHandle page_handle(&file_hdr_, guard.GetPage());
     if (!Bitmap::is_set(page_handle.bitmap, rid.slot_no)) {
         throw RecordNotFoundError(rid.page_no, rid.slot_no);
     }
@@ -35,7 +42,8 @@ Rid RmFileHandle::insert_record(char *buf, Context *context) {
     // 3. 将 buf 复制到空闲 slot 位置
     // 4. 更新 page_handle.page_hdr 中的数据结构
     // 注意考虑插入一条记录后页面已满的情况，需要更新 file_hdr_.first_free_page_no
-    RmPageHandle page_handle = create_page_handle();
+    WritePageGuard guard = create_page();
+    RmPageHandle page_handle(&file_hdr_, guard.AsMut());
     Rid ret;
     ret.slot_no = Bitmap::next_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page, -1);
     Bitmap::set(page_handle.bitmap, ret.slot_no);
@@ -56,15 +64,17 @@ Rid RmFileHandle::insert_record(char *buf, Context *context) {
  *
  * @param rid 要删除的记录所在的指定位置
  */
-void RmFileHandle::delete_record(const Rid &rid, Context *context) {
+void RmFileHandle::delete_record(const Rid &rid, Context *context, BufferAccessStrategy *strategy) {
     // Todo:
     // 1. 获取指定记录所在的 page handle
     // 2. 更新 page_handle.page_hdr 中的数据结构
     // 注意考虑删除一条记录后页面未满的情况，需要调用 release_page_handle()
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    WritePageGuard guard = fetch_page_write(rid.page_no, strategy);
+    RmPageHandle page_handle(&file_hdr_, guard.GetPage());
     if (!Bitmap::is_set(page_handle.bitmap, rid.slot_no)) {
         throw RecordNotFoundError(rid.page_no, rid.slot_no);
     }
+    guard.MarkDirty();
     //memset(page_handle.get_slot(rid.slot_no), 0, file_hdr_.record_size);
     Bitmap::reset(page_handle.bitmap, rid.slot_no);
     page_handle.page_hdr->num_records--;
@@ -79,77 +89,84 @@ void RmFileHandle::delete_record(const Rid &rid, Context *context) {
  * @param rid 指定位置的记录
  * @param buf 新记录的数据的地址
  */
-void RmFileHandle::update_record(const Rid &rid, char *buf, Context *context) {
+void RmFileHandle::update_record(const Rid &rid, char *buf, Context *context, BufferAccessStrategy *strategy) {
     // Todo:
     // 1. 获取指定记录所在的 page handle
     // 2. 更新记录
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    WritePageGuard guard = fetch_page_write(rid.page_no, strategy);
+    RmPageHandle page_handle(&file_hdr_, guard.GetPage());
     if (!Bitmap::is_set(page_handle.bitmap, rid.slot_no)) {
         throw RecordNotFoundError(rid.page_no, rid.slot_no);
     }
     char *slot = page_handle.get_slot(rid.slot_no);
     memcpy(slot, buf, file_hdr_.record_size);
+    guard.MarkDirty();
 }
 
 /** -- 以下为辅助函数 -- */
 /**
- * @brief 获取指定页面编号的 page handle
+ * @brief 读取指定页面编号的页面，加读 latch
  *
  * @param page_no 要获取的页面编号
- * @return RmPageHandle 返回给上层的 page_handle
- * @note pin the page, remember to unpin it outside!
+ * @param strategy 访问策略，为 nullptr 时使用缓冲池的替换策略
+ * @return ReadPageGuard 持有页面的 pin，析构时自动 unpin
  */
-RmPageHandle RmFileHandle::fetch_page_handle(int page_no) const {
-    // Todo:
-    // 使用缓冲池获取指定页面，并生成 page_handle 返回给上层
+ReadPageGuard RmFileHandle::fetch_page_read(int page_no, BufferAccessStrategy *strategy) const {
     // if page_no is invalid, throw PageNotExistError exception
     if (page_no == INVALID_PAGE_ID || page_no >= file_hdr_.num_pages) 
         throw PageNotExistError("不知道表名是什么", page_no);
-    PageId page_id = PageId();
-    page_id.fd = fd_;
-    page_id.page_no = page_no;
-    Page *page = buffer_pool_manager_->FetchPage(page_id);
-    return RmPageHandle(&file_hdr_, page);
+    return buffer_pool_manager_->FetchPageRead(PageId{fd_, page_no}, strategy);
+}
+
+/**
+ * @brief 获取指定页面编号的页面用于修改，加写 latch
+ *
+ * @param page_no 要获取的页面编号
+ * @param strategy 访问策略，为 nullptr 时使用缓冲池的替换策略
+ * @return WritePageGuard 持有页面的 pin，析构时自动 unpin，修改过的页面自动置脏
+ */
+WritePageGuard RmFileHandle::fetch_page_write(int page_no, BufferAccessStrategy *strategy) const {
+    if (page_no == INVALID_PAGE_ID || page_no >= file_hdr_.num_pages) 
+        throw PageNotExistError("不知道表名是什么", page_no);
+    return buffer_pool_manager_->FetchPageWrite(PageId{fd_, page_no}, strategy);
 }
 
 /**
- * @brief 创建一个新的 page handle
+ * @brief 创建一个新的页面，并初始化其 page_hdr 和 bitmap
  *
- * @return RmPageHandle
+ * @return WritePageGuard
  */
-RmPageHandle RmFileHandle::create_new_page_handle() {
+WritePageGuard RmFileHandle::create_new_page() {
     // Todo:
     // 1.使用缓冲池来创建一个新 page
     // 2.更新 page handle 中的相关信息
     // 3.更新 file_hdr
-    PageId *page_id = new PageId;
-    page_id->fd = fd_;
-    Page *page = buffer_pool_manager_->NewPage(page_id);
-    RmPageHandle page_handle = RmPageHandle(&file_hdr_, page);
+    PageId page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+    WritePageGuard guard = buffer_pool_manager_->NewPageGuarded(&page_id).UpgradeWrite();
+    RmPageHandle page_handle = RmPageHandle(&file_hdr_, guard.AsMut());
     page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
     page_handle.page_hdr->num_records = 0;
     Bitmap::init(page_handle.bitmap, file_hdr_.bitmap_size);
-    file_hdr_.first_free_page_no = page->GetPageId().page_no;
+    file_hdr_.first_free_page_no = page_id.page_no;
     file_hdr_.num_pages++;
-    return page_handle;
+    return guard;
 }
 
 /**
- * @brief 创建或获取一个空闲的 page handle
+ * @brief 创建或获取一个空闲的页面
  *
- * @return RmPageHandle 返回生成的空闲 page handle
- * @note pin the page, remember to unpin it outside!
+ * @return WritePageGuard 返回空闲页面
  */
-RmPageHandle RmFileHandle::create_page_handle() {
+WritePageGuard RmFileHandle::create_page() {
     // Todo:
     // 1. 判断 file_hdr_中是否还有空闲页
-    //     1.1 没有空闲页：使用缓冲池来创建一个新 page；可直接调用 create_new_page_handle()
+    //     1.1 没有空闲页：使用缓冲池来创建一个新 page；可直接调用 create_new_page()
     //     1.2 有空闲页：直接获取第一个空闲页
     // 2. 生成 page handle 并返回给上层
     if (file_hdr_.first_free_page_no != RM_NO_PAGE) {
-        return fetch_page_handle(file_hdr_.first_free_page_no);
+        return fetch_page_write(file_hdr_.first_free_page_no);
     } else {
-        return create_new_page_handle();
+        return create_new_page();
     }
 }
 
@@ -169,12 +186,36 @@ void RmFileHandle::release_page_handle(RmPageHandle &page_handle) {
     //}
 }
 
+std::unique_ptr<RmMmapView> RmFileHandle::open_read_only_view(lsn_t persistent_lsn) const {
+    // 缓冲池中的脏页（以及仍被 pin 住、可能正在被原地修改的页面）比磁盘上的内容新，此时不能绕过缓冲池；
+    // 压缩存储的文件中页面不在固定的偏移量上，也不能直接映射
+    if (disk_manager_->is_compressed(fd_) || buffer_pool_manager_->HasUnflushedPages(fd_)) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) == -1) {
+        throw UnixError();
+    }
+    int page_size = disk_manager_->get_page_size();
+    size_t length = st.st_size / page_size * page_size;
+    if (length == 0) {
+        return nullptr;
+    }
+    void *base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+    madvise(base, length, MADV_SEQUENTIAL);
+    return std::make_unique<RmMmapView>(this, static_cast<char *>(base), length, page_size, persistent_lsn);
+}
+
 // used for recovery (lab4)
 void RmFileHandle::insert_record(const Rid &rid, char *buf) {
     if (rid.page_no < file_hdr_.num_pages) {
-        create_new_page_handle();
+        create_new_page();
     }
-    RmPageHandle pageHandle = fetch_page_handle(rid.page_no);
+    WritePageGuard guard = fetch_page_write(rid.page_no);
+    RmPageHandle pageHandle(&file_hdr_, guard.AsMut());
     Bitmap::set(pageHandle.bitmap, rid.slot_no);
     pageHandle.page_hdr->num_records++;
     if (pageHandle.page_hdr->num_records == file_hdr_.num_records_per_page) {
@@ -183,6 +224,4 @@ void RmFileHandle::insert_record(const Rid &rid, char *buf) {
 
     char *slot = pageHandle.get_slot(rid.slot_no);
     memcpy(slot, buf, file_hdr_.record_size);
-
-    buffer_pool_manager_->UnpinPage(pageHandle.page->GetPageId(), true);
 }
\ No newline at end of file
@@ -9,8 +9,10 @@
 #include "rm_defs.h"
 
 class RmManager;
+class RmMmapView;
 
 // 对单个 page 进行封装，用 page 中的 data 存 RmPageHdr, bitmap, slots 的数据
+// 不持有 pin，page 由 fetch_page_read/fetch_page_write 返回的 page guard 持有
 struct RmPageHandle {
     const RmFileHdr *file_hdr;  // 用到了 file_hdr 的 bitmap_size, record_size
     Page *page;                 // 指向单个 page
@@ -34,6 +36,7 @@ struct RmPageHandle {
 class RmFileHandle {      // TableHeap
     friend class RmScan;  // TableIterator
     friend class RmManager;
+    friend class RmMmapView;
 
    private:
     DiskManager *disk_manager_;
@@ -64,26 +67,62 @@ class RmFileHandle {      // TableHeap
     int GetFd() { return fd_; }
 
     bool is_record(const Rid &rid) const {
-        RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+        ReadPageGuard guard = fetch_page_read(rid.page_no);
+        RmPageHandle page_handle(&file_hdr_, guard.GetPage());
         return Bitmap::is_set(page_handle.bitmap, rid.slot_no);  // page 的 slot_no 位置上是否有 record
     }
 
-    std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const;
+    /**
+     * @param strategy 访问策略，大扫描或批量读写时传入，见 get_access_strategy
+     */
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context,
+                                         BufferAccessStrategy *strategy = nullptr) const;
 
     Rid insert_record(char *buf, Context *context);
 
     void insert_record(const Rid &rid, char *buf);
 
-    void delete_record(const Rid &rid, Context *context);
+    void delete_record(const Rid &rid, Context *context, BufferAccessStrategy *strategy = nullptr);
 
-    void update_record(const Rid &rid, char *buf, Context *context);
+    void update_record(const Rid &rid, char *buf, Context *context, BufferAccessStrategy *strategy = nullptr);
 
-    RmPageHandle create_new_page_handle();
+    WritePageGuard create_new_page();
 
-    RmPageHandle fetch_page_handle(int page_no) const;
+    ReadPageGuard fetch_page_read(int page_no, BufferAccessStrategy *strategy = nullptr) const;
+
+    WritePageGuard fetch_page_write(int page_no, BufferAccessStrategy *strategy = nullptr) const;
+
+    /**
+     * @brief 为扫描整个文件创建缓冲区访问策略，文件不大时返回 nullptr
+     */
+    std::unique_ptr<BufferAccessStrategy> get_access_strategy() const {
+        return buffer_pool_manager_->GetAccessStrategy(fd_, file_hdr_.num_pages);
+    }
+
+    /**
+     * @brief 为批量读写 rids 中的记录创建缓冲区访问策略，涉及的页面不多时返回 nullptr
+     * @note rids 按扫描顺序排列，同一页面上的记录是连续的
+     */
+    std::unique_ptr<BufferAccessStrategy> get_access_strategy(const std::vector<Rid> &rids) const {
+        size_t num_pages = 0;
+        for (size_t i = 0; i < rids.size(); i++) {
+            if (i == 0 || rids[i].page_no != rids[i - 1].page_no) {
+                num_pages++;
+            }
+        }
+        return buffer_pool_manager_->GetAccessStrategy(fd_, num_pages);
+    }
+
+    /**
+     * @brief 为只读的顺序扫描创建文件的只读内存映射视图（madvise MADV_SEQUENTIAL）
+     *
+     * @param persistent_lsn 已持久化的日志的 LSN，页面 LSN 更大的页面不从映射中读取
+     * @return 缓冲池中该文件还有未刷盘的页面，或者映射失败时返回 nullptr，此时调用者应使用缓冲池读取
+     */
+    std::unique_ptr<RmMmapView> open_read_only_view(lsn_t persistent_lsn) const;
 
    private:
-    RmPageHandle create_page_handle();
+    WritePageGuard create_page();
 
     void release_page_handle(RmPageHandle &page_handle);
 };
@@ -20,6 +20,7 @@
 #include <cstring>
 #include <ctime>
 #include <iostream>
+#include <limits>
 #include <unordered_map>
 
 #include "gtest/gtest.h"
@@ -236,4 +237,69 @@ TEST(RecordManagerTest, MultipleFilesTest) {
         std::string filename = filenames[i];
         rm_manager->destroy_file(filename);
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief 只读扫描通过内存映射读取已落盘的记录文件
+ */
+TEST(RecordManagerTest, MmapScanTest) {
+    srand((unsigned)time(nullptr));
+
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+
+    std::string filename = "mmap_scan.txt";
+    int record_size = 4 + rand() % 256;
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+
+    std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> mock;
+    char write_buf[PAGE_SIZE];
+    for (int i = 0; i < 2000; i++) {
+        rand_buf(record_size, write_buf);
+        Rid rid = file_handle->insert_record(write_buf, nullptr);
+        mock[rid] = std::string((char *)write_buf, record_size);
+    }
+    // 文件仍有页面被 pin 在缓冲池中，不能绕过缓冲池
+    ASSERT_EQ(file_handle->open_read_only_view(INVALID_LSN), nullptr);
+    rm_manager->close_file(file_handle.get());
+
+    // 模拟重启：新的缓冲池中没有该文件的页面
+    buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+    rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+    file_handle = rm_manager->open_file(filename);
+
+    auto view = file_handle->open_read_only_view(std::numeric_limits<lsn_t>::max());
+    ASSERT_NE(view, nullptr);
+    ASSERT_EQ(view->get_num_pages(), file_handle->file_hdr_.num_pages);
+    size_t num_records = 0;
+    for (RmScan scan(file_handle.get(), view.get()); !scan.is_end(); scan.next()) {
+        ASSERT_GT(mock.count(scan.rid()), 0);
+        auto rec = view->get_record(scan.rid(), nullptr);
+        ASSERT_EQ(memcmp(rec->data, mock.at(scan.rid()).c_str(), record_size), 0);
+        num_records++;
+    }
+    ASSERT_EQ(num_records, mock.size());
+    // 整个扫描都没有经过缓冲池
+    ASSERT_FALSE(buffer_pool_manager->HasUnflushedPages(file_handle->fd_));
+
+    // 页面 LSN 大于已持久化的 LSN 时退回到缓冲池读取，结果不变
+    auto stale_view = file_handle->open_read_only_view(INVALID_LSN);
+    ASSERT_NE(stale_view, nullptr);
+    ASSERT_EQ(stale_view->get_page(RM_FIRST_RECORD_PAGE), nullptr);
+    num_records = 0;
+    for (RmScan scan(file_handle.get(), stale_view.get()); !scan.is_end(); scan.next()) {
+        auto rec = stale_view->get_record(scan.rid(), nullptr);
+        ASSERT_EQ(memcmp(rec->data, mock.at(scan.rid()).c_str(), record_size), 0);
+        num_records++;
+    }
+    ASSERT_EQ(num_records, mock.size());
+
+    view.reset();
+    stale_view.reset();
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
@@ -0,0 +1,53 @@
+#include "rm_mmap_view.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "rm_file_handle.h"
+
+RmMmapView::RmMmapView(const RmFileHandle *file_handle, char *base, size_t length, int page_size,
+                       lsn_t persistent_lsn)
+    : file_handle_(file_handle),
+      base_(base),
+      length_(length),
+      page_size_(page_size),
+      persistent_lsn_(persistent_lsn) {
+    // 文件尾部不完整的页面不读取
+    num_pages_ = std::min<size_t>(length_ / page_size_, file_handle_->file_hdr_.num_pages);
+}
+
+RmMmapView::~RmMmapView() { munmap(base_, length_); }
+
+const char *RmMmapView::get_page(int page_no) const {
+    if (page_no < RM_FIRST_RECORD_PAGE || page_no >= num_pages_) {
+        return nullptr;
+    }
+    const char *page = base_ + static_cast<size_t>(page_no) * page_size_;
+    lsn_t page_lsn;
+    memcpy(&page_lsn, page + Page::OFFSET_LSN, sizeof(lsn_t));
+    if (page_lsn > persistent_lsn_) {
+        return nullptr;
+    }
+    return page;
+}
+
+const char *RmMmapView::get_bitmap(const char *page) const {
+    return page + Page::OFFSET_PAGE_HDR + sizeof(RmPageHdr);
+}
+
+std::unique_ptr<RmRecord> RmMmapView::get_record(const Rid &rid, Context *context) const {
+    const char *page = get_page(rid.page_no);
+    if (page == nullptr) {
+        return file_handle_->get_record(rid, context);
+    }
+    const RmFileHdr &file_hdr = file_handle_->file_hdr_;
+    const char *bitmap = get_bitmap(page);
+    if (!Bitmap::is_set(bitmap, rid.slot_no)) {
+        throw RecordNotFoundError(rid.page_no, rid.slot_no);
+    }
+    auto record = std::make_unique<RmRecord>(file_hdr.record_size);
+    memcpy(record->data, bitmap + file_hdr.bitmap_size + rid.slot_no * file_hdr.record_size, file_hdr.record_size);
+    return record;
+}
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// rm_mmap_view.h
+//
+// Identification: src/record/rm_mmap_view.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "common/context.h"
+#include "rm_defs.h"
+
+class RmFileHandle;
+
+/**
+ * @brief 记录文件的只读内存映射视图，供只读查询的顺序扫描绕过缓冲池直接读取已落盘的页面
+ * @note 由 RmFileHandle::open_read_only_view 创建；视图只反映创建时磁盘上的内容，
+ * 页面 LSN 大于创建时已持久化的 LSN 的页面（对应的日志尚未落盘）不会从映射中读取，而是退回到缓冲池
+ */
+class RmMmapView {
+   public:
+    RmMmapView(const RmFileHandle *file_handle, char *base, size_t length, int page_size, lsn_t persistent_lsn);
+
+    ~RmMmapView();
+
+    DISALLOW_COPY(RmMmapView);
+
+    /** @return 映射覆盖的页面数（按映射时的文件大小截断） */
+    int get_num_pages() const { return num_pages_; }
+
+    /**
+     * @brief 获取映射中的页面
+     * @return 页面不在映射范围内，或其 LSN 大于已持久化的 LSN 时返回 nullptr，调用者应通过缓冲池读取
+     */
+    const char *get_page(int page_no) const;
+
+    /** @return 映射页面中的记录 bitmap，与 RmPageHandle::bitmap 的布局相同 */
+    const char *get_bitmap(const char *page) const;
+
+    /**
+     * @brief 读取一条记录，页面不能从映射中读取时退回到 RmFileHandle::get_record
+     */
+    std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context) const;
+
+   private:
+    const RmFileHandle *file_handle_;
+    char *base_;
+    size_t length_;
+    int page_size_;
+    int num_pages_;
+    lsn_t persistent_lsn_;
+};
@@ -1,13 +1,16 @@
 #include "rm_scan.h"
 
 #include "rm_file_handle.h"
+#include "rm_mmap_view.h"
 
 /**
  * @brief 初始化 file_handle 和 rid
  *
  * @param file_handle
+ * @note 文件的页数超过缓冲池的 1/4 时，通过缓冲池读取的页面只在一个私有的环中循环，见 BufferAccessStrategy
  */
-RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
+RmScan::RmScan(const RmFileHandle *file_handle, const RmMmapView *view)
+    : file_handle_(file_handle), view_(view), strategy_(file_handle->get_access_strategy()) {
     // Todo:
     // 初始化 file_handle 和 rid（指向第一个存放了记录的位置）
     rid_.page_no = RM_FIRST_RECORD_PAGE;
@@ -26,8 +29,23 @@ void RmScan::next() {
         return;
     }
     while (1) {
-        RmPageHandle page_handle = file_handle_->fetch_page_handle(rid_.page_no);
-        int nb = Bitmap::next_bit(true, page_handle.bitmap, file_handle_->file_hdr_.num_records_per_page, rid_.slot_no);
+        int nb;
+        const char *page = view_ != nullptr ? view_->get_page(rid_.page_no) : nullptr;
+        if (page != nullptr) {
+            nb = Bitmap::next_bit(true, view_->get_bitmap(page), file_handle_->file_hdr_.num_records_per_page,
+                                  rid_.slot_no);
+        } else {
+            page_id_t first;
+            int count = read_ahead_.OnAccess(rid_.page_no, file_handle_->file_hdr_.num_pages, &first);
+            if (count > 0) {
+                file_handle_->buffer_pool_manager_->PrefetchPages(file_handle_->fd_, first, count, strategy_.get());
+            }
+            // 扫描只读取 bitmap，guard 离开作用域时即 unpin
+            ReadPageGuard guard = file_handle_->fetch_page_read(rid_.page_no, strategy_.get());
+            RmPageHandle page_handle(&file_handle_->file_hdr_, guard.GetPage());
+            nb = Bitmap::next_bit(true, page_handle.bitmap, file_handle_->file_hdr_.num_records_per_page,
+                                  rid_.slot_no);
+        }
         if (nb >= file_handle_->file_hdr_.num_records_per_page) {
             rid_.page_no ++;
             rid_.slot_no = -1;
@@ -35,7 +53,6 @@ void RmScan::next() {
                 rid_.page_no = rid_.slot_no = RM_NO_PAGE;
                 return;
             }
-            page_handle = file_handle_->fetch_page_handle(rid_.page_no);
         } else {
             rid_.slot_no = nb;
             return;
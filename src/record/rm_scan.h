@@ -1,14 +1,27 @@
 #pragma once
 
+#include <memory>
+
 #include "rm_defs.h"
+#include "storage/buffer_access_strategy.h"
+#include "storage/read_ahead.h"
 
 class RmFileHandle;
+class RmMmapView;
 
 class RmScan : public RecScan {
     const RmFileHandle *file_handle_;
+    const RmMmapView *view_;  // 只读扫描时使用的内存映射视图，为 nullptr 时通过缓冲池读取
     Rid rid_;
+    ReadAheadWindow read_ahead_;  // 通过缓冲池读取时的预读窗口
+    std::unique_ptr<BufferAccessStrategy> strategy_;  // 大文件扫描时使用的环，为 nullptr 时使用缓冲池的替换策略
 public:
-    RmScan(const RmFileHandle *file_handle);
+    RmScan(const RmFileHandle *file_handle, const RmMmapView *view = nullptr);
+
+    /**
+     * @brief 扫描使用的缓冲区访问策略，读取扫描到的记录时应传给 RmFileHandle::get_record 等
+     */
+    BufferAccessStrategy *get_strategy() const { return strategy_.get(); }
 
     void next() override;
 
@@ -0,0 +1,184 @@
+#include "replacer/arc_replacer.h"
+
+#include <algorithm>
+
+ARCReplacer::ARCReplacer(size_t num_pages) : capacity_(num_pages), frames_(num_pages) {}
+
+/**
+ * @brief 优先从 T1 淘汰，除非 T1 没有超过目标大小 p_；选中的链表中没有可淘汰的帧时从另一个链表淘汰
+ * @note 被淘汰页面的 key 进入对应的幽灵链表
+ */
+bool ARCReplacer::Victim(frame_id_t *frame_id) {
+    std::scoped_lock lock{latch_};
+    if (t1_.empty() && t2_.empty()) {
+        return false;
+    }
+    bool from_t1 = t1_size_ > 0 && t1_size_ > p_;
+    if ((from_t1 && t1_.empty()) || (!from_t1 && t2_.empty())) {
+        from_t1 = !from_t1;
+    }
+    std::list<frame_id_t> &list = from_t1 ? t1_ : t2_;
+    *frame_id = list.back();
+    FrameState &state = frames_[*frame_id];
+    Detach(*frame_id);
+    state.evictable = false;
+    if (state.has_key) {
+        std::list<uint64_t> &ghost = from_t1 ? b1_ : b2_;
+        ghost.push_front(state.page_key);
+        ghosts_[state.page_key] = Ghost{from_t1 ? ListType::B1 : ListType::B2, ghost.begin()};
+        state.has_key = false;
+        TrimGhosts();
+    }
+    return true;
+}
+
+void ARCReplacer::Pin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    FrameState &state = frames_[frame_id];
+    if (!state.evictable) {
+        return;
+    }
+    state.evictable = false;
+    if (state.list != ListType::NONE) {
+        Resident(state.list).erase(state.pos);
+    }
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    FrameState &state = frames_[frame_id];
+    if (state.evictable) {
+        return;
+    }
+    state.evictable = true;
+    if (state.list == ListType::NONE) {
+        // 没有经过 RecordLoad 的帧（如预读完成的页面）按只访问过一次处理
+        Attach(frame_id, ListType::T1);
+        return;
+    }
+    std::list<frame_id_t> &list = Resident(state.list);
+    list.push_front(frame_id);
+    state.pos = list.begin();
+}
+
+/**
+ * @brief 驻留页面再次被访问，移入 T2
+ */
+void ARCReplacer::RecordAccess(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    FrameState &state = frames_[frame_id];
+    if (state.list == ListType::NONE) {
+        Attach(frame_id, ListType::T1);
+        return;
+    }
+    Detach(frame_id);
+    Attach(frame_id, ListType::T2);
+}
+
+/**
+ * @brief 页面换入帧中：命中幽灵链表时调整 p_ 并移入 T2，否则进入 T1
+ */
+void ARCReplacer::RecordLoad(frame_id_t frame_id, uint64_t page_key) {
+    std::scoped_lock lock{latch_};
+    FrameState &state = frames_[frame_id];
+    if (state.list != ListType::NONE) {
+        Detach(frame_id);
+    }
+    state.has_key = true;
+    state.page_key = page_key;
+    auto it = ghosts_.find(page_key);
+    if (it == ghosts_.end()) {
+        Attach(frame_id, ListType::T1);
+        TrimGhosts();
+        return;
+    }
+    if (it->second.list == ListType::B1) {
+        size_t delta = std::max<size_t>(1, b2_.size() / b1_.size());
+        p_ = std::min(capacity_, p_ + delta);
+        b1_.erase(it->second.pos);
+    } else {
+        size_t delta = std::max<size_t>(1, b1_.size() / b2_.size());
+        p_ = p_ > delta ? p_ - delta : 0;
+        b2_.erase(it->second.pos);
+    }
+    ghosts_.erase(it);
+    Attach(frame_id, ListType::T2);
+}
+
+/**
+ * @brief 帧上的页面被删除：移出 replacer，不进入幽灵链表
+ */
+void ARCReplacer::Remove(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    FrameState &state = frames_[frame_id];
+    if (state.list != ListType::NONE) {
+        Detach(frame_id);
+    }
+    state.evictable = false;
+    state.has_key = false;
+}
+
+/**
+ * @brief 按 Victim 的规则交替从 T1、T2 的 LRU 端列出帧，期间 p_ 不变，只有 T1 的大小随之减小
+ */
+void ARCReplacer::PeekVictims(size_t n, std::vector<frame_id_t> *frames) {
+    std::scoped_lock lock{latch_};
+    auto t1 = t1_.rbegin();
+    auto t2 = t2_.rbegin();
+    size_t t1_size = t1_size_;
+    for (; n > 0 && (t1 != t1_.rend() || t2 != t2_.rend()); n--) {
+        bool from_t1 = t1_size > 0 && t1_size > p_;
+        if ((from_t1 && t1 == t1_.rend()) || (!from_t1 && t2 == t2_.rend())) {
+            from_t1 = !from_t1;
+        }
+        if (from_t1) {
+            frames->push_back(*t1++);
+            t1_size--;
+        } else {
+            frames->push_back(*t2++);
+        }
+    }
+}
+
+size_t ARCReplacer::Size() {
+    std::scoped_lock lock{latch_};
+    return t1_.size() + t2_.size();
+}
+
+void ARCReplacer::Attach(frame_id_t frame_id, ListType list) {
+    FrameState &state = frames_[frame_id];
+    state.list = list;
+    (list == ListType::T1 ? t1_size_ : t2_size_)++;
+    if (state.evictable) {
+        std::list<frame_id_t> &resident = Resident(list);
+        resident.push_front(frame_id);
+        state.pos = resident.begin();
+    }
+}
+
+void ARCReplacer::Detach(frame_id_t frame_id) {
+    FrameState &state = frames_[frame_id];
+    if (state.evictable) {
+        Resident(state.list).erase(state.pos);
+    }
+    (state.list == ListType::T1 ? t1_size_ : t2_size_)--;
+    state.list = ListType::NONE;
+}
+
+void ARCReplacer::SetCapacity(size_t num_pages) {
+    std::scoped_lock lock{latch_};
+    capacity_ = num_pages;
+    p_ = std::min(p_, capacity_);
+    TrimGhosts();
+}
+
+void ARCReplacer::TrimGhosts() {
+    while (!b1_.empty() && t1_size_ + b1_.size() > capacity_) {
+        ghosts_.erase(b1_.back());
+        b1_.pop_back();
+    }
+    while (!b2_.empty() && t1_size_ + t2_size_ + b1_.size() + b2_.size() > 2 * capacity_) {
+        ghosts_.erase(b2_.back());
+        b2_.pop_back();
+    }
+}
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// arc_replacer.h
+//
+// Identification: src/replacer/arc_replacer.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo & Modha, FAST '03).
+ *
+ * 驻留的页面分在两个 LRU 链表中：T1 是只被访问过一次的页面（近期性），T2 是被访问过至少两次的页面（频率）；
+ * 被淘汰的页面的 key 记入对应的幽灵链表 B1/B2。换入的页面命中 B1 说明 T1 太小，命中 B2 说明 T2 太小，
+ * 据此自适应地调整 T1 的目标大小 p_：扫描为主时 T1 变大，点查询为主时 T2 变大。
+ * 所有操作都是 O(1) 的，幽灵链表与驻留页面合计不超过 2 * capacity_ 个。
+ * @note 只有通过 RecordLoad 换入的页面才有 key；T1/T2 中只链入可淘汰的帧，被 pin 住的帧只计入 t1_size_/t2_size_
+ */
+class ARCReplacer : public Replacer {
+   public:
+    /**
+     * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+     */
+    explicit ARCReplacer(size_t num_pages);
+
+    ~ARCReplacer() override = default;
+
+    bool Victim(frame_id_t *frame_id) override;
+
+    void Pin(frame_id_t frame_id) override;
+
+    void Unpin(frame_id_t frame_id) override;
+
+    void PeekVictims(size_t n, std::vector<frame_id_t> *frames) override;
+
+    void RecordAccess(frame_id_t frame_id) override;
+
+    void RecordLoad(frame_id_t frame_id, uint64_t page_key) override;
+
+    void Remove(frame_id_t frame_id) override;
+
+    size_t Size() override;
+
+    /** 缩小时 p_ 和幽灵链表随之收缩 */
+    void SetCapacity(size_t num_pages) override;
+
+    /** @return T1 的目标大小 */
+    size_t GetTarget() {
+        std::scoped_lock lock{latch_};
+        return p_;
+    }
+
+   private:
+    enum class ListType { NONE, T1, T2, B1, B2 };
+
+    struct FrameState {
+        ListType list = ListType::NONE;
+        bool evictable = false;
+        bool has_key = false;
+        uint64_t page_key = 0;
+        std::list<frame_id_t>::iterator pos;  // evictable 时在 T1/T2 中的位置
+    };
+
+    struct Ghost {
+        ListType list;
+        std::list<uint64_t>::iterator pos;
+    };
+
+    /** 把帧挂到 T1/T2 的 MRU 端 */
+    void Attach(frame_id_t frame_id, ListType list);
+
+    /** 把帧从 T1/T2 中摘下 */
+    void Detach(frame_id_t frame_id);
+
+    /** 淘汰幽灵链表 LRU 端的 key，使幽灵链表与驻留页面合计不超过 2 * capacity_，T1 与 B1 合计不超过 capacity_ */
+    void TrimGhosts();
+
+    std::list<frame_id_t> &Resident(ListType list) { return list == ListType::T1 ? t1_ : t2_; }
+
+    std::mutex latch_;
+    size_t capacity_;
+    /** T1 的目标大小，0 <= p_ <= capacity_ */
+    size_t p_ = 0;
+    std::vector<FrameState> frames_;
+    /** 可淘汰的帧，首部为 MRU */
+    std::list<frame_id_t> t1_;
+    std::list<frame_id_t> t2_;
+    /** T1/T2 中的驻留帧数，包括被 pin 住的帧 */
+    size_t t1_size_ = 0;
+    size_t t2_size_ = 0;
+    /** 幽灵链表，首部为 MRU */
+    std::list<uint64_t> b1_;
+    std::list<uint64_t> b2_;
+    std::unordered_map<uint64_t, Ghost> ghosts_;
+};
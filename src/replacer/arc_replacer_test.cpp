@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// arc_replacer_test.cpp
+//
+// Identification: src/replacer/arc_replacer_test.cpp
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "replacer/arc_replacer.h"
+#undef private
+#include "replacer/clock_replacer.h"
+#include "replacer/lru_replacer.h"
+#include "replacer/replacer_trace.h"
+
+/**
+ * @brief 只访问过一次的页面（T1）先于访问过多次的页面（T2）淘汰，命中幽灵链表时调整 T1 的目标大小
+ */
+TEST(ARCReplacerTest, SimpleTest) {
+    ARCReplacer replacer(4);
+
+    // 页面 100~103 换入帧 0~3，帧 0 再访问一次进入 T2
+    for (frame_id_t i = 0; i < 4; i++) {
+        replacer.RecordLoad(i, 100 + i);
+    }
+    replacer.RecordAccess(0);
+    for (frame_id_t i = 0; i < 4; i++) {
+        replacer.Unpin(i);
+    }
+    EXPECT_EQ(4, replacer.Size());
+
+    // p = 0，先淘汰 T1 中的 LRU 帧
+    frame_id_t frame_id;
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(1, frame_id);
+
+    // pin 住的帧不会被淘汰
+    replacer.Pin(2);
+    EXPECT_EQ(2, replacer.Size());
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(3, frame_id);
+
+    // 被淘汰的页面 101 再次换入：命中 B1，T1 的目标大小变大，页面直接进入 T2
+    replacer.RecordLoad(1, 101);
+    EXPECT_EQ(1, replacer.GetTarget());
+    replacer.Unpin(1);
+    replacer.Unpin(2);
+
+    // T1 中只剩帧 2，未超过目标大小，从 T2 淘汰 LRU 的帧 0
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(0, frame_id);
+
+    // 页面 100 命中 B2，T1 的目标大小变小
+    replacer.RecordLoad(0, 100);
+    EXPECT_EQ(0, replacer.GetTarget());
+
+    // Remove 的帧不进入幽灵链表
+    replacer.Remove(2);
+    EXPECT_EQ(1, replacer.Size());
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(1, frame_id);
+    EXPECT_FALSE(replacer.Victim(&frame_id));
+}
+
+/**
+ * @brief 幽灵链表与驻留页面合计不超过 2 倍容量
+ */
+TEST(ARCReplacerTest, BoundedGhostsTest) {
+    const size_t num_frames = 16;
+    ARCReplacer replacer(num_frames);
+    auto trace = ReplacerTrace::Zipf(10000, 50000, 0.5);
+    ReplacerTrace::HitRatio(&replacer, num_frames, trace);
+    EXPECT_LE(replacer.ghosts_.size(), 2 * num_frames);
+    EXPECT_LE(replacer.b1_.size() + replacer.t1_size_, num_frames);
+    EXPECT_EQ(replacer.ghosts_.size(), replacer.b1_.size() + replacer.b2_.size());
+}
+
+/**
+ * @brief 为扩容预留了帧时，目标大小和幽灵链表按 SetCapacity 设置的使用中帧数约束
+ */
+TEST(ARCReplacerTest, SetCapacityTest) {
+    const size_t num_frames = 16;
+    ARCReplacer replacer(4 * num_frames);
+    replacer.SetCapacity(num_frames);
+    auto trace = ReplacerTrace::Zipf(10000, 50000, 0.5);
+    ReplacerTrace::HitRatio(&replacer, num_frames, trace);
+    EXPECT_LE(replacer.GetTarget(), num_frames);
+    EXPECT_LE(replacer.ghosts_.size(), 2 * num_frames);
+    EXPECT_LE(replacer.b1_.size() + replacer.t1_size_, num_frames);
+}
+
+/**
+ * @brief 访问序列驱动的命中率测试：热点页面不会被扫描挤出，循环访问时也能命中一部分
+ */
+TEST(ARCReplacerTest, HitRatioTest) {
+    const size_t num_frames = 256;
+
+    auto scans = ReplacerTrace::HotSetWithScans(200, 1000, 20, 5000);
+    LRUReplacer lru(num_frames);
+    ARCReplacer arc(num_frames);
+    EXPECT_GT(ReplacerTrace::HitRatio(&arc, num_frames, scans), ReplacerTrace::HitRatio(&lru, num_frames, scans) + 0.02);
+
+    auto zipf = ReplacerTrace::Zipf(2048, 100000, 0.9);
+    LRUReplacer lru2(num_frames);
+    ARCReplacer arc2(num_frames);
+    EXPECT_GE(ReplacerTrace::HitRatio(&arc2, num_frames, zipf), ReplacerTrace::HitRatio(&lru2, num_frames, zipf));
+}
+
+/**
+ * @brief 多线程并发访问
+ */
+TEST(ARCReplacerTest, ConcurrencyTest) {
+    const int num_threads = 4;
+    const int num_frames = 1000;
+    ARCReplacer replacer(num_frames * num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < num_frames; i++) {
+                frame_id_t frame_id = t * num_frames + i;
+                replacer.RecordLoad(frame_id, frame_id);
+                replacer.Unpin(frame_id);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(replacer.Size(), num_frames * num_threads);
+}
@@ -15,18 +15,64 @@ bool ClockReplacer::Victim(frame_id_t *frame_id) {
     // Todo: try to find a victim frame in buffer pool with clock scheme
     // and make the *frame_id = victim_frame_id
     // not found, frame_id=nullptr and return false
-
-    return false;
+    if (size_ == 0) {
+        return false;
+    }
+    // 最多转两圈：第一圈清除访问位，第二圈一定能找到 UNTOUCHED 的帧
+    while (true) {
+        Status &status = circular_[hand_];
+        if (status == Status::UNTOUCHED) {
+            *frame_id = hand_;
+            status = Status::EMPTY_OR_PINNED;
+            size_--;
+            hand_ = (hand_ + 1) % capacity_;
+            return true;
+        }
+        if (status == Status::ACCESSED) {
+            status = Status::UNTOUCHED;
+        }
+        hand_ = (hand_ + 1) % capacity_;
+    }
 }
 
 void ClockReplacer::Pin(frame_id_t frame_id) {
     const std::lock_guard<mutex_t> guard(mutex_);
     // Todo: you can implement it!
+    if (circular_[frame_id] != Status::EMPTY_OR_PINNED) {
+        circular_[frame_id] = Status::EMPTY_OR_PINNED;
+        size_--;
+    }
 }
 
 void ClockReplacer::Unpin(frame_id_t frame_id) {
     const std::lock_guard<mutex_t> guard(mutex_);
     // Todo: you can implement it!
+    if (circular_[frame_id] == Status::EMPTY_OR_PINNED) {
+        circular_[frame_id] = Status::ACCESSED;
+        size_++;
+    }
+}
+
+void ClockReplacer::SetCapacity(size_t num_pages) {
+    const std::lock_guard<mutex_t> guard(mutex_);
+    capacity_ = num_pages;
+    hand_ %= capacity_;
+}
+
+/**
+ * @brief 模拟时钟指针转动：先是从 hand_ 起的 UNTOUCHED 帧，转完一圈后访问位都已清除，再是 ACCESSED 帧
+ */
+void ClockReplacer::PeekVictims(size_t n, std::vector<frame_id_t> *frames) {
+    const std::lock_guard<mutex_t> guard(mutex_);
+    for (Status status : {Status::UNTOUCHED, Status::ACCESSED}) {
+        for (size_t i = 0; i < capacity_ && n > 0; i++) {
+            frame_id_t frame_id = (hand_ + i) % capacity_;
+            if (circular_[frame_id] == status) {
+                frames->push_back(frame_id);
+                n--;
+            }
+        }
+    }
 }
 
 size_t ClockReplacer::Size() {
@@ -35,5 +81,6 @@ size_t ClockReplacer::Size() {
     // return all items that in the range[circular_.begin, circular_.end )
     // and be met the condition: status!=EMPTY_OR_PINNED
     // That is the number of frames in the buffer pool that storage page (NOT EMPTY_OR_PINNED)
-    return -1;
+    const std::lock_guard<mutex_t> guard(mutex_);
+    return size_;
 }
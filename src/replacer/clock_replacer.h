@@ -47,11 +47,17 @@ class ClockReplacer : public Replacer {
 
     void Unpin(frame_id_t frame_id) override;
 
+    void PeekVictims(size_t n, std::vector<frame_id_t> *frames) override;
+
     size_t Size() override;
 
+    /** 时钟指针只在前 num_pages 个帧上转动 */
+    void SetCapacity(size_t num_pages) override;
+
    private:
     std::vector<Status> circular_;
     frame_id_t hand_{0};  // initial hand_ value = 0, the scan starter
     size_t capacity_;
+    size_t size_{0};  // 不是 EMPTY_OR_PINNED 的帧数
     mutex_t mutex_;
 };
\ No newline at end of file
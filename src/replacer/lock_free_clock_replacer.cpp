@@ -0,0 +1,69 @@
+#include "replacer/lock_free_clock_replacer.h"
+
+LockFreeClockReplacer::LockFreeClockReplacer(size_t num_pages)
+    : capacity_(num_pages), states_(new std::atomic<uint8_t>[num_pages]) {
+    for (size_t i = 0; i < num_pages; i++) {
+        states_[i].store(EMPTY_OR_PINNED, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief 推进时钟指针直到取走一个 UNTOUCHED 的帧，途中把 ACCESSED 的帧降为 UNTOUCHED
+ * @note 每个位置只做一次 CAS，失败说明该帧刚被其他线程 pin 住或取走，直接跳过
+ */
+bool LockFreeClockReplacer::Victim(frame_id_t *frame_id) {
+    while (size_.load(std::memory_order_acquire) > 0) {
+        frame_id_t frame = static_cast<frame_id_t>(hand_.fetch_add(1, std::memory_order_relaxed) % capacity_.load(std::memory_order_relaxed));
+        uint8_t status = states_[frame].load(std::memory_order_acquire);
+        if (status == UNTOUCHED) {
+            if (states_[frame].compare_exchange_strong(status, EMPTY_OR_PINNED, std::memory_order_acq_rel)) {
+                size_.fetch_sub(1, std::memory_order_acq_rel);
+                *frame_id = frame;
+                return true;
+            }
+        } else if (status == ACCESSED) {
+            states_[frame].compare_exchange_strong(status, UNTOUCHED, std::memory_order_acq_rel);
+        }
+    }
+    return false;
+}
+
+void LockFreeClockReplacer::Pin(frame_id_t frame_id) {
+    if (states_[frame_id].exchange(EMPTY_OR_PINNED, std::memory_order_acq_rel) != EMPTY_OR_PINNED) {
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void LockFreeClockReplacer::Unpin(frame_id_t frame_id) {
+    uint8_t expected = EMPTY_OR_PINNED;
+    if (states_[frame_id].compare_exchange_strong(expected, ACCESSED, std::memory_order_acq_rel)) {
+        size_.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+void LockFreeClockReplacer::RecordAccess(frame_id_t frame_id) {
+    uint8_t expected = UNTOUCHED;
+    states_[frame_id].compare_exchange_strong(expected, ACCESSED, std::memory_order_acq_rel);
+}
+
+/**
+ * @brief 与 ClockReplacer::PeekVictims 相同：先是从指针起的 UNTOUCHED 帧，再是 ACCESSED 帧
+ */
+void LockFreeClockReplacer::PeekVictims(size_t n, std::vector<frame_id_t> *frames) {
+    size_t capacity = capacity_.load(std::memory_order_relaxed);
+    size_t hand = hand_.load(std::memory_order_relaxed) % capacity;
+    for (uint8_t status : {UNTOUCHED, ACCESSED}) {
+        for (size_t i = 0; i < capacity && n > 0; i++) {
+            frame_id_t frame_id = static_cast<frame_id_t>((hand + i) % capacity);
+            if (states_[frame_id].load(std::memory_order_relaxed) == status) {
+                frames->push_back(frame_id);
+                n--;
+            }
+        }
+    }
+}
+
+size_t LockFreeClockReplacer::Size() {
+    int64_t size = size_.load(std::memory_order_acquire);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
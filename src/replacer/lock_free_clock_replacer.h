@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// lock_free_clock_replacer.h
+//
+// Identification: src/replacer/lock_free_clock_replacer.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/**
+ * LockFreeClockReplacer implements the clock replacement policy without any mutex.
+ *
+ * 每个帧的状态（EMPTY_OR_PINNED / UNTOUCHED / ACCESSED，即是否可淘汰与访问位）是一个原子变量，
+ * Pin/Unpin 都是一次原子操作；Victim 用 fetch_add 推进时钟指针，用 CAS 清除访问位或取走 UNTOUCHED 的帧，
+ * 多个线程可以同时扫描而互不阻塞。
+ * @note 淘汰顺序与 ClockReplacer 相同；并发时 PeekVictims 只是近似
+ */
+class LockFreeClockReplacer : public Replacer {
+   public:
+    enum Status : uint8_t { EMPTY_OR_PINNED = 0, UNTOUCHED = 1, ACCESSED = 2 };
+
+    /**
+     * @param num_pages the maximum number of pages the LockFreeClockReplacer will be required to store
+     */
+    explicit LockFreeClockReplacer(size_t num_pages);
+
+    ~LockFreeClockReplacer() override = default;
+
+    bool Victim(frame_id_t *frame_id) override;
+
+    void Pin(frame_id_t frame_id) override;
+
+    void Unpin(frame_id_t frame_id) override;
+
+    /** 命中时设置访问位 */
+    void RecordAccess(frame_id_t frame_id) override;
+
+    void PeekVictims(size_t n, std::vector<frame_id_t> *frames) override;
+
+    size_t Size() override;
+
+    /** 时钟指针只在前 num_pages 个帧上转动；正在扫描的线程可能仍落到多出的帧上，它们已被 Pin，会被跳过 */
+    void SetCapacity(size_t num_pages) override { capacity_.store(num_pages, std::memory_order_relaxed); }
+
+   private:
+    std::atomic<size_t> capacity_;
+    std::unique_ptr<std::atomic<uint8_t>[]> states_;
+    /** 时钟指针，只增不减，取模后为帧 id */
+    std::atomic<uint64_t> hand_{0};
+    /** 可淘汰的帧数，Victim 在其为 0 时直接返回 */
+    std::atomic<int64_t> size_{0};
+};
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// lock_free_clock_replacer_test.cpp
+//
+// Identification: src/replacer/lock_free_clock_replacer_test.cpp
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "replacer/lock_free_clock_replacer.h"
+
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief 单线程时与 ClockReplacer 的淘汰顺序相同
+ */
+TEST(LockFreeClockReplacerTest, SimpleTest) {
+    LockFreeClockReplacer replacer(7);
+
+    for (frame_id_t i = 1; i <= 6; i++) {
+        replacer.Unpin(i);
+    }
+    replacer.Unpin(1);
+    EXPECT_EQ(6, replacer.Size());
+
+    frame_id_t value;
+    for (frame_id_t i = 1; i <= 3; i++) {
+        ASSERT_TRUE(replacer.Victim(&value));
+        EXPECT_EQ(i, value);
+    }
+
+    replacer.Pin(3);
+    replacer.Pin(4);
+    EXPECT_EQ(2, replacer.Size());
+    replacer.Unpin(4);
+
+    std::vector<frame_id_t> peeked;
+    replacer.PeekVictims(3, &peeked);
+    EXPECT_EQ(peeked, (std::vector<frame_id_t>{5, 6, 4}));
+    for (frame_id_t expected : {5, 6, 4}) {
+        ASSERT_TRUE(replacer.Victim(&value));
+        EXPECT_EQ(expected, value);
+    }
+    EXPECT_FALSE(replacer.Victim(&value));
+    EXPECT_EQ(0, replacer.Size());
+
+    // 命中设置访问位，被淘汰得更晚
+    replacer.Unpin(0);
+    replacer.Unpin(1);
+    replacer.Unpin(2);
+    ASSERT_TRUE(replacer.Victim(&value));
+    EXPECT_EQ(0, value);
+    replacer.RecordAccess(1);
+    ASSERT_TRUE(replacer.Victim(&value));
+    EXPECT_EQ(2, value);
+    ASSERT_TRUE(replacer.Victim(&value));
+    EXPECT_EQ(1, value);
+}
+
+/**
+ * @brief 多线程同时 Pin/Unpin/Victim：同一帧不会被两个线程同时取走，结束后 Size 与可淘汰的帧一致
+ */
+TEST(LockFreeClockReplacerTest, ConcurrencyTest) {
+    const int num_threads = 4;
+    const int frames_per_thread = 256;
+    const int num_frames = num_threads * frames_per_thread;
+    LockFreeClockReplacer replacer(num_frames);
+
+    // 每个线程 pin/unpin 自己的帧，同时淘汰任意帧；淘汰得到的帧归淘汰它的线程所有
+    std::vector<std::vector<frame_id_t>> owned(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::vector<frame_id_t> &frames = owned[t];
+            for (int i = 0; i < frames_per_thread; i++) {
+                frames.push_back(t * frames_per_thread + i);
+            }
+            std::vector<frame_id_t> unpinned;
+            for (int i = 0; i < 20000; i++) {
+                int op = rng() % 3;
+                if (op == 0 && !frames.empty()) {
+                    replacer.Unpin(frames.back());
+                    unpinned.push_back(frames.back());
+                    frames.pop_back();
+                } else if (op == 1) {
+                    frame_id_t frame_id;
+                    if (replacer.Victim(&frame_id)) {
+                        frames.push_back(frame_id);
+                    }
+                } else if (!unpinned.empty()) {
+                    // 帧可能已被其他线程淘汰，此时 RecordAccess 什么也不做
+                    replacer.RecordAccess(unpinned.back());
+                    unpinned.pop_back();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::set<frame_id_t> seen;
+    for (auto &frames : owned) {
+        for (frame_id_t frame_id : frames) {
+            EXPECT_TRUE(seen.insert(frame_id).second) << frame_id;
+        }
+    }
+    size_t size = replacer.Size();
+    EXPECT_EQ(size + seen.size(), num_frames);
+    frame_id_t frame_id;
+    while (replacer.Victim(&frame_id)) {
+        EXPECT_TRUE(seen.insert(frame_id).second) << frame_id;
+    }
+    EXPECT_EQ(seen.size(), num_frames);
+    EXPECT_EQ(replacer.Size(), 0);
+}
@@ -0,0 +1,92 @@
+#include "replacer/lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : k_(std::max<size_t>(k, 1)), frames_(num_pages) {
+    for (auto &history : frames_) {
+        history.timestamps.resize(k_);
+    }
+}
+
+std::pair<bool, uint64_t> LRUKReplacer::Key(const FrameHistory &history) const {
+    if (history.count < k_) {
+        return {false, history.timestamps[0]};
+    }
+    // 环形缓冲区中下一个要被覆盖的位置就是倒数第 k_ 次访问
+    return {true, history.timestamps[history.count % k_]};
+}
+
+/**
+ * @brief 淘汰 backward K-distance 最大的帧，并清除它的访问历史
+ */
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+    std::scoped_lock lock{latch_};
+    if (evictable_.empty()) {
+        return false;
+    }
+    *frame_id = evictable_.begin()->second;
+    evictable_.erase(evictable_.begin());
+    frames_[*frame_id].evictable = false;
+    frames_[*frame_id].count = 0;
+    return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    SetEvictable(frame_id, false);
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    SetEvictable(frame_id, true);
+}
+
+/**
+ * @brief 记录一次对帧的访问
+ */
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    FrameHistory &history = frames_[frame_id];
+    bool evictable = history.evictable;
+    SetEvictable(frame_id, false);
+    history.timestamps[history.count % k_] = current_timestamp_++;
+    history.count++;
+    SetEvictable(frame_id, evictable);
+}
+
+/**
+ * @brief 帧上的页面被删除：移出 replacer 并清除访问历史
+ */
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    SetEvictable(frame_id, false);
+    frames_[frame_id].count = 0;
+}
+
+void LRUKReplacer::PeekVictims(size_t n, std::vector<frame_id_t> *frames) {
+    std::scoped_lock lock{latch_};
+    for (auto it = evictable_.begin(); it != evictable_.end() && n > 0; ++it, --n) {
+        frames->push_back(it->second);
+    }
+}
+
+size_t LRUKReplacer::Size() {
+    std::scoped_lock lock{latch_};
+    return evictable_.size();
+}
+
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool evictable) {
+    FrameHistory &history = frames_[frame_id];
+    if (history.evictable == evictable) {
+        return;
+    }
+    if (history.count == 0) {
+        // 从未被访问过的帧（如 BufferPoolManager 之外直接使用 replacer）视为刚被访问
+        history.timestamps[0] = current_timestamp_++;
+        history.count = 1;
+    }
+    if (evictable) {
+        evictable_.emplace(Key(history), frame_id);
+    } else {
+        evictable_.erase({Key(history), frame_id});
+    }
+    history.evictable = evictable;
+}
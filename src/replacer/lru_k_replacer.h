@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// lru_k_replacer.h
+//
+// Identification: src/replacer/lru_k_replacer.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * 每个帧记录最近 K 次访问的时间戳，淘汰 backward K-distance（当前时间与倒数第 K 次访问的时间差）最大的帧；
+ * 访问不足 K 次的帧距离为 +inf，优先淘汰，其中按最早一次访问的先后淘汰。
+ * 一次大表扫描中的页面只被访问一次，不会把多次访问过的热点页面（如索引内部节点）挤出缓冲池。
+ */
+class LRUKReplacer : public Replacer {
+   public:
+    /**
+     * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+     * @param k 记录的访问次数，k = 1 时退化为 LRU
+     */
+    LRUKReplacer(size_t num_pages, size_t k);
+
+    ~LRUKReplacer() override = default;
+
+    bool Victim(frame_id_t *frame_id) override;
+
+    void Pin(frame_id_t frame_id) override;
+
+    void Unpin(frame_id_t frame_id) override;
+
+    void PeekVictims(size_t n, std::vector<frame_id_t> *frames) override;
+
+    void RecordAccess(frame_id_t frame_id) override;
+
+    void Remove(frame_id_t frame_id) override;
+
+    size_t Size() override;
+
+    size_t GetK() const { return k_; }
+
+   private:
+    /** 帧的访问历史：最近 k_ 次访问的时间戳组成的环形缓冲区 */
+    struct FrameHistory {
+        std::vector<uint64_t> timestamps;
+        size_t count = 0;  // 总访问次数
+        bool evictable = false;
+    };
+
+    /**
+     * @brief 帧在 evictable_ 中的排序键：{是否已有 k_ 次访问, 倒数第 k_ 次（或最早一次）访问的时间}
+     * @note 未满 k_ 次的帧排在前面（距离为 +inf），同类中时间戳越小距离越大
+     */
+    std::pair<bool, uint64_t> Key(const FrameHistory &history) const;
+
+    void SetEvictable(frame_id_t frame_id, bool evictable);
+
+    std::mutex latch_;
+    size_t k_;
+    uint64_t current_timestamp_ = 0;
+    std::vector<FrameHistory> frames_;
+    /** 可淘汰的帧，按淘汰顺序排列 */
+    std::set<std::pair<std::pair<bool, uint64_t>, frame_id_t>> evictable_;
+};
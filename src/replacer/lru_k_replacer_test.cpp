@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: src/replacer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "replacer/lru_k_replacer.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "replacer/lru_replacer.h"
+#include "replacer/replacer_trace.h"
+
+/**
+ * @brief 按 backward K-distance 淘汰：访问不足 K 次的帧优先，其中最早访问的先淘汰
+ */
+TEST(LRUKReplacerTest, SimpleTest) {
+    LRUKReplacer replacer(7, 2);
+
+    // 帧 1~6 各访问一次，帧 1 再访问一次
+    for (frame_id_t i = 1; i <= 6; i++) {
+        replacer.RecordAccess(i);
+    }
+    replacer.RecordAccess(1);
+    for (frame_id_t i = 1; i <= 6; i++) {
+        replacer.Unpin(i);
+    }
+    EXPECT_EQ(6, replacer.Size());
+
+    // 帧 2~6 只访问过一次，距离为 +inf，按最早访问的顺序淘汰；帧 1 最后淘汰
+    frame_id_t frame_id;
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(2, frame_id);
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(3, frame_id);
+
+    // pin 住的帧不会被淘汰
+    replacer.Pin(4);
+    EXPECT_EQ(3, replacer.Size());
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(5, frame_id);
+
+    // 帧 4 访问两次后距离变为有限值，晚于帧 6 淘汰
+    replacer.RecordAccess(4);
+    replacer.Unpin(4);
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(6, frame_id);
+
+    // 都满 K 次时，倒数第 K 次访问越早越先淘汰：帧 1 的倒数第 2 次访问早于帧 4
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(1, frame_id);
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(4, frame_id);
+    EXPECT_FALSE(replacer.Victim(&frame_id));
+    EXPECT_EQ(0, replacer.Size());
+
+    // 被淘汰的帧清除了访问历史
+    replacer.RecordAccess(1);
+    replacer.RecordAccess(2);
+    replacer.RecordAccess(2);
+    replacer.Unpin(2);
+    replacer.Unpin(1);
+    ASSERT_TRUE(replacer.Victim(&frame_id));
+    EXPECT_EQ(1, frame_id);
+
+    // Remove 之后帧不在 replacer 中
+    replacer.Remove(2);
+    EXPECT_EQ(0, replacer.Size());
+}
+
+/**
+ * @brief K = 1 时与 LRU 的淘汰顺序相同
+ */
+TEST(LRUKReplacerTest, KEqualsOneIsLRU) {
+    const size_t num_frames = 64;
+    LRUKReplacer lru_k(num_frames, 1);
+    LRUReplacer lru(num_frames);
+    auto trace = ReplacerTrace::Zipf(512, 20000, 0.8);
+    EXPECT_DOUBLE_EQ(ReplacerTrace::HitRatio(&lru_k, num_frames, trace),
+                     ReplacerTrace::HitRatio(&lru, num_frames, trace));
+}
+
+/**
+ * @brief 访问序列驱动的命中率测试：顺序扫描不会把热点页面挤出缓冲池
+ */
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+    const size_t num_frames = 256;
+    // 200 个热点页面装得进缓冲池，但每轮的扫描有 1000 个页面
+    auto trace = ReplacerTrace::HotSetWithScans(200, 1000, 20, 5000);
+
+    LRUReplacer lru(num_frames);
+    LRUKReplacer lru_2(num_frames, 2);
+    double lru_hit = ReplacerTrace::HitRatio(&lru, num_frames, trace);
+    double lru_2_hit = ReplacerTrace::HitRatio(&lru_2, num_frames, trace);
+    // 扫描的页面都只访问一次，不可能命中；LRU 每轮扫描后热点页面全部被换出，LRU-2 则保留
+    double best = 5000.0 / 6000.0;
+    EXPECT_GT(lru_2_hit, best * 0.95);
+    EXPECT_LT(lru_hit, lru_2_hit - 0.02);
+}
+
+/**
+ * @brief Zipf 分布的随机访问上 LRU-2 的命中率不低于 LRU
+ */
+TEST(LRUKReplacerTest, ZipfHitRatioTest) {
+    const size_t num_frames = 128;
+    auto trace = ReplacerTrace::Zipf(2048, 100000, 0.9);
+    LRUReplacer lru(num_frames);
+    LRUKReplacer lru_2(num_frames, 2);
+    EXPECT_GE(ReplacerTrace::HitRatio(&lru_2, num_frames, trace), ReplacerTrace::HitRatio(&lru, num_frames, trace));
+}
+
+/**
+ * @brief 按名称创建替换策略
+ */
+TEST(LRUKReplacerTest, CreateTest) {
+    auto lru_k = Replacer::Create("lru-k", 8);
+    ASSERT_NE(dynamic_cast<LRUKReplacer *>(lru_k.get()), nullptr);
+    EXPECT_EQ(dynamic_cast<LRUKReplacer *>(lru_k.get())->GetK(), LRUK_REPLACER_K);
+    auto lru_3 = Replacer::Create("LRU-3", 8);
+    ASSERT_NE(dynamic_cast<LRUKReplacer *>(lru_3.get()), nullptr);
+    EXPECT_EQ(dynamic_cast<LRUKReplacer *>(lru_3.get())->GetK(), 3);
+    EXPECT_NE(dynamic_cast<LRUReplacer *>(Replacer::Create("LRU", 8).get()), nullptr);
+    EXPECT_NE(dynamic_cast<LRUReplacer *>(Replacer::Create("unknown", 8).get()), nullptr);
+}
+
+/**
+ * @brief 多线程并发访问
+ */
+TEST(LRUKReplacerTest, ConcurrencyTest) {
+    const int num_threads = 4;
+    const int num_frames = 1000;
+    LRUKReplacer replacer(num_frames * num_threads, 2);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < num_frames; i++) {
+                frame_id_t frame_id = t * num_frames + i;
+                replacer.RecordAccess(frame_id);
+                replacer.Unpin(frame_id);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(replacer.Size(), num_frames * num_threads);
+    frame_id_t frame_id;
+    for (int i = 0; i < num_frames * num_threads; i++) {
+        ASSERT_TRUE(replacer.Victim(&frame_id));
+    }
+    EXPECT_FALSE(replacer.Victim(&frame_id));
+}
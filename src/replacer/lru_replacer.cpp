@@ -59,6 +59,16 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
     LRUhash_[frame_id] = it;
 }
 
+/**
+ * @brief 从 LRUlist_ 的尾部起列出接下来会被淘汰的帧
+ */
+void LRUReplacer::PeekVictims(size_t n, std::vector<frame_id_t> *frames) {
+    std::scoped_lock lock{latch_};
+    for (auto it = LRUlist_.rbegin(); it != LRUlist_.rend() && n > 0; ++it, --n) {
+        frames->push_back(*it);
+    }
+}
+
 /** @return replacer 中能够 victim 的数量 */
 size_t LRUReplacer::Size() {
     // Todo:
@@ -43,6 +43,8 @@ class LRUReplacer : public Replacer {
 
     void Unpin(frame_id_t frame_id);
 
+    void PeekVictims(size_t n, std::vector<frame_id_t> *frames);
+
     size_t Size();
 
    private:
@@ -17,6 +17,7 @@
 #include <memory>
 #include <random>
 #include <set>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -167,3 +168,43 @@ TEST(LRUReplacerTest, ConcurrencyTest) {
         EXPECT_EQ(0, lru_replacer->Victim(&result));
     }
 }
+
+/**
+ * @brief 各种替换策略的 PeekVictims 与随后 Victim 选出的帧顺序一致，且不改变 replacer 的状态
+ */
+TEST(ReplacerTest, PeekVictimsTest) {
+    const size_t num_frames = 64;
+    for (std::string type : {"LRU", "CLOCK", "CLOCK-LF", "LRU-2", "ARC"}) {
+        auto replacer = Replacer::Create(type, num_frames);
+        std::mt19937 rng(0);
+        std::vector<bool> pinned(num_frames, true);
+        for (int i = 0; i < 2000; i++) {
+            frame_id_t frame_id = rng() % num_frames;
+            if (pinned[frame_id]) {
+                replacer->RecordLoad(frame_id, rng() % (num_frames * 4));
+                replacer->Unpin(frame_id);
+                pinned[frame_id] = false;
+            } else if (rng() % 2 == 0) {
+                replacer->Pin(frame_id);
+                replacer->RecordAccess(frame_id);
+                replacer->Unpin(frame_id);
+            } else if (rng() % 2 == 0 && replacer->Victim(&frame_id)) {
+                pinned[frame_id] = true;
+            }
+        }
+        size_t size = replacer->Size();
+        std::vector<frame_id_t> peeked;
+        replacer->PeekVictims(size / 2, &peeked);
+        replacer->PeekVictims(size + 1, &peeked);
+        ASSERT_EQ(peeked.size(), size / 2 + size) << type;
+        EXPECT_EQ(replacer->Size(), size) << type;
+        for (size_t i = 0; i < size; i++) {
+            frame_id_t frame_id;
+            ASSERT_TRUE(replacer->Victim(&frame_id)) << type;
+            EXPECT_EQ(frame_id, peeked[size / 2 + i]) << type;
+            if (i < size / 2) {
+                EXPECT_EQ(frame_id, peeked[i]) << type;
+            }
+        }
+    }
+}
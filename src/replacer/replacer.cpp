@@ -0,0 +1,46 @@
+#include "replacer/replacer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "common/logger.h"
+#include "replacer/arc_replacer.h"
+#include "replacer/clock_replacer.h"
+#include "replacer/lock_free_clock_replacer.h"
+#include "replacer/lru_k_replacer.h"
+#include "replacer/lru_replacer.h"
+
+std::unique_ptr<Replacer> Replacer::Create(const std::string &type, size_t num_pages) {
+    std::string name = type;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::toupper(c); });
+    if (name == "LRU") {
+        return std::make_unique<LRUReplacer>(num_pages);
+    }
+    if (name == "CLOCK") {
+        return std::make_unique<ClockReplacer>(num_pages);
+    }
+    if (name == "CLOCK-LF") {
+        return std::make_unique<LockFreeClockReplacer>(num_pages);
+    }
+    if (name == "ARC") {
+        return std::make_unique<ARCReplacer>(num_pages);
+    }
+    if (name == "LRU-K") {
+        return std::make_unique<LRUKReplacer>(num_pages, LRUK_REPLACER_K);
+    }
+    if (name.size() > 4 && name.compare(0, 4, "LRU-") == 0 &&
+        std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        size_t k = std::stoul(name.substr(4));
+        if (k > 0) {
+            return std::make_unique<LRUKReplacer>(num_pages, k);
+        }
+    }
+    LOG_WARN("Replacer type %s defined wrong, use LRU as replacer.", type.c_str());
+    return std::make_unique<LRUReplacer>(num_pages);
+}
+
+std::string Replacer::DefaultType() {
+    const char *type = std::getenv("RUCBASE_REPLACER");
+    return type != nullptr && type[0] != '\0' ? type : REPLACER_TYPE;
+}
@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 /**
@@ -41,6 +45,50 @@ class Replacer {
      */
     virtual void Unpin(frame_id_t frame_id) = 0;
 
+    /**
+     * @brief 记录一次对帧上页面的访问（命中或换入），供需要访问历史的策略（如 LRU-K）使用
+     * @param frame_id the id of the accessed frame
+     */
+    virtual void RecordAccess(frame_id_t frame_id) {}
+
+    /**
+     * @brief 记录页面被换入帧中（第一次访问），page_key 唯一标识页面，供需要记住已淘汰页面的策略（如 ARC）使用
+     * @param frame_id the id of the frame the page is loaded into
+     * @param page_key 页面的标识，见 PageIdHash::Key
+     */
+    virtual void RecordLoad(frame_id_t frame_id, uint64_t page_key) { RecordAccess(frame_id); }
+
+    /**
+     * @brief 帧上的页面被删除或丢弃，移出 replacer，并清除该帧的访问历史
+     * @param frame_id the id of the frame to remove
+     */
+    virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+    /**
+     * @brief 按淘汰顺序列出接下来最多 n 个会被 Victim 选中的帧，不改变 replacer 的状态
+     * @note 供缓冲池的后台刷脏线程在这些帧被淘汰之前写回其中的脏页；默认不列出任何帧
+     * @param n 最多列出的帧数
+     * @param[out] frames 追加列出的帧
+     */
+    virtual void PeekVictims(size_t n, std::vector<frame_id_t> *frames) {}
+
     /** @return the number of elements in the replacer that can be victimized */
     virtual size_t Size() = 0;
+
+    /**
+     * @brief 设置使用中的帧数（缓冲池在线扩缩容时），依赖容量的策略（如 ARC、CLOCK）按它调整，默认不做处理
+     * @param num_pages 使用中的帧数，不超过构造时的 num_pages；缩小时多出的帧已经被 Pin 或 Remove
+     */
+    virtual void SetCapacity(size_t num_pages) {}
+
+    /**
+     * @brief 按名称创建替换策略："LRU"、"CLOCK"、"CLOCK-LF"（无锁 CLOCK）、"ARC"、"LRU-K"（K 取 LRUK_REPLACER_K）或 "LRU-<K>"（如 "LRU-2"）
+     * @note 名称不区分大小写；无法识别时打印警告并使用 LRU
+     */
+    static std::unique_ptr<Replacer> Create(const std::string &type, size_t num_pages);
+
+    /**
+     * @return 启动时使用的替换策略：环境变量 RUCBASE_REPLACER，未设置时为 REPLACER_TYPE
+     */
+    static std::string DefaultType();
 };
@@ -0,0 +1,102 @@
+/**
+ * @brief 替换策略的基准
+ * 1. 命中率：在 Zipf、循环和热点 + 扫描混合的访问序列上对比 LRU、CLOCK、LRU-2 与 ARC
+ * 2. 竞争：多线程直接调用 replacer（不经过缓冲池的 latch），90% 为命中（Pin/RecordAccess/Unpin），
+ *    10% 为淘汰（Victim/Unpin），对比各策略的吞吐
+ * @note 用法：replacer_bench [num_frames] [max_threads]
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "replacer/replacer_trace.h"
+
+/**
+ * @return 每秒完成的 replacer 操作数
+ */
+static double contention(const std::string &type, size_t num_frames, int num_threads, int ops_per_thread) {
+    auto replacer = Replacer::Create(type, num_frames);
+    for (size_t i = 0; i < num_frames; i++) {
+        replacer->Unpin(static_cast<frame_id_t>(i));
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int i = 0; i < ops_per_thread; i++) {
+                frame_id_t frame_id = static_cast<frame_id_t>(rng() % num_frames);
+                if (rng() % 10 != 0) {
+                    replacer->Pin(frame_id);
+                    replacer->RecordAccess(frame_id);
+                    replacer->Unpin(frame_id);
+                } else if (replacer->Victim(&frame_id)) {
+                    replacer->Unpin(frame_id);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(num_threads) * ops_per_thread / elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    size_t num_frames = argc > 1 ? std::stoul(argv[1]) : 1024;
+    int max_threads = argc > 2 ? std::stoi(argv[2]) : 16;
+    int n = static_cast<int>(num_frames);
+
+    struct Trace {
+        std::string name;
+        std::vector<int> pages;
+    };
+    std::vector<Trace> traces = {
+        {"zipf(0.8), 16x pages", ReplacerTrace::Zipf(n * 16, n * 200, 0.8)},
+        {"zipf(1.1), 16x pages", ReplacerTrace::Zipf(n * 16, n * 200, 1.1)},
+        {"loop, 1.25x pages", ReplacerTrace::Loop(n + n / 4, n * 200)},
+        {"hot 0.75x + scan 4x", ReplacerTrace::HotSetWithScans(n * 3 / 4, n * 4, 20, n * 10)},
+        {"zipf + scan", [&] {
+             auto trace = ReplacerTrace::Zipf(n * 4, n * 100, 0.9);
+             for (int i = 0; i < n * 8; i++) {
+                 trace.insert(trace.begin() + trace.size() / 2 + i, n * 4 + i);
+             }
+             return trace;
+         }()},
+    };
+    std::vector<std::string> policies = {"LRU", "CLOCK", "LRU-2", "ARC"};
+
+    printf("frames = %zu\n%-24s", num_frames, "trace");
+    for (auto &policy : policies) {
+        printf("%10s", policy.c_str());
+    }
+    printf("\n");
+    for (auto &trace : traces) {
+        printf("%-24s", trace.name.c_str());
+        for (auto &policy : policies) {
+            auto replacer = Replacer::Create(policy, num_frames);
+            printf("%9.2f%%", ReplacerTrace::HitRatio(replacer.get(), num_frames, trace.pages) * 100);
+        }
+        printf("\n");
+    }
+
+    std::vector<std::string> contended = {"LRU", "CLOCK", "CLOCK-LF"};
+    printf("\n%8s", "threads");
+    for (auto &policy : contended) {
+        printf("%14s", policy.c_str());
+    }
+    printf("\n");
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        printf("%8d", num_threads);
+        for (auto &policy : contended) {
+            printf("%10.2f M/s", contention(policy, num_frames, num_threads, 1000000) / 1e6);
+        }
+        printf("\n");
+    }
+    return 0;
+}
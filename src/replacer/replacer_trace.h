@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// replacer_trace.h
+//
+// Identification: src/replacer/replacer_trace.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "replacer/replacer.h"
+
+/**
+ * @brief 用页面访问序列驱动替换策略，模拟缓冲池的命中率，用于对比不同的替换策略
+ * @note 与 BufferPoolInstance 调用 replacer 的方式相同：命中时 Pin + RecordAccess，缺页时先用空闲帧再 Victim、
+ * Pin + RecordLoad，用完立即 Unpin
+ */
+class ReplacerTrace {
+   public:
+    /**
+     * @return 访问序列 trace 在 num_frames 个帧、替换策略 replacer 下的命中率
+     */
+    static double HitRatio(Replacer *replacer, size_t num_frames, const std::vector<int> &trace) {
+        std::unordered_map<int, frame_id_t> page_table;
+        std::vector<int> frame_pages(num_frames, -1);
+        frame_id_t next_free = 0;
+        size_t hits = 0;
+        for (int page : trace) {
+            frame_id_t frame_id;
+            auto it = page_table.find(page);
+            if (it != page_table.end()) {
+                frame_id = it->second;
+                hits++;
+            } else {
+                if (static_cast<size_t>(next_free) < num_frames) {
+                    frame_id = next_free++;
+                } else if (!replacer->Victim(&frame_id)) {
+                    continue;
+                }
+                if (frame_pages[frame_id] != -1) {
+                    page_table.erase(frame_pages[frame_id]);
+                }
+                frame_pages[frame_id] = page;
+                page_table[page] = frame_id;
+                replacer->Pin(frame_id);
+                replacer->RecordLoad(frame_id, page);
+                replacer->Unpin(frame_id);
+                continue;
+            }
+            replacer->Pin(frame_id);
+            replacer->RecordAccess(frame_id);
+            replacer->Unpin(frame_id);
+        }
+        return trace.empty() ? 0 : static_cast<double>(hits) / trace.size();
+    }
+
+    /**
+     * @brief 热点页面的随机访问中穿插整表顺序扫描：模拟 OLTP 点查询（索引内部节点、小表）与偶尔的 SELECT *
+     * @param num_hot 热点页面数，编号为 [0, num_hot)
+     * @param num_scan 每次扫描的页面数，编号为 [num_hot, num_hot + num_scan)
+     * @param rounds 轮数，每轮先访问 hot_accesses 次热点页面，再扫描一遍
+     */
+    static std::vector<int> HotSetWithScans(int num_hot, int num_scan, int rounds, int hot_accesses,
+                                            unsigned seed = 0) {
+        std::mt19937 rng(seed);
+        std::vector<int> trace;
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < hot_accesses; i++) {
+                trace.push_back(static_cast<int>(rng() % num_hot));
+            }
+            for (int i = 0; i < num_scan; i++) {
+                trace.push_back(num_hot + i);
+            }
+        }
+        return trace;
+    }
+
+    /**
+     * @brief 循环顺序访问 [0, num_pages)，页面数超过缓冲池时 LRU 一次也不会命中
+     */
+    static std::vector<int> Loop(int num_pages, int length) {
+        std::vector<int> trace(length);
+        for (int i = 0; i < length; i++) {
+            trace[i] = i % num_pages;
+        }
+        return trace;
+    }
+
+    /**
+     * @brief Zipf 分布的随机访问（倾斜度 theta），页面编号为 [0, num_pages)
+     */
+    static std::vector<int> Zipf(int num_pages, int length, double theta, unsigned seed = 0) {
+        std::vector<double> weights(num_pages);
+        for (int i = 0; i < num_pages; i++) {
+            weights[i] = 1.0 / std::pow(i + 1, theta);
+        }
+        std::discrete_distribution<int> dist(weights.begin(), weights.end());
+        std::mt19937 rng(seed);
+        std::vector<int> trace(length);
+        for (auto &page : trace) {
+            page = dist(rng);
+        }
+        return trace;
+    }
+};
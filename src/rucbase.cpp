@@ -16,7 +16,11 @@
 static bool should_exit = false;
 
 auto disk_manager = std::make_unique<DiskManager>();
-auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+// 缓冲池大小由环境变量 RUCBASE_BUFFER_POOL_SIZE 决定，运行时可以用 SET buffer_pool_size = n 在线修改，
+// 上限为 RUCBASE_BUFFER_POOL_MAX_SIZE
+auto buffer_pool_manager =
+    std::make_unique<BufferPoolManager>(BufferPoolManager::DefaultPoolSize(), disk_manager.get(), BUFFER_POOL_INSTANCES,
+                                        Replacer::DefaultType(), BufferPoolManager::DefaultMaxPoolSize());
 auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
 auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
 auto sm_manager =
@@ -146,7 +150,22 @@ void start_server() {
 
     if (log_manager->GetLogMode()) {
         log_manager->RunFlushThread();
+        // WAL：页面写回前，日志必须已经持久化到页面 LSN
+        // WakeUpFlushThread 只有一个共享的 promise，多个写回线程同时调用时需要串行化，
+        // 拿到锁后重新检查，前一个调用者已经刷到 page_lsn 时不必再刷
+        static std::mutex log_flush_latch;
+        buffer_pool_manager->SetLogFlusher([](lsn_t page_lsn) {
+            if (log_manager->GetPersistentLsn() >= page_lsn) {
+                return;
+            }
+            std::scoped_lock lock{log_flush_latch};
+            if (log_manager->GetPersistentLsn() < page_lsn) {
+                std::promise<void> flushed;
+                log_manager->WakeUpFlushThread(&flushed);
+            }
+        });
     }
+    buffer_pool_manager->StartPageCleaner();
 
     while (!should_exit) {
         std::cout << "Waiting for new connection..." << std::endl;
@@ -176,14 +195,15 @@ void start_server() {
     int ret = shutdown(sockfd_server, SHUT_WR);  // shut down the all or part of a full-duplex connection.
     if(ret == -1) { printf("%s\n", strerror(errno)); }
 //    assert(ret != -1);
+    buffer_pool_manager->StopPageCleaner();
     sm_manager->close_db();
     std::cout << " DB has been closed.\n";
     std::cout << "Server shuts down." << std::endl;
 }
 
 int main(int argc, char **argv) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <database>" << std::endl;
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <database> [page_size]" << std::endl;
         exit(1);
     }
 
@@ -199,11 +219,19 @@ int main(int argc, char **argv) {
                      "Welcome to RUC Database !\n"
                      "Type 'help;' for help.\n"
                      "\n";
+        // 命名缓冲池（如 keep、recycle）由 RUCBASE_BUFFER_POOLS 配置，表和索引在建表、建索引时分配到其中
+        buffer_pool_manager->AddPools(BufferPoolManager::DefaultPoolConfig());
+        size_t page_cache_size = BufferPoolManager::DefaultPageCacheSize();
+        if (page_cache_size > 0) {
+            buffer_pool_manager->EnablePageCache(page_cache_size);
+        }
         // Database name is passed by args
         std::string db_name = argv[1];
         if (!sm_manager->is_dir(db_name)) {
             // Database not found, create a new one
-            sm_manager->create_db(db_name);
+            // 页面大小只在创建数据库时生效，之后由数据库的元数据决定
+            int page_size = argc == 3 ? std::atoi(argv[2]) : PAGE_SIZE;
+            sm_manager->create_db(db_name, page_size);
         }
         // Open database
         sm_manager->open_db(db_name);
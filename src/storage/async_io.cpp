@@ -0,0 +1,305 @@
+#include "storage/async_io.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+int IoRequest::Wait() {
+    if (!IsDone()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return IsDone(); });
+    }
+    if (result_ < 0) {
+        errno = -result_;
+        throw UnixError();
+    }
+    if (op_ == IoOp::WRITE && result_ != num_bytes_) {
+        errno = EIO;
+        throw UnixError();
+    }
+    return result_;
+}
+
+void IoRequest::Complete(int result) {
+    {
+        std::scoped_lock lock{mutex_};
+        result_ = result;
+        done_.store(true, std::memory_order_release);
+    }
+    cv_.notify_all();
+}
+
+/**
+ * @brief 同步执行一次完整的 pread/pwrite，处理被信号打断和部分写
+ * @return 读写的字节数，失败时返回 -errno
+ */
+static int do_sync_io(IoOp op, int fd, off_t offset, char *buf, int num_bytes) {
+    int done = 0;
+    while (done < num_bytes) {
+        ssize_t ret = op == IoOp::READ ? pread(fd, buf + done, num_bytes - done, offset + done)
+                                       : pwrite(fd, buf + done, num_bytes - done, offset + done);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        if (ret == 0) {
+            break;  // 读到文件末尾
+        }
+        done += ret;
+    }
+    return done;
+}
+
+std::unique_ptr<AsyncIoEngine> AsyncIoEngine::Create(unsigned queue_depth) {
+    if (auto engine = IoUringEngine::Create(queue_depth)) {
+        return engine;
+    }
+    return std::make_unique<ThreadPoolIoEngine>();
+}
+
+/** -- io_uring -- */
+
+std::unique_ptr<IoUringEngine> IoUringEngine::Create(unsigned queue_depth) {
+    std::unique_ptr<IoUringEngine> engine(new IoUringEngine());
+    if (!engine->Setup(queue_depth)) {
+        return nullptr;
+    }
+    engine->reaper_ = std::thread(&IoUringEngine::ReapLoop, engine.get());
+    return engine;
+}
+
+bool IoUringEngine::Setup(unsigned queue_depth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = syscall(__NR_io_uring_setup, queue_depth, &params);
+    if (ring_fd_ < 0) {
+        ring_fd_ = -1;
+        return false;
+    }
+    // IORING_OP_READ/WRITE 需要 5.6+ 内核，用 NODROP 特性(同为 5.5+) 粗略判断
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+        return false;
+    }
+    sq_entries_ = params.sq_entries;
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                   IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+        sq_ptr_ = nullptr;
+        return false;
+    }
+    if (single_mmap) {
+        cq_ptr_ = sq_ptr_;
+    } else {
+        cq_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                       IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) {
+            cq_ptr_ = nullptr;
+            return false;
+        }
+    }
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sq_ptr_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+    char *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+}
+
+IoUringEngine::~IoUringEngine() {
+    if (reaper_.joinable()) {
+        // 等在途请求全部完成后，用 user_data == 0 的 NOP 通知收割线程退出
+        {
+            std::unique_lock<std::mutex> lock(submit_mutex_);
+            slot_cv_.wait(lock, [this] { return inflight_ == 0; });
+            unsigned tail = *sq_tail_;
+            unsigned idx = tail & *sq_mask_;
+            struct io_uring_sqe *sqe = &sqes_[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = 0;
+            sq_array_[idx] = idx;
+            __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+            inflight_++;
+            Enter(1, 0, 0);
+        }
+        reaper_.join();
+    }
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+        munmap(cq_ptr_, cq_ring_size_);
+    }
+    if (sq_ptr_ != nullptr) {
+        munmap(sq_ptr_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+    }
+}
+
+void IoUringEngine::Enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    while (true) {
+        int ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0);
+        if (ret >= 0 || errno != EINTR) {
+            if (ret < 0) {
+                throw UnixError();
+            }
+            return;
+        }
+    }
+}
+
+void IoUringEngine::Submit(const std::vector<IoRequestPtr> &requests) {
+    std::unique_lock<std::mutex> lock(submit_mutex_);
+    unsigned to_submit = 0;
+    for (auto &req : requests) {
+        if (inflight_ == sq_entries_) {
+            // 队列已满：先把已填好的请求下发，再等待收割线程腾出空位
+            if (to_submit > 0) {
+                Enter(to_submit, 0, 0);
+                to_submit = 0;
+            }
+            slot_cv_.wait(lock, [this] { return inflight_ < sq_entries_; });
+        }
+        unsigned tail = *sq_tail_;
+        unsigned idx = tail & *sq_mask_;
+        struct io_uring_sqe *sqe = &sqes_[idx];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = req->op_ == IoOp::READ ? IORING_OP_READ : IORING_OP_WRITE;
+        sqe->fd = req->fd_;
+        sqe->off = req->offset_;
+        sqe->addr = reinterpret_cast<unsigned long>(req->buf_);
+        sqe->len = req->num_bytes_;
+        sqe->user_data = reinterpret_cast<unsigned long>(req.get());
+        sq_array_[idx] = idx;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        pending_[req.get()] = req;
+        inflight_++;
+        to_submit++;
+    }
+    if (to_submit > 0) {
+        Enter(to_submit, 0, 0);
+    }
+}
+
+void IoUringEngine::ReapLoop() {
+    while (true) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            Enter(0, 1, IORING_ENTER_GETEVENTS);
+            continue;
+        }
+        bool stop = false;
+        std::vector<std::pair<IoRequestPtr, int>> completed;
+        {
+            std::scoped_lock lock{submit_mutex_};
+            for (; head != tail; head++) {
+                struct io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+                auto *raw = reinterpret_cast<IoRequest *>(cqe->user_data);
+                inflight_--;
+                if (raw == nullptr) {
+                    stop = true;
+                    continue;
+                }
+                auto it = pending_.find(raw);
+                completed.emplace_back(std::move(it->second), cqe->res);
+                pending_.erase(it);
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        }
+        slot_cv_.notify_all();
+        for (auto &entry : completed) {
+            IoRequestPtr &req = entry.first;
+            int res = entry.second;
+            // io_uring 可能返回部分写，剩余部分同步补齐，保证与 write_page 相同的语义
+            if (req->op_ == IoOp::WRITE && res >= 0 && res < req->num_bytes_) {
+                int rest = do_sync_io(IoOp::WRITE, req->fd_, req->offset_ + res, req->buf_ + res,
+                                      req->num_bytes_ - res);
+                res = rest < 0 ? rest : res + rest;
+            }
+            req->Complete(res);
+        }
+        if (stop) {
+            return;
+        }
+    }
+}
+
+/** -- thread pool fallback -- */
+
+ThreadPoolIoEngine::ThreadPoolIoEngine(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; i++) {
+        workers_.emplace_back(&ThreadPoolIoEngine::WorkerLoop, this);
+    }
+}
+
+ThreadPoolIoEngine::~ThreadPoolIoEngine() {
+    {
+        std::scoped_lock lock{mutex_};
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPoolIoEngine::Submit(const std::vector<IoRequestPtr> &requests) {
+    {
+        std::scoped_lock lock{mutex_};
+        queue_.insert(queue_.end(), requests.begin(), requests.end());
+    }
+    if (requests.size() == 1) {
+        cv_.notify_one();
+    } else {
+        cv_.notify_all();
+    }
+}
+
+void ThreadPoolIoEngine::WorkerLoop() {
+    while (true) {
+        IoRequestPtr req;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // stop_ 且队列已清空
+            }
+            req = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        req->Complete(do_sync_io(req->op_, req->fd_, req->offset_, req->buf_, req->num_bytes_));
+    }
+}
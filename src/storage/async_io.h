@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// async_io.h
+//
+// Identification: src/storage/async_io.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "errors.h"
+
+enum class IoOp { READ, WRITE };
+
+/**
+ * @brief 一次异步页面 I/O 请求及其完成状态
+ * @note 由 DiskManager::async_read_page/async_write_page 创建，提交方持有并调用 Wait() 等待完成
+ */
+class IoRequest {
+    friend class IoUringEngine;
+    friend class ThreadPoolIoEngine;
+    friend class DiskManager;
+
+   public:
+    IoRequest(IoOp op, int fd, off_t offset, char *buf, int num_bytes)
+        : op_(op), fd_(fd), offset_(offset), buf_(buf), num_bytes_(num_bytes) {}
+
+    IoOp GetOp() const { return op_; }
+
+    int GetFd() const { return fd_; }
+
+    /** @return 请求是否已经完成（非阻塞） */
+    bool IsDone() const { return done_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 阻塞直到请求完成
+     * @return 实际读/写的字节数；读请求越过文件末尾时可能小于 num_bytes
+     * @note 失败或写入不完整时抛出 UnixError
+     */
+    int Wait();
+
+   private:
+    void Complete(int result);
+
+    IoOp op_;
+    int fd_;
+    off_t offset_;
+    char *buf_;
+    int num_bytes_;
+
+    std::atomic<bool> done_{false};
+    int result_ = 0;  // >= 0 为字节数, < 0 为 -errno
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+using IoRequestPtr = std::shared_ptr<IoRequest>;
+
+/**
+ * @brief 异步 I/O 引擎接口：提交一批请求后立即返回，由请求自身的 Wait()/IsDone() 获取完成状态
+ */
+class AsyncIoEngine {
+   public:
+    virtual ~AsyncIoEngine() = default;
+
+    /** 提交一批请求，尽量在一次系统调用内下发 */
+    virtual void Submit(const std::vector<IoRequestPtr> &requests) = 0;
+
+    void Submit(const IoRequestPtr &request) { Submit(std::vector<IoRequestPtr>{request}); }
+
+    virtual const char *Name() const = 0;
+
+    /**
+     * @brief 优先创建 io_uring 引擎，内核不支持时退化为线程池 pread/pwrite 引擎
+     * @param queue_depth 同时在途的最大请求数
+     */
+    static std::unique_ptr<AsyncIoEngine> Create(unsigned queue_depth = ASYNC_IO_QUEUE_DEPTH);
+};
+
+/**
+ * @brief 基于 io_uring 的异步 I/O 引擎（直接使用系统调用，不依赖 liburing）
+ * @note 提交在调用线程完成，完成事件由后台线程收割
+ */
+class IoUringEngine : public AsyncIoEngine {
+   public:
+    ~IoUringEngine() override;
+
+    /** @return 内核不支持 io_uring（或被禁用）时返回 nullptr */
+    static std::unique_ptr<IoUringEngine> Create(unsigned queue_depth);
+
+    void Submit(const std::vector<IoRequestPtr> &requests) override;
+
+    const char *Name() const override { return "io_uring"; }
+
+   private:
+    IoUringEngine() = default;
+
+    bool Setup(unsigned queue_depth);
+
+    void ReapLoop();
+
+    // 下发 to_submit 个已填好的 SQE，并可选地等待 min_complete 个完成事件
+    void Enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+
+    int ring_fd_ = -1;
+    unsigned sq_entries_ = 0;
+
+    // SQ ring
+    void *sq_ptr_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    unsigned *sq_head_ = nullptr;
+    unsigned *sq_tail_ = nullptr;
+    unsigned *sq_mask_ = nullptr;
+    unsigned *sq_array_ = nullptr;
+    struct io_uring_sqe *sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    // CQ ring
+    void *cq_ptr_ = nullptr;
+    size_t cq_ring_size_ = 0;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned *cq_mask_ = nullptr;
+    struct io_uring_cqe *cqes_ = nullptr;
+
+    std::mutex submit_mutex_;
+    std::condition_variable slot_cv_;  // 在途请求数达到 sq_entries_ 时等待
+    unsigned inflight_ = 0;
+    std::unordered_map<IoRequest *, IoRequestPtr> pending_;  // 保证在途请求在完成前不被释放
+
+    std::thread reaper_;
+};
+
+/**
+ * @brief io_uring 不可用时的退化实现：固定数量的工作线程执行 pread/pwrite
+ */
+class ThreadPoolIoEngine : public AsyncIoEngine {
+   public:
+    explicit ThreadPoolIoEngine(size_t num_threads = ASYNC_IO_THREADS);
+
+    ~ThreadPoolIoEngine() override;
+
+    void Submit(const std::vector<IoRequestPtr> &requests) override;
+
+    const char *Name() const override { return "thread-pool"; }
+
+   private:
+    void WorkerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<IoRequestPtr> queue_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
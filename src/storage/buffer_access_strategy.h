@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// buffer_access_strategy.h
+//
+// Identification: src/storage/buffer_access_strategy.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * @brief 大表顺序扫描与批量读写使用的缓冲区访问策略：在缓冲池中占用一个私有的小环，环中的帧在原地循环复用
+ * @note 通过 BufferPoolManager::GetAccessStrategy 创建，传给 FetchPage/PrefetchPages；
+ * 缺页时优先复用环中下一个帧，只有该帧仍被 pin 住或已被其他访问者使用时才从缓冲池中另取一个帧，
+ * 因此一次大扫描最多换出环大小的页面，不会挤掉缓冲池中的热点页面。
+ * 每个缓冲池分区有一段独立的环，由该分区的 latch 保护；同一个策略对象不能被多个线程同时使用
+ */
+class BufferAccessStrategy {
+    friend class BufferPoolManager;
+    friend class BufferPoolInstance;
+
+   private:
+    /**
+     * @brief 一个分区中的环
+     */
+    struct Ring {
+        size_t capacity;                  // 环中最多的帧数
+        std::vector<frame_id_t> frames;   // 环中的帧，未满时逐个加入
+        size_t next = 0;                  // 下一个复用的位置
+    };
+
+    std::vector<Ring> rings_;
+
+   public:
+    /**
+     * @param ring_sizes 各分区中环的帧数
+     */
+    explicit BufferAccessStrategy(const std::vector<size_t> &ring_sizes) {
+        for (size_t ring_size : ring_sizes) {
+            rings_.push_back(Ring{std::max<size_t>(1, ring_size), {}, 0});
+        }
+    }
+
+    /** @return 所有分区中环的总帧数 */
+    size_t GetRingSize() const {
+        size_t size = 0;
+        for (auto &ring : rings_) {
+            size += ring.capacity;
+        }
+        return size;
+    }
+};
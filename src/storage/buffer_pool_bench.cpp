@@ -0,0 +1,73 @@
+/**
+ * @brief 缓冲池分区的微基准：多线程随机 FetchPage/UnpinPage，对比单分区与多分区的吞吐
+ * @note 用法：buffer_pool_bench [num_instances] [num_pages] [ops_per_thread]
+ * 数据页全部装得进缓冲池，测得的主要是 latch 竞争，而不是磁盘 I/O
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer_pool_manager.h"
+
+static const std::string BENCH_FILE = "buffer_pool_bench.data";
+
+static double run(DiskManager *disk_manager, int fd, size_t num_instances, int num_pages, int num_threads,
+                  int ops_per_thread) {
+    BufferPoolManager bpm(num_pages, disk_manager, num_instances);
+    for (page_id_t page_no = 0; page_no < num_pages; page_no++) {
+        Page *page = bpm.FetchPage(PageId{fd, page_no});
+        bpm.UnpinPage(page->GetPageId(), false);
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+            for (int i = 0; i < ops_per_thread; i++) {
+                PageId page_id = {fd, dist(rng)};
+                Page *page = bpm.FetchPage(page_id);
+                if (page != nullptr) {
+                    bpm.UnpinPage(page_id, false);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(num_threads) * ops_per_thread / elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    size_t num_instances = argc > 1 ? std::stoul(argv[1]) : BUFFER_POOL_INSTANCES;
+    int num_pages = argc > 2 ? std::stoi(argv[2]) : 4096;
+    int ops_per_thread = argc > 3 ? std::stoi(argv[3]) : 200000;
+
+    DiskManager disk_manager;
+    if (disk_manager.is_file(BENCH_FILE)) {
+        disk_manager.destroy_file(BENCH_FILE);
+    }
+    disk_manager.create_file(BENCH_FILE);
+    int fd = disk_manager.open_file(BENCH_FILE);
+    std::vector<char> buf(disk_manager.get_page_size(), 0);
+    for (int i = 0; i < num_pages; i++) {
+        disk_manager.write_page(fd, disk_manager.AllocatePage(fd), buf.data(), buf.size());
+    }
+
+    printf("%8s %16s %16s\n", "threads", "1 instance", (std::to_string(num_instances) + " instances").c_str());
+    for (int num_threads = 1; num_threads <= 64; num_threads *= 2) {
+        double single = run(&disk_manager, fd, 1, num_pages, num_threads, ops_per_thread);
+        double partitioned = run(&disk_manager, fd, num_instances, num_pages, num_threads, ops_per_thread);
+        printf("%8d %13.2f M/s %13.2f M/s\n", num_threads, single / 1e6, partitioned / 1e6);
+    }
+
+    disk_manager.close_file(fd);
+    disk_manager.destroy_file(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,1012 @@
+#include "buffer_pool_instance.h"
+
+/**
+ * @brief 按 page_size_ 为所有帧（包括为扩容预留的帧）分配对齐的连续内存
+ */
+void BufferPoolInstance::AllocateFrames() {
+    frames_.Allocate(capacity_ * page_size_);
+    for (size_t i = 0; i < capacity_; ++i) {
+        pages_[i].data_ = frames_.GetData() + i * page_size_;
+    }
+}
+
+/**
+ * @brief 修改页面大小，重新分配帧内存，并同步设置 DiskManager 的页面大小
+ * @note 只能在缓冲池中没有页面时调用（如 open_db 打开数据库之前）
+ */
+void BufferPoolInstance::SetPageSize(int page_size) {
+    std::scoped_lock lock{latch_};
+    if (page_size == page_size_) {
+        disk_manager_->set_page_size(page_size);
+        return;
+    }
+    if (!page_table_.Empty()) {
+        throw InternalError("BufferPoolInstance::SetPageSize: buffer pool is not empty");
+    }
+    disk_manager_->set_page_size(page_size);
+    page_size_ = page_size;
+    AllocateFrames();
+}
+
+/**
+ * @brief 从 free_list 或 replacer 中得到可淘汰帧页的 *frame_id
+ * @param frame_id 帧页 id 指针，返回成功找到的可替换帧 id
+ * @return true: 可替换帧查找成功 , false: 可替换帧查找失败
+ * @note 不等待正在预读的帧：只剩下这些帧时返回 false，由调用者通过 WaitForPrefetch 在 latch_ 之外等待
+ */
+bool BufferPoolInstance::FindVictimPage(frame_id_t *frame_id) {
+    // Todo:
+    // 1 使用 BufferPoolInstance::free_list_判断缓冲池是否已满需要淘汰页面
+    // 1.1 未满获得 frame
+    // 1.2 已满使用 lru_replacer 中的方法选择淘汰页面
+    if (free_list_.empty()) {
+        //已满 选择淘汰页面
+        ReapPrefetches();
+        if (!free_list_.empty()) {
+            return FindVictimPage(frame_id);
+        }
+        return replacer_->Victim(frame_id);
+    } else {
+        //未满，从 free_list_ 里取得 frame_id
+        //puts("buffer is not full");
+        auto IT = free_list_.end();
+        IT--;
+        *frame_id = *IT;
+        free_list_.pop_back();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 为访问策略的环取得下一个帧：优先原地复用环中的帧，复用不了时从 FindVictimPage 另取一个帧放入环中
+ * @param ring 访问策略在本分区中的环
+ * @param frame_id 返回的帧，已不在 replacer_ 中
+ * @param replace 环已满且下一个帧不能复用时，是否从缓冲池另取一个帧代替它
+ * @return 是否取得了帧
+ * @note 环中的帧只有在仍归环所有、没有被 pin、没有正在进行的读写且预读的内容已被消费时才复用；
+ * 复用时通过 Replacer::Remove 丢弃该帧的访问历史，环上的页面不进入替换策略的历史（如 ARC 的幽灵链表）
+ */
+bool BufferPoolInstance::FindRingFrame(BufferAccessStrategy::Ring *ring, frame_id_t *frame_id, bool replace) {
+    if (ring->frames.size() < ring->capacity) {
+        if (!FindVictimPage(frame_id)) {
+            return false;
+        }
+        ring->frames.push_back(*frame_id);
+        return true;
+    }
+    frame_id_t ring_frame = ring->frames[ring->next];
+    Page *page = &pages_[ring_frame];
+    if (ring_owned_[ring_frame] && page->pin_count_ == 0 && !page->io_in_progress_ && !unreferenced_[ring_frame] &&
+        prefetching_.count(ring_frame) == 0) {
+        replacer_->Remove(ring_frame);
+        *frame_id = ring_frame;
+    } else if (replace && FindVictimPage(frame_id)) {
+        // 环中的帧仍在使用或已被其他访问者引用，把它留给缓冲池，另取一个帧代替它
+        ring->frames[ring->next] = *frame_id;
+    } else {
+        return false;
+    }
+    ring->next = (ring->next + 1) % ring->capacity;
+    return true;
+}
+
+/**
+ * @brief 更新 page 元数据 (data, is_dirty, page_id) 和 page table
+ *
+ * @param page 写回页指针
+ * @param new_page_id 写回页新 page_id
+ * @param new_frame_id 写回页新帧 frame_id
+ * @note 调用者需保证 page 不是脏页；需要写回的页面由 LoadPage 在 latch_ 之外写回
+ */
+void BufferPoolInstance::UpdatePage(Page *page, PageId new_page_id, frame_id_t new_frame_id) {
+    assert(!page->IsDirty());
+    UnmapPage(page->GetPageId(), new_frame_id);
+    page->id_ = new_page_id;
+    page->ResetMemory(page_size_);
+    ring_owned_[new_frame_id] = false;
+    if (new_page_id.page_no != INVALID_PAGE_ID) {
+        MapPage(new_page_id, new_frame_id);
+    } //else puts("CASE E");
+}
+
+/**
+ * @brief 把 victim 帧换成页面 page_id 并 pin 住，脏的旧页面写回与新页面读入都在 latch_ 之外进行
+ *
+ * 启用了压缩页面缓存时，旧页面（写回之后）压缩放入缓存，新页面先在缓存中查找，找不到再从磁盘读取；
+ * 从访问策略的环中换出的扫描页面不放入缓存，以免冲掉缓存中的热点页面
+ *
+ * 在 latch_ 下先把帧登记到页表并标记 io_in_progress_，同一页面的其他访问者在该帧上等待（WaitForIo），
+ * 被换出的旧页面在写回完成前记入 writing_back_，对它的访问等待写回完成后再从磁盘读取（WaitForWriteBack）
+ *
+ * @param frame_id FindVictimPage 得到的帧
+ * @param page_id 新页面
+ * @param read 是否从磁盘读入页面内容，NewPage 不需要读
+ * @param lock 调用时持有的 latch_，返回时仍持有
+ * @return 换入的页面；I/O 失败时抛出异常：旧页面写回失败时它留在该帧中并保持脏位，读入新页面失败时丢弃该帧
+ */
+Page *BufferPoolInstance::LoadPage(frame_id_t frame_id, PageId page_id, bool read, std::unique_lock<std::mutex> &lock) {
+    Page *page = &pages_[frame_id];
+    PageId old_id = page->id_;
+    if (old_id.page_no != INVALID_PAGE_ID && writing_back_.count(old_id) != 0) {
+        // 刷脏线程正在写回旧页面的副本，等它完成再换出：写回失败时旧页面必须还在页表中，才能被重新置脏、
+        // 由下面的写回保存；等待期间旧页面的访问者在 io_in_progress_ 上等待
+        page->io_in_progress_ = true;
+        WaitForWriteBack(old_id, lock);
+        page->io_in_progress_ = false;
+        io_cv_.notify_all();
+    }
+    bool write_back = page->is_dirty_ && old_id.page_no != INVALID_PAGE_ID;
+    bool stash = page_cache_ != nullptr && old_id.page_no != INVALID_PAGE_ID && !ring_owned_[frame_id];
+    UnmapPage(old_id, frame_id);
+    if (write_back || stash) {
+        writing_back_.insert(old_id);
+    }
+    SetDirty(frame_id, false);
+    page->id_ = page_id;
+    page->pin_count_ = 1;
+    page->io_in_progress_ = true;
+    MapPage(page_id, frame_id);
+    replacer_->Pin(frame_id);
+    replacer_->RecordLoad(frame_id, PageIdHash::Key(page_id));
+    unreferenced_[frame_id] = false;
+    ring_owned_[frame_id] = false;
+    if (write_back) {
+        dirty_evictions_++;
+        if (cleaner_cv_ != nullptr) {
+            cleaner_cv_->notify_one();
+        }
+    }
+
+    lock.unlock();
+    std::exception_ptr error;
+    bool saved = !write_back;  // 旧页面是否已写回，写回之前帧中仍是旧页面的内容
+    try {
+        if (write_back) {
+            FlushLog(page->GetPageLsn());
+            disk_manager_->write_page(old_id.fd, old_id.page_no, page->data_, page_size_);
+            saved = true;
+        }
+        if (stash) {
+            page_cache_->Insert(old_id, page->data_, page_size_);
+        }
+        if (!read) {
+            page->ResetMemory(page_size_);
+            if (page_cache_ != nullptr) {
+                // 新页面可能复用了已释放的页面编号，缓存中旧页面的副本已经过时
+                page_cache_->Erase(page_id);
+            }
+        } else if (page_cache_ == nullptr || !page_cache_->Lookup(page_id, page->data_, page_size_)) {
+            page->ResetMemory(page_size_);
+            disk_manager_->read_page(page_id.fd, page_id.page_no, page->data_, page_size_);
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+
+    if (write_back || stash) {
+        writing_back_.erase(writing_back_.find(old_id));
+    }
+    page->io_in_progress_ = false;
+    if (error && !saved) {
+        // 脏的旧页面没能写回，把它放回帧中，等待新页面的访问者重新查页表后另找帧换入
+        UnmapPage(page_id, frame_id);
+        page->id_ = old_id;
+        page->pin_count_ = 0;
+        MapPage(old_id, frame_id);
+        SetDirty(frame_id, true);
+        replacer_->Remove(frame_id);
+        replacer_->Pin(frame_id);
+        replacer_->RecordLoad(frame_id, PageIdHash::Key(old_id));
+        SetEvictable(frame_id);
+    } else if (error) {
+        UnmapPage(page_id, frame_id);
+        page->id_.page_no = INVALID_PAGE_ID;
+        page->pin_count_ = 0;
+        replacer_->Remove(frame_id);
+        ReleaseFrame(frame_id);
+    }
+    io_cv_.notify_all();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return page;
+}
+
+/**
+ * @brief 帧上有正在进行的读写（LoadPage 或预读）时，释放 latch_ 等待其完成
+ * @return 是否发生了等待；等待期间帧可能已被换出，调用者需重新查页表
+ */
+bool BufferPoolInstance::WaitForIo(frame_id_t frame_id, std::unique_lock<std::mutex> &lock) {
+    auto it = prefetching_.find(frame_id);
+    if (it != prefetching_.end()) {
+        IoRequestPtr request = it->second;
+        lock.unlock();
+        try {
+            request->Wait();
+        } catch (UnixError &) {
+            // 由 CompletePrefetch 丢弃页面
+        }
+        lock.lock();
+        it = prefetching_.find(frame_id);
+        if (it != prefetching_.end() && it->second == request) {
+            CompletePrefetch(frame_id, true);
+        }
+        return true;
+    }
+    Page *page = &pages_[frame_id];
+    if (page->io_in_progress_) {
+        io_cv_.wait(lock, [page] { return !page->io_in_progress_; });
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 页面正在从某个帧写回磁盘时，释放 latch_ 等待写回完成，之后才能从磁盘读取它
+ */
+void BufferPoolInstance::WaitForWriteBack(PageId page_id, std::unique_lock<std::mutex> &lock) {
+    io_cv_.wait(lock, [this, page_id] { return writing_back_.count(page_id) == 0; });
+}
+
+/**
+ * @brief 没有可淘汰的帧但有正在预读的帧时，释放 latch_ 等待其中一个预读完成
+ * @return 是否发生了等待；没有正在预读的帧时返回 false
+ */
+bool BufferPoolInstance::WaitForPrefetch(std::unique_lock<std::mutex> &lock) {
+    if (prefetching_.empty()) {
+        return false;
+    }
+    WaitForIo(prefetching_.begin()->first, lock);
+    return true;
+}
+
+/**
+ * Fetch the requested page from the buffer pool.
+ * 如果页表中存在 page_id（说明该 page 在缓冲池中），并且 pin_count++。
+ * 如果页表不存在 page_id（说明该 page 在磁盘中），则找缓冲池 victim page，将其替换为磁盘中读取的 page，pin_count 置 1。
+ * @param page_id id of page to be fetched
+ * @param ring 访问策略在本分区中的环，为 nullptr 时使用缓冲池的替换策略
+ * @return the requested page
+ * @note 缺页时的磁盘读写不持有 latch_，命中不会被其他页面的缺页阻塞；同一页面的并发访问者只在该帧上等待；
+ * 通过环访问时，命中环自己的帧不计入替换策略的访问历史，缺页时在环中换入
+ */
+Page *BufferPoolInstance::FetchPage(PageId page_id, BufferAccessStrategy::Ring *ring) {
+    // Todo:
+    // 0.     lock latch
+    // 1.     Search the page table for the requested page (P).
+    // 1.1    If P exists, pin it and return it immediately.
+    // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+    //        Note that pages are always found from the free list first.
+    // 2.     If R is dirty, write it back to the disk.
+    // 3.     Delete R from the page table and insert P.
+    // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+    std::unique_lock lock{latch_};
+    while (true) {
+        frame_id_t frame_id;
+        if (page_table_.Find(page_id, &frame_id)) {
+            if (WaitForIo(frame_id, lock)) {
+                continue;
+            }
+            replacer_->Pin(frame_id);   // 在缓冲池中
+            if (ring != nullptr && ring_owned_[frame_id]) {
+                unreferenced_[frame_id] = false;
+            } else if (unreferenced_[frame_id]) {
+                // 预读的页面第一次被访问
+                unreferenced_[frame_id] = false;
+                replacer_->RecordLoad(frame_id, PageIdHash::Key(page_id));
+            } else {
+                replacer_->RecordAccess(frame_id);
+            }
+            if (ring == nullptr) {
+                ring_owned_[frame_id] = false;
+            }
+            pages_[frame_id].pin_count_++;
+            hits_++;
+            return &pages_[frame_id];
+        }
+        if (writing_back_.count(page_id) != 0) {
+            // 页面刚被换出、还在写回，等写回完成后再从磁盘读取
+            WaitForWriteBack(page_id, lock);
+            continue;
+        }
+        frame_id_t victim_id;
+        if (ring != nullptr && FindRingFrame(ring, &victim_id, true)) {
+            misses_++;
+            Page *page = LoadPage(victim_id, page_id, true, lock);
+            ring_owned_[victim_id] = true;
+            return page;
+        }
+        if (ring == nullptr && FindVictimPage(&victim_id)) { //找出一个可用的 frameid
+            misses_++;
+            return LoadPage(victim_id, page_id, true, lock);
+        }
+        if (!WaitForPrefetch(lock)) {
+            return nullptr;
+        }
+    }
+}
+
+/**
+ * Unpin the target page from the buffer pool. 取消固定 pin_count>0 的在缓冲池中的 page
+ * @param page_id id of page to be unpinned
+ * @param is_dirty true if the page should be marked as dirty, false otherwise
+ * @return false if the page pin count is <= 0 before this call, true otherwise
+ */
+bool BufferPoolInstance::UnpinPage(PageId page_id, bool is_dirty) {
+    // Todo:
+    // 0. lock latch
+    // 1. try to search page_id page P in page_table_
+    // 1.1 P 在页表中不存在 return false
+    // 1.2 P 在页表中存在 如何解除一次固定 (pin_count)
+    // 2. 页面是否需要置脏
+    std :: scoped_lock lock{latch_};
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, &frame_id)) {
+        return UnpinFrameLocked(frame_id, is_dirty);
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @brief 按帧号 unpin 页面：持有 pin 的 page guard 已经知道帧号，省去一次页表查找
+ * @param frame_id 页面所在的帧
+ * @param is_dirty 页面是否需要置脏
+ * @return false if the page pin count is <= 0 before this call, true otherwise
+ */
+bool BufferPoolInstance::UnpinFrame(frame_id_t frame_id, bool is_dirty) {
+    std::scoped_lock lock{latch_};
+    return UnpinFrameLocked(frame_id, is_dirty);
+}
+
+/**
+ * @brief 解除帧的一次固定，调用者需持有 latch_
+ */
+bool BufferPoolInstance::UnpinFrameLocked(frame_id_t frame_id, bool is_dirty) {
+    Page &page = pages_[frame_id];
+    if (page.pin_count_ <= 0) {
+        return false;
+    }
+    page.pin_count_--;
+    if (is_dirty) {
+        SetDirty(frame_id, true);
+    }
+    if (page.pin_count_ == 0) {
+        SetEvictable(frame_id);
+    }
+    return true;
+}
+
+/**
+ * Flushes the target page to disk. 将 page 写入磁盘；不考虑 pin_count
+ * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+ * @return false if the page could not be found in the page table, true otherwise
+ * @note 写回期间 pin 住页面防止被换出，但不持有 latch_
+ */
+bool BufferPoolInstance::FlushPage(PageId page_id) {
+    // Todo:
+    // 0. lock latch
+    // 1. 页表查找
+    // 2. 存在时如何写回磁盘
+    // 3. 写回后页面的脏位
+    // Make sure you call DiskManager::WritePage!
+    std::unique_lock lock{latch_};
+    if (page_id.page_no == INVALID_PAGE_ID) return false;
+    frame_id_t frame_id;
+    while (true) {
+        if (!page_table_.Find(page_id, &frame_id)) {
+            return false;
+        }
+        if (WaitForIo(frame_id, lock)) {
+            continue;
+        }
+        if (writing_back_.count(page_id) == 0) {
+            break;
+        }
+        // 刷脏线程正在写回该页面更早的副本
+        WaitForWriteBack(page_id, lock);
+    }
+    Page *page = &pages_[frame_id];
+    replacer_->Pin(frame_id);
+    page->pin_count_++;
+    SetDirty(frame_id, false);
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+        FlushLog(page->GetPageLsn());
+        disk_manager_->write_page(page_id.fd, page_id.page_no, page->GetData(), page_size_);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+    if (error) {
+        SetDirty(frame_id, true);
+    }
+    if (--page->pin_count_ == 0) {
+        SetEvictable(frame_id);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return true;
+}
+
+/**
+ * Creates a new page in the buffer pool. 相当于从磁盘中移动一个新建的空 page 到缓冲池某个位置
+ * @param page_id id of created page
+ * @return nullptr if no new pages could be created, otherwise pointer to new page
+ */
+Page *BufferPoolInstance::NewPage(PageId page_id) {
+    // Todo:
+    // 0.   lock latch
+    // 1.   page_no 已由 BufferPoolManager 调用 DiskManager::AllocatePage 分配
+    // 2.   If all the pages in the buffer pool are pinned, return nullptr.
+    // 3.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+    // 4.   Update P's metadata, zero out memory and add P to the page table. pin_count set to 1.
+    // 5.   Set the page ID output parameter. Return a pointer to P.
+    std::unique_lock lock{latch_};
+    while (true) {
+        frame_id_t frame_id;
+        if (page_table_.Find(page_id, &frame_id)) {
+            if (WaitForIo(frame_id, lock)) {
+                continue;
+            }
+            // 复用了一个已释放的页面，而该页面旧的帧仍在缓冲池中：直接在原帧上重新初始化，避免同一页面占用两个帧
+            pages_[frame_id].ResetMemory(page_size_);
+            replacer_->Pin(frame_id);
+            replacer_->RecordLoad(frame_id, PageIdHash::Key(page_id));
+            unreferenced_[frame_id] = false;
+            pages_[frame_id].pin_count_++;
+            return &pages_[frame_id];
+        }
+        if (writing_back_.count(page_id) != 0) {
+            // 复用已释放的页面时，它旧的内容可能还在写回，必须等写回完成，否则旧内容会覆盖新页面
+            WaitForWriteBack(page_id, lock);
+            continue;
+        }
+        if (FindVictimPage(&frame_id)) {
+            return LoadPage(frame_id, page_id, false, lock);
+        }
+        if (!WaitForPrefetch(lock)) {
+            return nullptr;
+        }
+    }
+}
+
+
+/**
+ * @brief Deletes a page from the buffer pool.
+ * @param page_id id of page to be deleted
+ * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+ */
+bool BufferPoolInstance::DeletePage(PageId page_id) {
+    // Todo:
+    // 0.   lock latch
+    // 1.   Make sure you call DiskManager::DeallocatePage!
+    // 2.   Search the page table for the requested page (P).
+    // 2.1  If P does not exist, return true.
+    // 2.2  If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+    // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free
+    // list.
+    std::unique_lock lock{latch_};
+    while (true) {
+        frame_id_t frame_id;
+        if (!page_table_.Find(page_id, &frame_id)) {
+            disk_manager_->DeallocatePage(page_id.fd, page_id.page_no);
+            if (page_cache_ != nullptr) {
+                page_cache_->Erase(page_id);
+            }
+            return true;
+        }
+        if (WaitForIo(frame_id, lock)) {
+            continue;
+        }
+        if (pages_[frame_id].pin_count_ != 0) return false;
+        disk_manager_->DeallocatePage(page_id.fd, page_id.page_no);
+        PageId invalid_id = {page_id.fd, INVALID_PAGE_ID};
+        SetDirty(frame_id, false);  // 页面已被释放，不需要写回
+        UpdatePage(&pages_[frame_id], invalid_id, frame_id);
+        replacer_->Remove(frame_id);  // 从 replacer 中移除，该帧只能再从 free_list_ 中取得
+        ReleaseFrame(frame_id);
+        return true;
+    }
+}
+
+
+/**
+ * @brief 等待文件 fd 在分区中的预读、换入和写回全部完成
+ *
+ * @param fd 指定的 diskfile open 句柄
+ * @param lock 调用时持有的 latch_，等待时暂时释放
+ */
+void BufferPoolInstance::WaitForFileIo(int fd, std::unique_lock<std::mutex> &lock) {
+    std::vector<frame_id_t> frames;
+    bool waited = true;
+    while (waited) {
+        waited = false;
+        // 正在读写的帧都已登记在页表中，只需检查该文件驻留的帧；等待期间链表可能变化，每次等待后重新收集
+        frames.clear();
+        resident_frames_.Collect(fd, &frames);
+        for (size_t i = 0; i < frames.size() && !waited; i++) {
+            waited = WaitForIo(frames[i], lock);
+        }
+        for (auto it = writing_back_.begin(); it != writing_back_.end() && !waited; ++it) {
+            if (it->fd == fd) {
+                WaitForWriteBack(*it, lock);
+                waited = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 等待文件 fd 在分区中的读写全部完成，收集并 pin 住该文件在分区中的脏页，
+ * 供 BufferPoolManager::FlushAllPages 在 latch_ 之外合并写回
+ *
+ * @param fd 指定的 diskfile open 句柄
+ * @param[out] pages 该文件在分区中的脏页，已清除脏位，写回后需逐个 UnpinPage
+ * @param lock 调用时持有的 latch_，等待时暂时释放
+ * @note 只访问该文件的脏页链表，与分区的帧数无关
+ */
+void BufferPoolInstance::CollectPages(int fd, std::vector<Page *> *pages, std::unique_lock<std::mutex> &lock) {
+    // 文件关闭前必须等待它的预读、换入和写回全部完成
+    WaitForFileIo(fd, lock);
+    std::vector<frame_id_t> frames;
+    dirty_frames_.Collect(fd, &frames);
+    for (frame_id_t frame_id : frames) {
+        Page *page = &pages_[frame_id];
+        replacer_->Pin(frame_id);
+        page->pin_count_++;
+        SetDirty(frame_id, false);
+        pages->push_back(page);
+    }
+}
+
+/**
+ * @brief 文件在缓冲池中是否还有比磁盘上更新的页面
+ *
+ * @param fd 指定的 diskfile open 句柄
+ */
+bool BufferPoolInstance::HasUnflushedPages(int fd) {
+    std::scoped_lock lock{latch_};
+    if (dirty_frames_.Size(fd) > 0) {
+        return true;
+    }
+    std::vector<frame_id_t> frames;
+    resident_frames_.Collect(fd, &frames);
+    for (frame_id_t frame_id : frames) {
+        if (pages_[frame_id].pin_count_ > 0) {
+            return true;
+        }
+    }
+    for (auto &page_id : writing_back_) {
+        if (page_id.fd == fd) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t BufferPoolInstance::CountPinnedPages(int fd) {
+    std::unique_lock lock{latch_};
+    WaitForFileIo(fd, lock);
+    std::vector<frame_id_t> frames;
+    resident_frames_.Collect(fd, &frames);
+    size_t pinned = 0;
+    for (frame_id_t frame_id : frames) {
+        if (pages_[frame_id].pin_count_ > 0) {
+            pinned++;
+        }
+    }
+    return pinned;
+}
+
+/**
+ * @brief 把文件 fd 驻留在分区中的页面移出缓冲池，帧归还 free_list_
+ *
+ * @param fd 指定的 diskfile open 句柄
+ * @param write_back 是否先写回脏页：SetFilePool 移动文件时，FlushAllPages 之后又被修改的页面不能丢
+ * @return 仍被 pin 住、没有移出的页面数
+ * @note 文件关闭后操作系统会把同一个 fd 分配给之后打开的文件，留在缓冲池中的旧页面会被误当作新文件的页面；
+ * 写回在 latch_ 下进行，期间分区的其他访问等待，只用于很少发生的移动文件
+ */
+size_t BufferPoolInstance::DiscardPages(int fd, bool write_back) {
+    std::unique_lock lock{latch_};
+    WaitForFileIo(fd, lock);
+    std::vector<frame_id_t> frames;
+    resident_frames_.Collect(fd, &frames);
+    size_t pinned = 0;
+    for (frame_id_t frame_id : frames) {
+        Page *page = &pages_[frame_id];
+        if (page->pin_count_ > 0) {
+            pinned++;
+            continue;
+        }
+        if (write_back && page->is_dirty_) {
+            FlushLog(page->GetPageLsn());
+            disk_manager_->write_page(page->id_.fd, page->id_.page_no, page->data_, page_size_);
+        }
+        SetDirty(frame_id, false);
+        UnmapPage(page->id_, frame_id);
+        page->id_.page_no = INVALID_PAGE_ID;
+        replacer_->Remove(frame_id);
+        unreferenced_[frame_id] = false;
+        ring_owned_[frame_id] = false;
+        ReleaseFrame(frame_id);
+    }
+    return pinned;
+}
+
+/**
+ * @brief 异步预读页面，预读的页面 pin_count 为 0，读完成后才进入 replacer
+ *
+ * @param fd 指定的 diskfile open 句柄
+ * @param page_nos 预读的页面
+ * @param ring 访问策略在本分区中的环，为 nullptr 时使用空闲帧或可淘汰的帧
+ * @note 换出的页面在 latch_ 下压缩放入压缩页面缓存
+ */
+void BufferPoolInstance::PrefetchPages(int fd, const std::vector<page_id_t> &page_nos,
+                                       BufferAccessStrategy::Ring *ring) {
+    std::scoped_lock lock{latch_};
+    ReapPrefetches();
+    std::vector<IoRequestPtr> requests;
+    for (page_id_t page_no : page_nos) {
+        PageId page_id = {fd, page_no};
+        // 在压缩页面缓存中的页面缺页时直接解压，不需要预读
+        if (page_table_.Contains(page_id) || writing_back_.count(page_id) ||
+            (page_cache_ != nullptr && page_cache_->Contains(page_id))) {
+            continue;
+        }
+        // 预读不能等待其他帧，也不能占满缓冲池
+        if (prefetching_.size() >= pool_size_ / 4 || (free_list_.empty() && replacer_->Size() == 0)) {
+            break;
+        }
+        frame_id_t frame_id;
+        // 通过环预读时不超出环的大小，还没被消费的预读页面不会被后面的预读覆盖
+        if (ring != nullptr ? !FindRingFrame(ring, &frame_id, false) : !FindVictimPage(&frame_id)) {
+            break;
+        }
+        if (pages_[frame_id].IsDirty() || writing_back_.count(pages_[frame_id].id_) != 0) {
+            // 预读不做同步写回，也不等待刷脏线程的写回，把该帧还给 replacer 后停止预读
+            replacer_->Unpin(frame_id);
+            break;
+        }
+        PageId old_id = pages_[frame_id].id_;
+        if (page_cache_ != nullptr && old_id.page_no != INVALID_PAGE_ID && !ring_owned_[frame_id]) {
+            page_cache_->Insert(old_id, pages_[frame_id].data_, page_size_);
+        }
+        UpdatePage(&pages_[frame_id], page_id, frame_id);
+        replacer_->Remove(frame_id);
+        unreferenced_[frame_id] = true;
+        ring_owned_[frame_id] = ring != nullptr;
+        pages_[frame_id].pin_count_ = 0;
+        requests.push_back(disk_manager_->make_io_request(IoOp::READ, fd, page_no, pages_[frame_id].data_, page_size_));
+        prefetching_[frame_id] = requests.back();
+    }
+    if (!requests.empty()) {
+        disk_manager_->submit_io(requests);
+    }
+}
+
+/**
+ * @brief 完成帧上的预读：读成功后页面进入 replacer（未被 pin 时），读失败则丢弃页面
+ *
+ * @param frame_id 帧 id，不在预读的帧直接返回 true
+ * @param wait 为 false 时读未完成直接返回
+ * @return 页面是否仍在缓冲池中
+ */
+bool BufferPoolInstance::CompletePrefetch(frame_id_t frame_id, bool wait) {
+    auto it = prefetching_.find(frame_id);
+    if (it == prefetching_.end()) {
+        return true;
+    }
+    IoRequestPtr request = it->second;
+    if (!wait && !request->IsDone()) {
+        return true;
+    }
+    prefetching_.erase(it);
+    Page *page = &pages_[frame_id];
+    try {
+        request->Wait();  // 越过文件末尾的部分保持为 0
+    } catch (UnixError &) {
+        UnmapPage(page->id_, frame_id);
+        page->id_.page_no = INVALID_PAGE_ID;
+        replacer_->Remove(frame_id);
+        ReleaseFrame(frame_id);
+        return false;
+    }
+    if (page->pin_count_ == 0) {
+        SetEvictable(frame_id);
+    }
+    return true;
+}
+
+/**
+ * @brief 回收已经完成的预读，使这些帧可以被淘汰
+ */
+void BufferPoolInstance::ReapPrefetches() {
+    std::vector<frame_id_t> done;
+    for (auto &entry : prefetching_) {
+        if (entry.second->IsDone()) {
+            done.push_back(entry.first);
+        }
+    }
+    for (frame_id_t frame_id : done) {
+        CompletePrefetch(frame_id, false);
+    }
+}
+
+/**
+ * @brief 在线修改分区的帧数
+ *
+ * 缩小时先把 pool_size_ 改为新的大小，使多出的帧不再被分配：它们退出 free_list_，已在 replacer_ 中的退出 replacer_，
+ * 之后 unpin 或预读完成时也不再进入 replacer_（见 SetEvictable）。然后从后往前逐个退役这些帧，只等待该帧上的
+ * pin 和读写，其他帧照常使用；退役帧的内存还给操作系统
+ *
+ * @param pool_size 新的帧数，在 [1, capacity_] 之间
+ */
+void BufferPoolInstance::Resize(size_t pool_size) {
+    if (pool_size == 0 || pool_size > capacity_) {
+        throw InvalidPoolSizeError(pool_size);
+    }
+    std::unique_lock lock{latch_};
+    size_t old_size = pool_size_;
+    if (pool_size >= old_size) {
+        // 退役的帧都已移出缓冲池，直接启用
+        pool_size_ = pool_size;
+        replacer_->SetCapacity(pool_size);
+        for (size_t i = old_size; i < pool_size; i++) {
+            free_list_.push_back(static_cast<frame_id_t>(i));
+        }
+        return;
+    }
+
+    pool_size_ = pool_size;
+    free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+    for (size_t i = pool_size; i < old_size; i++) {
+        replacer_->Pin(static_cast<frame_id_t>(i));
+        ring_owned_[i] = false;
+    }
+    replacer_->SetCapacity(pool_size);
+    // [retired, old_size) 中的帧已经退役
+    size_t retired = old_size;
+    try {
+        for (; retired > pool_size; retired--) {
+            RetireFrame(static_cast<frame_id_t>(retired - 1), lock);
+        }
+    } catch (...) {
+        // 写回失败：还没退役的帧 [pool_size, retired) 重新启用，分区停在 retired 的大小
+        pool_size_ = retired;
+        replacer_->SetCapacity(retired);
+        for (size_t i = pool_size; i < retired; i++) {
+            Page *page = &pages_[i];
+            if (page->pin_count_ > 0 || page->io_in_progress_ || prefetching_.count(i) != 0) {
+                continue;  // unpin 或读写完成时再进入 free_list_ 或 replacer_
+            }
+            if (page->id_.page_no == INVALID_PAGE_ID) {
+                free_list_.push_back(static_cast<frame_id_t>(i));
+            } else {
+                replacer_->Unpin(static_cast<frame_id_t>(i));
+            }
+        }
+        frames_.Discard(retired * page_size_, (old_size - retired) * page_size_);
+        throw;
+    }
+    frames_.Discard(pool_size * page_size_, (old_size - pool_size) * page_size_);
+}
+
+/**
+ * @brief 等待退役帧上的 pin 和读写结束，写回脏页后把页面移出缓冲池，调用者需持有 latch_
+ * @note 写回时 pin 住页面、在 latch_ 之外进行，期间页面仍可被访问和修改，修改后重新写回；
+ * 写回失败时页面恢复为脏页并抛出异常
+ */
+void BufferPoolInstance::RetireFrame(frame_id_t frame_id, std::unique_lock<std::mutex> &lock) {
+    Page *page = &pages_[frame_id];
+    while (true) {
+        if (WaitForIo(frame_id, lock)) {
+            continue;
+        }
+        if (page->pin_count_ > 0) {
+            // 退役帧的 pin 全部解除时 SetEvictable 会唤醒这里
+            io_cv_.wait(lock, [page] { return page->pin_count_ == 0; });
+            continue;
+        }
+        if (page->id_.page_no == INVALID_PAGE_ID) {
+            break;
+        }
+        PageId page_id = page->id_;
+        if (writing_back_.count(page_id) != 0) {
+            // 刷脏线程正在写回该页面的副本，写回失败时页面会被重新置脏
+            WaitForWriteBack(page_id, lock);
+            continue;
+        }
+        if (!page->is_dirty_) {
+            break;
+        }
+        page->pin_count_++;
+        SetDirty(frame_id, false);
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            FlushLog(page->GetPageLsn());
+            disk_manager_->write_page(page_id.fd, page_id.page_no, page->data_, page_size_);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        page->pin_count_--;
+        if (error) {
+            SetDirty(frame_id, true);
+            std::rethrow_exception(error);
+        }
+    }
+    SetDirty(frame_id, false);
+    UnmapPage(page->id_, frame_id);
+    page->id_.page_no = INVALID_PAGE_ID;
+    replacer_->Remove(frame_id);
+    unreferenced_[frame_id] = false;
+    ring_owned_[frame_id] = false;
+}
+
+bool BufferPoolInstance::IsEmpty() {
+    std::scoped_lock lock{latch_};
+    return page_table_.Empty();
+}
+
+size_t BufferPoolInstance::GetNumPages() {
+    std::scoped_lock lock{latch_};
+    return page_table_.Size();
+}
+
+void BufferPoolInstance::CollectHotPages(std::vector<PageId> *page_ids) {
+    std::scoped_lock lock{latch_};
+    std::vector<frame_id_t> victims;
+    replacer_->PeekVictims(replacer_->Size(), &victims);
+    std::vector<bool> evictable(capacity_, false);
+    for (frame_id_t frame_id : victims) {
+        evictable[frame_id] = true;
+    }
+    auto collect = [&](frame_id_t frame_id) {
+        PageId page_id = pages_[frame_id].id_;
+        frame_id_t mapped;
+        if (page_id.page_no != INVALID_PAGE_ID && page_table_.Find(page_id, &mapped) && mapped == frame_id &&
+            !unreferenced_[frame_id] && !ring_owned_[frame_id]) {
+            page_ids->push_back(page_id);
+        }
+    };
+    for (size_t i = 0; i < pool_size_; i++) {
+        if (!evictable[i]) {
+            collect(static_cast<frame_id_t>(i));
+        }
+    }
+    for (auto it = victims.rbegin(); it != victims.rend(); ++it) {
+        collect(*it);
+    }
+}
+
+void BufferPoolInstance::PrewarmPages(int fd, const std::vector<page_id_t> &page_nos,
+                                      std::vector<IoRequestPtr> *requests) {
+    std::scoped_lock lock{latch_};
+    ReapPrefetches();
+    std::vector<IoRequestPtr> submitted;
+    for (page_id_t page_no : page_nos) {
+        PageId page_id = {fd, page_no};
+        if (page_table_.Contains(page_id) || writing_back_.count(page_id) ||
+            (page_cache_ != nullptr && page_cache_->Contains(page_id))) {
+            continue;
+        }
+        if (free_list_.empty()) {
+            break;
+        }
+        frame_id_t frame_id = free_list_.back();
+        free_list_.pop_back();
+        UpdatePage(&pages_[frame_id], page_id, frame_id);
+        replacer_->Remove(frame_id);
+        unreferenced_[frame_id] = true;
+        pages_[frame_id].pin_count_ = 0;
+        submitted.push_back(disk_manager_->make_io_request(IoOp::READ, fd, page_no, pages_[frame_id].data_, page_size_));
+        prefetching_[frame_id] = submitted.back();
+    }
+    if (!submitted.empty()) {
+        disk_manager_->submit_io(submitted);
+        requests->insert(requests->end(), submitted.begin(), submitted.end());
+    }
+}
+
+/**
+ * @brief 后台刷脏：在 latch_ 下复制替换策略接下来要淘汰的帧中的脏页并清除脏位，在 latch_ 之外按页号合并写回
+ *
+ * 只看 Replacer::PeekVictims 列出的前若干个帧，使空闲帧与这些帧合计达到分区的 PAGE_CLEANER_CLEAN_PERCENT%，
+ * 不改变替换策略的状态；写回的是页面副本，期间页面仍可被访问和修改，修改后重新置脏。
+ * 写回期间页面记入 writing_back_：换出页面、再次写回同一页面都要等它完成，写回失败（包括日志刷盘失败）时页面重新置脏
+ *
+ * @param max_pages 最多写回的页面数
+ * @return 写回成功的页面数
+ */
+size_t BufferPoolInstance::CleanPages(size_t max_pages) {
+    std::vector<PageId> page_ids;
+    lsn_t max_lsn = INVALID_LSN;
+    {
+        std::scoped_lock lock{latch_};
+        size_t target = std::max<size_t>(1, pool_size_ * PAGE_CLEANER_CLEAN_PERCENT / 100);
+        if (free_list_.size() >= target) {
+            return 0;
+        }
+        std::vector<frame_id_t> candidates;
+        replacer_->PeekVictims(target - free_list_.size(), &candidates);
+        clean_buffer_.resize(max_pages * page_size_);
+        for (frame_id_t frame_id : candidates) {
+            Page *page = &pages_[frame_id];
+            if (page_ids.size() == max_pages) {
+                break;
+            }
+            if (!page->is_dirty_ || page->pin_count_ > 0 || page->io_in_progress_ ||
+                page->id_.page_no == INVALID_PAGE_ID || prefetching_.count(frame_id) != 0 ||
+                writing_back_.count(page->id_) != 0) {
+                continue;
+            }
+            memcpy(clean_buffer_.data() + page_ids.size() * page_size_, page->data_, page_size_);
+            max_lsn = std::max(max_lsn, page->GetPageLsn());
+            SetDirty(frame_id, false);
+            writing_back_.insert(page->id_);
+            page_ids.push_back(page->id_);
+        }
+    }
+    if (page_ids.empty()) {
+        return 0;
+    }
+
+    // 按 (fd, page_no) 排序，编号连续的页面合并为一次写
+    std::vector<size_t> order(page_ids.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::make_pair(page_ids[a].fd, page_ids[a].page_no) < std::make_pair(page_ids[b].fd, page_ids[b].page_no);
+    });
+    std::vector<bool> failed(page_ids.size(), false);
+    size_t written = 0;
+    try {
+        FlushLog(max_lsn);
+    } catch (RedBaseError &e) {
+        // 日志没有持久化，不能写回任何页面，全部按写回失败处理
+        LOG_WARN("page cleaner failed to flush the log: %s", e.what());
+        failed.assign(page_ids.size(), true);
+        order.clear();
+    }
+    std::vector<const char *> run;
+    for (size_t i = 0; i < order.size(); i++) {
+        PageId page_id = page_ids[order[i]];
+        run.push_back(clean_buffer_.data() + order[i] * page_size_);
+        bool run_end = i + 1 == order.size() || page_ids[order[i + 1]].fd != page_id.fd ||
+                       page_ids[order[i + 1]].page_no != page_id.page_no + 1;
+        if (!run_end) {
+            continue;
+        }
+        size_t start = i + 1 - run.size();
+        try {
+            disk_manager_->write_pages(page_id.fd, page_ids[order[start]].page_no, run.data(), run.size());
+            written += run.size();
+        } catch (RedBaseError &e) {
+            LOG_WARN("page cleaner failed to write fd %d: %s", page_id.fd, e.what());
+            for (size_t j = start; j <= i; j++) {
+                failed[order[j]] = true;
+            }
+        }
+        run.clear();
+    }
+
+    std::scoped_lock lock{latch_};
+    for (size_t i = 0; i < page_ids.size(); i++) {
+        writing_back_.erase(writing_back_.find(page_ids[i]));
+        // 写回期间页面不会被换出（见 LoadPage），只有被删除或随文件关闭丢弃时才不在页表中
+        frame_id_t frame_id;
+        if (failed[i] && page_table_.Find(page_ids[i], &frame_id)) {
+            SetDirty(frame_id, true);
+        }
+    }
+    io_cv_.notify_all();
+    return written;
+}
@@ -0,0 +1,408 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// buffer_pool_instance.h
+//
+// Identification: src/storage/buffer_pool_instance.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer_access_strategy.h"
+#include "common/logger.h"  // for debug
+#include "compressed_page_cache.h"
+#include "disk_manager.h"
+#include "errors.h"
+#include "file_frame_list.h"
+#include "frame_arena.h"
+#include "page.h"
+#include "page_table.h"
+#include "replacer/replacer.h"
+
+/**
+ * @brief 缓冲池的一个分区，拥有独立的帧、页表、空闲链表、替换策略和 latch
+ * @note 由 BufferPoolManager 按 PageId 的哈希值选择分区，不直接对上层暴露
+ */
+class BufferPoolInstance {
+    friend class BufferPoolManager;
+
+   private:
+    /**
+     * @brief Number of pages in the buffer pool.
+     * @note 正在使用的帧为 [0, pool_size_)，可由 Resize 在线修改；[pool_size_, capacity_) 中的帧已退役或正在退役，
+     * 不在 free_list_ 和 replacer_ 中，不会再被分配
+     */
+    std::atomic<size_t> pool_size_;
+    /**
+     * @brief 预留的帧数，pool_size_ 的上限；帧描述符、页表、替换策略和帧内存都按它一次分配好，扩容时不需要移动
+     */
+    size_t capacity_;
+    /**
+     * @brief BufferPool中的Page对象数组(指针)
+     * @note 在构造函数中申请内存空间,折构函数中释放,大小为 capacity_
+     */
+    Page *pages_;
+    /**
+     * @brief 所有帧页数据所在的连续内存，按 DIRECT_IO_ALIGNMENT 对齐，以便直接用于 O_DIRECT 读写
+     * @note 与 pages_ 中的帧描述符分开存放，换页和 pin/unpin 只访问紧凑的描述符数组；内存足够大时由大页支撑
+     */
+    FrameArena frames_;
+    /**
+     * @brief 页面大小，与 DiskManager 保持一致
+     */
+    int page_size_;
+    /**
+     * @brief 以自定义PageIdHash为哈希函数的<PageId,frame_id_t>哈希表.
+     * @note 用于根据PageId定位其在BufferPool中的frame_id_t；定长开放寻址，按 pool_size_ 分配
+     */
+    PageTable page_table_;
+    /**
+     * @brief BufferPool空闲帧的id构成的链表
+     */
+    std::list<frame_id_t> free_list_;
+    /**
+     * @brief 每个文件驻留在分区中的帧，即页表中的页面按文件分组
+     * @note 整文件的刷盘、关闭只需访问该文件的页面，不必扫描全部帧
+     */
+    FileFrameList resident_frames_;
+    /**
+     * @brief 每个文件的脏页所在的帧，与 Page::is_dirty_ 同步，由 SetDirty 维护
+     */
+    FileFrameList dirty_frames_;
+    /** 上层传入disk_manager */
+    DiskManager *disk_manager_;
+
+    /**
+     * @brief BufferPool页面替换策略类
+     *
+     */
+    std::unique_ptr<Replacer> replacer_;
+
+    /**
+     * @brief 正在预读的帧及其异步读请求
+     * @note 这些帧已经在 page_table_ 中，但在读完成之前不在 replacer_ 中，不会被淘汰；
+     * 访问这些页面前需要先调用 CompletePrefetch() 等待读完成
+     */
+    std::unordered_map<frame_id_t, IoRequestPtr> prefetching_;
+
+    /**
+     * @brief 预读进来、还没有被 FetchPage 访问过的帧
+     * @note 这些页面第一次被访问时才通过 Replacer::RecordLoad 告诉 replacer，预读本身不算一次访问
+     */
+    std::vector<bool> unreferenced_;
+
+    /**
+     * @brief 由某个 BufferAccessStrategy 的环换入、之后没有被环外访问过的帧
+     * @note 只有这样的帧才会被环原地复用；环外的 FetchPage 命中或帧被换成其他页面时清除
+     */
+    std::vector<bool> ring_owned_;
+
+    /**
+     * @brief 正在 latch_ 之外写回磁盘的页面：已被换出的脏页，或后台刷脏线程正在写回的页面副本
+     * @note 写回完成前不能从磁盘读取这些页面；同一页面可能同时有两次写回（刷脏线程写回期间页面又被改脏并换出），
+     * 后一次写回要等前一次完成后再写，保证磁盘上留下的是最新的内容
+     */
+    std::unordered_multiset<PageId, PageIdHash> writing_back_;
+
+    /** This latch protects shared data structures */
+    std::mutex latch_;
+
+    /**
+     * @brief 帧上的换入（Page::io_in_progress_）或 writing_back_ 中的写回完成、退役帧的 pin 全部解除时通知等待者，
+     * 与 latch_ 配合使用
+     */
+    std::condition_variable io_cv_;
+
+    /**
+     * @brief WAL 规则：写回页面前调用，返回时日志需已持久化到参数给出的页面 LSN；未开启日志时为空
+     */
+    std::function<void(lsn_t)> flush_log_;
+
+    /**
+     * @brief 各分区共用的压缩页面缓存，由 BufferPoolManager::EnablePageCache 设置，未启用时为 nullptr
+     * @note 换出的页面放入其中，缺页时先在其中查找再读磁盘；页面在换出、放入的过程中记入 writing_back_，
+     * 对它的访问等放入完成后再查找，页面不会同时出现在缓冲池和压缩缓存中
+     */
+    CompressedPageCache *page_cache_ = nullptr;
+
+    /**
+     * @brief 前台换出脏页时用来唤醒后台刷脏线程，未启动刷脏线程时为 nullptr
+     */
+    std::condition_variable *cleaner_cv_ = nullptr;
+
+    /**
+     * @brief 前台 FetchPage/NewPage 换出脏页、不得不同步写回的次数
+     */
+    std::atomic<size_t> dirty_evictions_{0};
+
+    /**
+     * @brief FetchPage 命中与缺页（需要换入）的次数
+     */
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    /**
+     * @brief 后台刷脏线程复制页面内容用的缓冲区
+     */
+    std::vector<char> clean_buffer_;
+
+   public:
+    /**
+     * @param replacer_type 替换策略的名称，见 Replacer::Create
+     * @param capacity 预留的帧数，Resize 的上限，不小于 pool_size；为 0 时等于 pool_size
+     */
+    BufferPoolInstance(size_t pool_size, DiskManager *disk_manager, const std::string &replacer_type,
+                       size_t capacity = 0)
+        : pool_size_(pool_size),
+          capacity_(std::max(pool_size, capacity)),
+          page_size_(disk_manager->get_page_size()),
+          page_table_(capacity_),
+          resident_frames_(capacity_),
+          dirty_frames_(capacity_),
+          disk_manager_(disk_manager),
+          replacer_(Replacer::Create(replacer_type, capacity_)) {
+        // replacer_ 为全部预留的帧分配状态，但只按使用中的帧数计算容量
+        replacer_->SetCapacity(pool_size_);
+        // We allocate a consecutive memory space for the buffer pool.
+        pages_ = new Page[capacity_];
+        AllocateFrames();
+        unreferenced_.resize(capacity_, false);
+        ring_owned_.resize(capacity_, false);
+        // Initially, every page is in the free list.
+        for (size_t i = 0; i < pool_size_; ++i) {
+            free_list_.emplace_back(static_cast<frame_id_t>(i));  // static_cast转换数据类型
+        }
+    }
+
+    /**
+     * @brief Destroy the Buffer Pool object
+     *
+     */
+    ~BufferPoolInstance() {
+        for (auto &entry : prefetching_) {
+            try {
+                entry.second->Wait();
+            } catch (UnixError &) {
+            }
+        }
+        delete[] pages_;
+    }
+
+   public:
+    /**
+     * Fetch the requested page from the buffer pool.
+     * @param page_id id of page to be fetched
+     * @param ring 访问策略在本分区中的环，为 nullptr 时使用缓冲池的替换策略
+     * @return the requested page
+     */
+    Page *FetchPage(PageId page_id, BufferAccessStrategy::Ring *ring = nullptr);
+
+    /**
+     * Unpin the target page from the buffer pool.
+     * @param page_id id of page to be unpinned
+     * @param is_dirty true if the page should be marked as dirty, false otherwise
+     * @return false if the page pin count is <= 0 before this call, true otherwise
+     */
+    bool UnpinPage(PageId page_id, bool is_dirty);
+
+    /**
+     * @brief 按帧号 unpin 页面，不查找页表，供 page guard 使用
+     * @note 调用者需仍持有该帧上的 pin，保证帧中还是 pin 住时的页面
+     */
+    bool UnpinFrame(frame_id_t frame_id, bool is_dirty);
+
+    /**
+     * Flushes the target page to disk.
+     * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+     * @return false if the page could not be found in the page table, true otherwise
+     */
+    bool FlushPage(PageId page_id);
+
+    /**
+     * Creates a new page in the buffer pool.
+     * @param page_id id of created page, page_no 已由 DiskManager::AllocatePage 分配
+     * @return nullptr if no new pages could be created, otherwise pointer to new page
+     */
+    Page *NewPage(PageId page_id);
+
+    /**
+     * Deletes a page from the buffer pool.
+     * @param page_id id of page to be deleted
+     * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+     */
+    bool DeletePage(PageId page_id);
+
+    /**
+     * @brief 异步预读文件 fd 中的 page_nos 页面，提交后立即返回
+     * @note 已在缓冲池中的页面跳过；只使用空闲帧或可淘汰的帧，且正在预读的帧不超过分区的四分之一；
+     * 预读失败的页面会被丢弃，之后的 FetchPage 重新同步读取；传入 ring 时只使用环中的帧，环中没有可复用的帧时停止预读
+     */
+    void PrefetchPages(int fd, const std::vector<page_id_t> &page_nos, BufferAccessStrategy::Ring *ring = nullptr);
+
+    /**
+     * @brief 文件在缓冲池中是否还有比磁盘上更新的页面（脏页，或仍被 pin 住、可能正在被原地修改的页面）
+     * @note 没有这样的页面时，磁盘上的内容就是文件的最新内容，只读扫描可以绕过缓冲池直接读取文件
+     */
+    bool HasUnflushedPages(int fd);
+
+    /**
+     * @brief 等待文件 fd 在分区中的读写完成后，统计它仍被 pin 住的页面数
+     */
+    size_t CountPinnedPages(int fd);
+
+    /**
+     * @brief 把文件 fd 驻留在分区中、没有被 pin 住的页面移出缓冲池
+     * @param write_back 是否在 latch_ 下先写回脏页，为 false 时脏页直接丢弃（文件关闭时已经 FlushAllPages）
+     * @return 仍被 pin 住、没有移出的页面数
+     * @note 写回失败时已移出的页面不恢复，失败的页面仍是脏页，抛出异常
+     */
+    size_t DiscardPages(int fd, bool write_back = false);
+
+    int GetPageSize() const { return page_size_; }
+
+    void SetPageSize(int page_size);
+
+    size_t GetPoolSize() const { return pool_size_; }
+
+    size_t GetCapacity() const { return capacity_; }
+
+    /**
+     * @brief 在线修改分区的帧数，不超过 capacity_
+     * @note 扩容时新的帧直接进入 free_list_；缩小时先让多出的帧退出 free_list_ 和 replacer_，
+     * 再逐个等待它们上的 pin 和读写结束，写回脏页后移出缓冲池，期间其他线程照常访问分区。
+     * 写回失败时分区停在已经缩小到的大小并抛出异常
+     */
+    void Resize(size_t pool_size);
+
+    /** @return 分区中是否没有任何页面 */
+    bool IsEmpty();
+
+    /** @return 分区中驻留的页面数 */
+    size_t GetNumPages();
+
+    /**
+     * @brief 按替换策略的优先级收集分区中的热页面，最不容易被淘汰的在前
+     * @note 被 pin 住的页面排在最前，之后按淘汰顺序倒序排列；预读后还没被访问过的页面和大扫描的环中的页面不算热页面
+     */
+    void CollectHotPages(std::vector<PageId> *page_ids);
+
+    /**
+     * @brief 预热：把文件 fd 中的 page_nos 页面异步读入空闲帧，请求追加到 requests 并提交后立即返回
+     * @note 与预读相同，页面读完后才可淘汰，且第一次被访问前不计入替换策略的访问历史；
+     * 只使用空闲帧，不淘汰任何页面，空闲帧用完后剩下的页面跳过
+     */
+    void PrewarmPages(int fd, const std::vector<page_id_t> &page_nos, std::vector<IoRequestPtr> *requests);
+
+    /**
+     * @brief 后台刷脏：写回替换策略接下来要淘汰的帧中的脏页，使空闲帧与干净的可淘汰帧不少于分区的
+     * PAGE_CLEANER_CLEAN_PERCENT%，前台缺页时不必同步写回
+     * @param max_pages 最多写回的页面数
+     * @return 写回成功的页面数
+     */
+    size_t CleanPages(size_t max_pages);
+
+   private:
+    frame_id_t GetFrameId(const Page *page) const { return static_cast<frame_id_t>(page - pages_); }
+
+    bool UnpinFrameLocked(frame_id_t frame_id, bool is_dirty);
+
+    /**
+     * @brief 等待文件 fd 的读写完成，收集并 pin 住该文件在分区中的全部页面，调用者需持有 latch_
+     */
+    void CollectPages(int fd, std::vector<Page *> *pages, std::unique_lock<std::mutex> &lock);
+
+    void WaitForFileIo(int fd, std::unique_lock<std::mutex> &lock);
+
+    void AllocateFrames();
+
+    bool FindVictimPage(frame_id_t *frame_id);
+
+    bool FindRingFrame(BufferAccessStrategy::Ring *ring, frame_id_t *frame_id, bool replace);
+
+    Page *LoadPage(frame_id_t frame_id, PageId page_id, bool read, std::unique_lock<std::mutex> &lock);
+
+    bool WaitForIo(frame_id_t frame_id, std::unique_lock<std::mutex> &lock);
+
+    void WaitForWriteBack(PageId page_id, std::unique_lock<std::mutex> &lock);
+
+    bool WaitForPrefetch(std::unique_lock<std::mutex> &lock);
+
+    bool CompletePrefetch(frame_id_t frame_id, bool wait);
+
+    void ReapPrefetches();
+
+    void UpdatePage(Page *page, PageId new_page_id, frame_id_t new_frame_id);
+
+    void RetireFrame(frame_id_t frame_id, std::unique_lock<std::mutex> &lock);
+
+    /** 归还一个不再存放页面的帧：正在使用的帧进入 free_list_，退役的帧只唤醒等待它的 Resize */
+    void ReleaseFrame(frame_id_t frame_id) {
+        if (static_cast<size_t>(frame_id) < pool_size_) {
+            free_list_.push_back(frame_id);
+        } else {
+            io_cv_.notify_all();
+        }
+    }
+
+    /** 帧上的 pin 全部解除后让它可以被淘汰：正在使用的帧进入 replacer_，退役的帧只唤醒等待它的 Resize */
+    void SetEvictable(frame_id_t frame_id) {
+        if (static_cast<size_t>(frame_id) < pool_size_) {
+            replacer_->Unpin(frame_id);
+        } else {
+            io_cv_.notify_all();
+        }
+    }
+
+    /** 把页面登记到页表和所在文件的驻留链表中 */
+    void MapPage(PageId page_id, frame_id_t frame_id) {
+        page_table_.Insert(page_id, frame_id);
+        resident_frames_.Insert(page_id.fd, frame_id);
+    }
+
+    /** 把页面从页表和驻留链表中移除 */
+    void UnmapPage(PageId page_id, frame_id_t frame_id) {
+        // 空闲帧的 PageId 可能是 {-1, -1}，与页表空槽位的 key 相同，不能交给 PageTable::Erase
+        if (page_id.page_no != INVALID_PAGE_ID) {
+            page_table_.Erase(page_id);
+        }
+        resident_frames_.Erase(frame_id);
+    }
+
+    /** 设置帧的脏位，同时维护所在文件的脏页链表 */
+    void SetDirty(frame_id_t frame_id, bool is_dirty) {
+        pages_[frame_id].is_dirty_ = is_dirty;
+        if (is_dirty) {
+            dirty_frames_.Insert(pages_[frame_id].id_.fd, frame_id);
+        } else {
+            dirty_frames_.Erase(frame_id);
+        }
+    }
+
+    void FlushLog(lsn_t lsn) {
+        if (flush_log_) {
+            flush_log_(lsn);
+        }
+    }
+};
\ No newline at end of file
@@ -1,216 +1,705 @@
 #include "buffer_pool_manager.h"
 
+#include <strings.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
 /**
- * @brief 从 free_list 或 replacer 中得到可淘汰帧页的 *frame_id
- * @param frame_id 帧页 id 指针，返回成功找到的可替换帧 id
- * @return true: 可替换帧查找成功 , false: 可替换帧查找失败
+ * @brief 读取不小于 min_value 的整数环境变量，未设置或无法解析时返回 default_value
  */
-bool BufferPoolManager::FindVictimPage(frame_id_t *frame_id) {
-    // Todo:
-    // 1 使用 BufferPoolManager::free_list_判断缓冲池是否已满需要淘汰页面
-    // 1.1 未满获得 frame
-    // 1.2 已满使用 lru_replacer 中的方法选择淘汰页面
-    if (free_list_.empty()) {
-        //已满 选择淘汰页面
-        return replacer_->Victim(frame_id);
-    } else {
-        //未满，从 free_list_ 里取得 frame_id
-        //puts("buffer is not full");
-        auto IT = free_list_.end();
-        IT--;
-        *frame_id = *IT;
-        free_list_.pop_back();
-        return true;
+static size_t GetSizeFromEnv(const char *name, size_t default_value, size_t min_value = 1) {
+    const char *value = std::getenv(name);
+    if (value == nullptr || value[0] == '\0') {
+        return default_value;
     }
-    return false;
+    char *end;
+    unsigned long long size = std::strtoull(value, &end, 10);
+    if (*end != '\0' || value[0] == '-' || size < min_value) {
+        LOG_WARN("%s=%s is not an integer >= %zu, use %zu.", name, value, min_value, default_value);
+        return default_value;
+    }
+    return size;
+}
+
+size_t BufferPoolManager::DefaultPoolSize() { return GetSizeFromEnv("RUCBASE_BUFFER_POOL_SIZE", BUFFER_POOL_SIZE); }
+
+size_t BufferPoolManager::DefaultMaxPoolSize() {
+    return GetSizeFromEnv("RUCBASE_BUFFER_POOL_MAX_SIZE", BUFFER_POOL_MAX_SIZE);
+}
+
+size_t BufferPoolManager::DefaultPageCacheSize() {
+    return GetSizeFromEnv("RUCBASE_PAGE_CACHE_SIZE", COMPRESSED_PAGE_CACHE_SIZE, 0);
+}
+
+std::string BufferPoolManager::DefaultPoolConfig() {
+    const char *config = std::getenv("RUCBASE_BUFFER_POOLS");
+    return config != nullptr ? config : BUFFER_POOLS;
 }
 
 /**
- * @brief 更新页面数据，为脏页则需写入磁盘，更新 page 元数据 (data, is_dirty, page_id) 和 page table
- *
- * @param page 写回页指针
- * @param new_page_id 写回页新 page_id
- * @param new_frame_id 写回页新帧 frame_id
+ * @brief 创建缓冲池及其分区，分区追加在 instances_ 的末尾
+ * @param max_pool_size Resize 允许的最大帧数，为 0 或小于 pool_size 时等于 pool_size（不能扩容）
  */
-void BufferPoolManager::UpdatePage(Page *page, PageId new_page_id, frame_id_t new_frame_id) {
-    // Todo:
-    // 1 如果是脏页，写回磁盘，并且把 dirty 置为 false
-    // 2 更新 page table
-    // 3 重置 page 的 data，更新 page id
-    if (page->IsDirty()) {
-        page->is_dirty_ = false;
-        int fd = page->GetPageId().fd, page_no = page->GetPageId().page_no;
-        disk_manager_->write_page(fd, page_no, page->data_, PAGE_SIZE);
-    }
-    page_table_.erase(page->GetPageId());
-    page->id_ = new_page_id;
-    page->ResetMemory();
-    if (new_page_id.page_no != INVALID_PAGE_ID) {
-        page_table_[new_page_id] = new_frame_id;
-    } //else puts("CASE E");
+void BufferPoolManager::CreatePool(const std::string &name, size_t pool_size, size_t num_instances,
+                                   const std::string &replacer_type, size_t max_pool_size) {
+    auto pool = std::make_unique<BufferPool>();
+    pool->name = name;
+    pool->replacer_type = replacer_type;
+    pool->first_instance = instances_.size();
+    pool->num_instances = std::max<size_t>(1, std::min(num_instances, pool_size));
+    pool->pool_size = pool_size;
+    pool->max_pool_size = std::max(pool_size, max_pool_size);
+    for (size_t i = 0; i < pool->num_instances; i++) {
+        instances_.push_back(std::make_unique<BufferPoolInstance>(
+            GetPartitionSize(pool_size, pool->num_instances, i), disk_manager_, replacer_type,
+            GetPartitionSize(pool->max_pool_size, pool->num_instances, i)));
+    }
+    pools_.push_back(std::move(pool));
+}
+
+void BufferPoolManager::AddPool(const std::string &name, size_t pool_size, size_t num_instances,
+                                const std::string &replacer_type, size_t max_pool_size) {
+    if (HasPool(name)) {
+        throw BufferPoolExistsError(name);
+    }
+    if (pool_size == 0) {
+        throw InvalidPoolSizeError(pool_size);
+    }
+    if (pools_.size() > UINT8_MAX) {
+        throw InternalError("BufferPoolManager::AddPool: too many buffer pools");
+    }
+    std::scoped_lock thread_lock{cleaner_latch_, dumper_latch_};
+    if (cleaner_running_ || dumper_running_ || prewarm_running_) {
+        throw InternalError("BufferPoolManager::AddPool: background threads are already running");
+    }
+    size_t first_instance = instances_.size();
+    CreatePool(name, pool_size, num_instances, replacer_type, max_pool_size);
+    if (file_pools_ == nullptr) {
+        file_pools_ = std::make_unique<std::atomic<uint8_t>[]>(MAX_FILES);
+        file_gates_ = std::make_unique<std::atomic<uint32_t>[]>(MAX_FILES);
+    }
+    // 新的分区沿用已有分区的设置
+    BufferPoolInstance *first = instances_[0].get();
+    for (size_t i = first_instance; i < instances_.size(); i++) {
+        std::scoped_lock lock{first->latch_, instances_[i]->latch_};
+        instances_[i]->flush_log_ = first->flush_log_;
+        instances_[i]->page_cache_ = page_cache_.get();
+    }
+}
+
+void BufferPoolManager::AddPools(const std::string &config) {
+    std::stringstream items(config);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream fields_stream(item);
+        for (std::string field; std::getline(fields_stream, field, ':');) {
+            fields.push_back(field);
+        }
+        char *end = nullptr;
+        unsigned long long pool_size = fields.size() >= 2 ? std::strtoull(fields[1].c_str(), &end, 10) : 0;
+        if (fields.size() < 2 || fields.size() > 3 || fields[0].empty() || *end != '\0' || fields[1][0] == '-' ||
+            pool_size == 0) {
+            LOG_WARN("Buffer pool %s defined wrong, expected <name>:<size>[:<replacer>].", item.c_str());
+            continue;
+        }
+        size_t num_instances = std::min<size_t>(BUFFER_POOL_INSTANCES, pool_size / BUFFER_POOL_PARTITION_MIN_SIZE);
+        try {
+            AddPool(fields[0], pool_size, num_instances, fields.size() == 3 ? fields[2] : Replacer::DefaultType(),
+                    pool_size * (BUFFER_POOL_MAX_SIZE / BUFFER_POOL_SIZE));
+        } catch (RedBaseError &e) {
+            LOG_WARN("%s", e.what());
+        }
+    }
+}
+
+bool BufferPoolManager::HasPool(const std::string &name) const {
+    for (auto &pool : pools_) {
+        if (strcasecmp(pool->name.c_str(), name.c_str()) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t BufferPoolManager::FindPool(const std::string &name) const {
+    for (size_t i = 0; i < pools_.size(); i++) {
+        if (strcasecmp(pools_[i]->name.c_str(), name.c_str()) == 0) {
+            return i;
+        }
+    }
+    throw BufferPoolNotFoundError(name);
 }
 
 /**
- * Fetch the requested page from the buffer pool.
- * 如果页表中存在 page_id（说明该 page 在缓冲池中），并且 pin_count++。
- * 如果页表不存在 page_id（说明该 page 在磁盘中），则找缓冲池 victim page，将其替换为磁盘中读取的 page，pin_count 置 1。
- * @param page_id id of page to be fetched
- * @return the requested page
+ * @brief 先写回文件在原缓冲池中的页面并移出，再修改 fd 所在的缓冲池
+ * @note 整个过程中关闭该文件的访问闸门，其他会话对该文件的 FetchPage/NewPage 等待移动完成，
+ * 不会把页面重新读入原缓冲池；原缓冲池中还有被 pin 住的页面时不移出任何页面，抛出 InternalError
  */
-Page *BufferPoolManager::FetchPage(PageId page_id) {
-    // Todo:
-    // 0.     lock latch
-    // 1.     Search the page table for the requested page (P).
-    // 1.1    If P exists, pin it and return it immediately.
-    // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
-    //        Note that pages are always found from the free list first.
-    // 2.     If R is dirty, write it back to the disk.
-    // 3.     Delete R from the page table and insert P.
-    // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-    std :: scoped_lock lock{latch_};
-    if (page_table_.count(page_id)) {
-        replacer_->Pin(page_table_[page_id]);   // 在缓冲池中 
-        pages_[page_table_[page_id]].pin_count_++;
-        //puts("case 1");
-        //printf("page_no = %d\n", pages_[page_table_[page_id]].GetPageId().page_no);
-        //printf("page_no2 = %d\n", page_id.page_no);
-        //assert(pages_[page_table_[page_id]].id_ == page_id);
-        return &pages_[page_table_[page_id]];
-    } else {
-        frame_id_t victim_id;
-        if (FindVictimPage(&victim_id)) { //找出一个可用的 frameid
-            UpdatePage(&pages_[victim_id], page_id, victim_id);  // 替换该页面，frame id 不动，将其加入缓冲池
-            disk_manager_->read_page(page_id.fd, page_id.page_no, pages_[victim_id].data_, PAGE_SIZE);
-            replacer_->Pin(victim_id);
-            pages_[victim_id].pin_count_ = 1;
-            return &pages_[victim_id];
-        } else return nullptr;
-        //puts("case 3");
-    }
-    return nullptr;
+void BufferPoolManager::SetFilePool(int fd, const std::string &name) {
+    std::scoped_lock prewarm_lock{prewarm_latch_};
+    size_t pool_index = FindPool(name);
+    size_t old_index = GetPoolIndex(fd);
+    if (pool_index == old_index) {
+        return;
+    }
+    if (fd < 0 || fd >= MAX_FILES) {
+        throw InternalError("BufferPoolManager::SetFilePool: invalid fd");
+    }
+    CloseFileGate(fd);
+    try {
+        FlushAllPages(fd);
+        const BufferPool &old_pool = *pools_[old_index];
+        size_t pinned = 0;
+        for (size_t i = 0; i < old_pool.num_instances; i++) {
+            pinned += instances_[old_pool.first_instance + i]->CountPinnedPages(fd);
+        }
+        if (pinned > 0) {
+            throw InternalError("BufferPoolManager::SetFilePool: pages of the file are still pinned");
+        }
+        // 闸门关闭后不会再有新的 pin，FlushAllPages 之后被修改的页面在移出时写回
+        for (size_t i = 0; i < old_pool.num_instances; i++) {
+            instances_[old_pool.first_instance + i]->DiscardPages(fd, true);
+        }
+        file_pools_[fd].store(static_cast<uint8_t>(pool_index), std::memory_order_release);
+    } catch (...) {
+        OpenFileGate(fd);
+        throw;
+    }
+    OpenFileGate(fd);
+}
+
+void BufferPoolManager::EnterFile(int fd) {
+    if (file_gates_ == nullptr || fd < 0 || fd >= MAX_FILES) {
+        return;
+    }
+    while (file_gates_[fd].fetch_add(1, std::memory_order_acq_rel) & FILE_MOVING) {
+        LeaveFile(fd);
+        std::unique_lock lock{gate_latch_};
+        gate_cv_.wait(lock, [&] { return !(file_gates_[fd].load(std::memory_order_acquire) & FILE_MOVING); });
+    }
+}
+
+void BufferPoolManager::LeaveFile(int fd) {
+    if (file_gates_ == nullptr || fd < 0 || fd >= MAX_FILES) {
+        return;
+    }
+    if (file_gates_[fd].fetch_sub(1, std::memory_order_acq_rel) == (FILE_MOVING | 1)) {
+        // 最后一个访问离开，唤醒等待闸门关闭的 SetFilePool
+        std::scoped_lock lock{gate_latch_};
+        gate_cv_.notify_all();
+    }
+}
+
+void BufferPoolManager::CloseFileGate(int fd) {
+    file_gates_[fd].fetch_or(FILE_MOVING, std::memory_order_acq_rel);
+    std::unique_lock lock{gate_latch_};
+    gate_cv_.wait(lock, [&] { return file_gates_[fd].load(std::memory_order_acquire) == FILE_MOVING; });
+}
+
+void BufferPoolManager::OpenFileGate(int fd) {
+    {
+        std::scoped_lock lock{gate_latch_};
+        file_gates_[fd].fetch_and(~FILE_MOVING, std::memory_order_acq_rel);
+    }
+    gate_cv_.notify_all();
+}
+
+std::vector<BufferPoolStats> BufferPoolManager::GetPoolStats() {
+    std::vector<BufferPoolStats> stats;
+    for (auto &pool : pools_) {
+        BufferPoolStats pool_stats{pool->name, pool->replacer_type, pool->pool_size, pool->max_pool_size, 0, 0, 0, 0};
+        for (size_t i = 0; i < pool->num_instances; i++) {
+            BufferPoolInstance *instance = instances_[pool->first_instance + i].get();
+            pool_stats.num_pages += instance->GetNumPages();
+            pool_stats.hits += instance->hits_;
+            pool_stats.misses += instance->misses_;
+            pool_stats.dirty_evictions += instance->dirty_evictions_;
+        }
+        stats.push_back(pool_stats);
+    }
+    return stats;
 }
 
 /**
- * Unpin the target page from the buffer pool. 取消固定 pin_count>0 的在缓冲池中的 page
- * @param page_id id of page to be unpinned
- * @param is_dirty true if the page should be marked as dirty, false otherwise
- * @return false if the page pin count is <= 0 before this call, true otherwise
+ * @brief 修改页面大小，重新分配各分区的帧内存，并同步设置 DiskManager 的页面大小
+ * @note 只能在缓冲池中没有页面时调用（如 open_db 打开数据库之前）
  */
-bool BufferPoolManager::UnpinPage(PageId page_id, bool is_dirty) {
-    // Todo:
-    // 0. lock latch
-    // 1. try to search page_id page P in page_table_
-    // 1.1 P 在页表中不存在 return false
-    // 1.2 P 在页表中存在 如何解除一次固定 (pin_count)
-    // 2. 页面是否需要置脏
-    std :: scoped_lock lock{latch_};
-    if (page_table_.count(page_id)) {
-        frame_id_t frame_id = page_table_[page_id];
-        //printf("node = %d pin = %d\n", pages_[frame_id].GetPageId().page_no, pages_[frame_id].pin_count_);
-        if (pages_[frame_id].pin_count_ <= 0) {
-            return false;
-        } else {
-            pages_[frame_id].pin_count_--;
-            if (is_dirty)
-                pages_[frame_id].is_dirty_ = is_dirty;
-            if (pages_[frame_id].pin_count_ == 0) {
-                replacer_->Unpin(frame_id);
-            }
-            return true;
+void BufferPoolManager::SetPageSize(int page_size) {
+    for (auto &instance : instances_) {
+        if (!instance->IsEmpty()) {
+            throw InternalError("BufferPoolManager::SetPageSize: buffer pool is not empty");
         }
-    } else {
-        return false;
+    }
+    for (auto &instance : instances_) {
+        instance->SetPageSize(page_size);
     }
 }
 
 /**
- * Flushes the target page to disk. 将 page 写入磁盘；不考虑 pin_count
- * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
- * @return false if the page could not be found in the page table, true otherwise
+ * @brief 在线修改命名缓冲池的帧数，依次修改它的各分区
+ * @param pool_size 新的帧数，在 [分区数, max_pool_size] 之间
  */
-bool BufferPoolManager::FlushPage(PageId page_id) {
-    // Todo:
-    // 0. lock latch
-    // 1. 页表查找
-    // 2. 存在时如何写回磁盘
-    // 3. 写回后页面的脏位
-    // Make sure you call DiskManager::WritePage!
-    std :: scoped_lock lock{latch_};
-    if (page_id.page_no == INVALID_PAGE_ID) return false;   
-    if (page_table_.count(page_id)) {
-        Page *page = &pages_[page_table_[page_id]];
-        disk_manager_->write_page(page_id.fd, page_id.page_no, page->GetData(), PAGE_SIZE);
-        page->is_dirty_ = false;
-        return true;
-    } else return false;
+void BufferPoolManager::Resize(const std::string &name, size_t pool_size) {
+    BufferPool &pool = *pools_[FindPool(name)];
+    if (pool_size < pool.num_instances || pool_size > pool.max_pool_size) {
+        throw InvalidPoolSizeError(pool_size);
+    }
+    std::scoped_lock lock{pool.resize_latch};
+    try {
+        for (size_t i = 0; i < pool.num_instances; i++) {
+            instances_[pool.first_instance + i]->Resize(GetPartitionSize(pool_size, pool.num_instances, i));
+        }
+    } catch (...) {
+        size_t resized = 0;
+        for (size_t i = 0; i < pool.num_instances; i++) {
+            resized += instances_[pool.first_instance + i]->GetPoolSize();
+        }
+        pool.pool_size = resized;
+        throw;
+    }
+    pool.pool_size = pool_size;
 }
 
 /**
- * Creates a new page in the buffer pool. 相当于从磁盘中移动一个新建的空 page 到缓冲池某个位置
+ * Creates a new page in the buffer pool. 先在磁盘上分配页面编号，再放入该编号所在的分区
  * @param[out] page_id id of created page
  * @return nullptr if no new pages could be created, otherwise pointer to new page
  */
 Page *BufferPoolManager::NewPage(PageId *page_id) {
-    // Todo:
-    // 0.   lock latch
-    // 1.   Make sure you call DiskManager::AllocatePage!
-    // 2.   If all the pages in the buffer pool are pinned, return nullptr.
-    // 3.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
-    // 4.   Update P's metadata, zero out memory and add P to the page table. pin_count set to 1.
-    // 5.   Set the page ID output parameter. Return a pointer to P.
-    std :: scoped_lock lock{latch_};
-    frame_id_t frame_id;
-    if (FindVictimPage(&frame_id)) {
-        page_id->page_no = disk_manager_->AllocatePage(page_id->fd);
-        UpdatePage(&pages_[frame_id], *page_id, frame_id);
-        replacer_->Pin(frame_id);
-        pages_[frame_id].pin_count_ = 1;
-        //printf("newpage pages fd = %d no = %d\n", pages_[frame_id].id_.fd, pages_[frame_id].id_.page_no);
-        return &pages_[frame_id];
-    } else return nullptr;
+    FileAccess access(this, page_id->fd);
+    page_id->page_no = disk_manager_->AllocatePage(page_id->fd);
+    Page *page = GetInstance(*page_id)->NewPage(*page_id);
+    if (page == nullptr) {
+        // 分区中的帧都被 pin 住了，归还刚分配的页面编号
+        disk_manager_->UndoAllocatePage(page_id->fd, page_id->page_no);
+    }
+    return page;
 }
 
+/**
+ * @brief Flushes all the pages in the buffer pool to disk.
+ * 按 page_no 排序后，把编号连续的页面合并为一次 pwritev，减少整文件刷盘时的系统调用次数
+ *
+ * @param fd 指定的 diskfile open 句柄
+ * @note 只写回该文件的脏页：record 层和索引层通过 page guard 修改页面时都会置脏，各分区按文件维护脏页链表，
+ * 不需要扫描全部帧；编号连续的页面分散在文件所在缓冲池的不同分区中，因此逐个分区加锁，
+ * 等待该文件的读写完成后收集并 pin 住页面，释放这个分区的 latch 再处理下一个，最后排序统一写回；
+ * 同一时刻只持有一个分区的 latch，等待 I/O 时不会挡住其他分区的访问
+ */
+void BufferPoolManager::FlushAllPages(int fd) {
+    std::vector<Page *> pages;
+    const BufferPool &pool = *pools_[GetPoolIndex(fd)];
+    for (size_t i = 0; i < pool.num_instances; i++) {
+        BufferPoolInstance *instance = instances_[pool.first_instance + i].get();
+        std::unique_lock lock{instance->latch_};
+        instance->CollectPages(fd, &pages, lock);
+    }
+    std::sort(pages.begin(), pages.end(),
+              [](Page *a, Page *b) { return a->GetPageId().page_no < b->GetPageId().page_no; });
+
+    std::vector<const char *> run;
+    size_t written = 0;
+    try {
+        lsn_t max_lsn = INVALID_LSN;
+        for (Page *page : pages) {
+            max_lsn = std::max(max_lsn, page->GetPageLsn());
+        }
+        if (!pages.empty()) {
+            instances_[0]->FlushLog(max_lsn);
+        }
+        for (size_t i = 0; i < pages.size(); i++) {
+            run.push_back(pages[i]->GetData());
+            bool run_end =
+                i + 1 == pages.size() || pages[i + 1]->GetPageId().page_no != pages[i]->GetPageId().page_no + 1;
+            if (run_end) {
+                size_t start = i + 1 - run.size();
+                disk_manager_->write_pages(fd, pages[start]->GetPageId().page_no, run.data(), run.size());
+                run.clear();
+                written = i + 1;
+            }
+        }
+    } catch (...) {
+        // 没有写回的页面重新置脏
+        for (size_t i = 0; i < pages.size(); i++) {
+            GetInstance(pages[i]->GetPageId())->UnpinPage(pages[i]->GetPageId(), i >= written);
+        }
+        throw;
+    }
+    for (Page *page : pages) {
+        GetInstance(page->GetPageId())->UnpinPage(page->GetPageId(), false);
+    }
+}
 
 /**
- * @brief Deletes a page from the buffer pool.
- * @param page_id id of page to be deleted
- * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+ * @brief 把文件 fd 的页面移出缓冲池，不写回，fd 重新分配给默认缓冲池
+ *
+ * @param fd 指定的 diskfile open 句柄
  */
-bool BufferPoolManager::DeletePage(PageId page_id) {
-    // Todo:
-    // 0.   lock latch
-    // 1.   Make sure you call DiskManager::DeallocatePage!
-    // 2.   Search the page table for the requested page (P).
-    // 2.1  If P does not exist, return true.
-    // 2.2  If P exists, but has a non-zero pin-count, return false. Someone is using the page.
-    // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free
-    // list.
-    std :: scoped_lock lock{latch_};
-    if (page_table_.count(page_id) ) {
-        frame_id_t frame_id = page_table_[page_id];
-        if (pages_[frame_id].pin_count_ != 0) return false;
-        disk_manager_->DeallocatePage(page_id.page_no);
-        page_id.page_no = INVALID_PAGE_ID;
-        UpdatePage(&pages_[frame_id], page_id, frame_id);
-        free_list_.push_back(frame_id);
-        return true;
-    } else return true;
+void BufferPoolManager::DiscardPages(int fd) {
+    std::scoped_lock prewarm_lock{prewarm_latch_};
+    prewarm_pages_.erase(std::remove_if(prewarm_pages_.begin() + prewarm_next_, prewarm_pages_.end(),
+                                        [fd](const PageId &page_id) { return page_id.fd == fd; }),
+                         prewarm_pages_.end());
+    size_t pinned = 0;
+    for (auto &instance : instances_) {
+        pinned += instance->DiscardPages(fd);
+    }
+    if (page_cache_ != nullptr) {
+        page_cache_->EraseFile(fd);
+    }
+    if (pinned == 0 && file_pools_ != nullptr && fd >= 0 && fd < MAX_FILES) {
+        file_pools_[fd].store(0, std::memory_order_release);
+    }
+    if (pinned > 0) {
+        LOG_WARN("%zu pages of fd %d are still pinned when discarding the file", pinned, fd);
+    }
 }
 
+/**
+ * @brief 文件在缓冲池中是否还有比磁盘上更新的页面
+ *
+ * @param fd 指定的 diskfile open 句柄
+ */
+bool BufferPoolManager::HasUnflushedPages(int fd) {
+    const BufferPool &pool = *pools_[GetPoolIndex(fd)];
+    for (size_t i = 0; i < pool.num_instances; i++) {
+        if (instances_[pool.first_instance + i]->HasUnflushedPages(fd)) {
+            return true;
+        }
+    }
+    return false;
+}
 
 /**
- * @brief Flushes all the pages in the buffer pool to disk.
+ * @brief 异步预读一段连续的页面
  *
  * @param fd 指定的 diskfile open 句柄
+ * @param first_page_no 第一个预读的页面
+ * @param count 预读的页面数
+ * @param strategy 访问策略，不为 nullptr 时只在策略的环中预读
  */
-void BufferPoolManager::FlushAllPages(int fd) {
-    // example for disk write
-    std::scoped_lock lock{latch_};
-    for (size_t i = 0; i < pool_size_; i++) {
-        Page *page = &pages_[i];
-        if (page->GetPageId().fd == fd && page->GetPageId().page_no != INVALID_PAGE_ID) {
-            disk_manager_->write_page(page->GetPageId().fd, page->GetPageId().page_no, page->GetData(), PAGE_SIZE);
-            page->is_dirty_ = false;
+void BufferPoolManager::PrefetchPages(int fd, page_id_t first_page_no, int count, BufferAccessStrategy *strategy) {
+    FileAccess access(this, fd);
+    std::vector<std::vector<page_id_t>> page_nos(instances_.size());
+    for (page_id_t page_no = first_page_no; page_no < first_page_no + count; page_no++) {
+        page_nos[GetInstanceIndex(PageId{fd, page_no})].push_back(page_no);
+    }
+    for (size_t i = 0; i < instances_.size(); i++) {
+        if (!page_nos[i].empty()) {
+            instances_[i]->PrefetchPages(fd, page_nos[i], strategy != nullptr ? &strategy->rings_[i] : nullptr);
+        }
+    }
+}
+
+/**
+ * @brief 为访问文件 fd 中 num_pages 个页面的大扫描或批量读写创建访问策略
+ * @note 环的大小为 BUFFER_RING_SIZE，按文件所在缓冲池的分区平均分配，每个分区的环不超过分区帧数的 1/8；
+ * 访问的页面数不超过该缓冲池的 1/4 时整个访问都放得进缓冲池，不需要环，返回 nullptr
+ *
+ * @param fd 指定的 diskfile open 句柄
+ * @param num_pages 预计访问的页面数
+ * @return 访问策略，或 nullptr 表示直接使用缓冲池的替换策略
+ */
+std::unique_ptr<BufferAccessStrategy> BufferPoolManager::GetAccessStrategy(int fd, size_t num_pages) {
+    const BufferPool &pool = *pools_[GetPoolIndex(fd)];
+    if (num_pages <= pool.pool_size / 4) {
+        return nullptr;
+    }
+    size_t ring_pages = std::max<size_t>(1, BUFFER_RING_SIZE / GetPageSize());
+    // 其他缓冲池的分区上的环用不到，只占一个位置
+    std::vector<size_t> ring_sizes(instances_.size(), 1);
+    for (size_t i = 0; i < pool.num_instances; i++) {
+        size_t ring_size = (ring_pages + pool.num_instances - 1) / pool.num_instances;
+        ring_sizes[pool.first_instance + i] =
+            std::min(ring_size, instances_[pool.first_instance + i]->GetPoolSize() / 8);
+    }
+    return std::make_unique<BufferAccessStrategy>(ring_sizes);
+}
+
+void BufferPoolManager::StartPageCleaner() {
+    std::scoped_lock lock{cleaner_latch_};
+    if (cleaner_running_) {
+        return;
+    }
+    cleaner_running_ = true;
+    for (auto &instance : instances_) {
+        std::scoped_lock instance_lock{instance->latch_};
+        instance->cleaner_cv_ = &cleaner_cv_;
+    }
+    cleaner_ = std::thread(&BufferPoolManager::RunPageCleaner, this);
+}
+
+void BufferPoolManager::StopPageCleaner() {
+    {
+        std::scoped_lock lock{cleaner_latch_};
+        if (!cleaner_running_) {
+            return;
+        }
+        cleaner_running_ = false;
+        for (auto &instance : instances_) {
+            std::scoped_lock instance_lock{instance->latch_};
+            instance->cleaner_cv_ = nullptr;
+        }
+    }
+    cleaner_cv_.notify_all();
+    cleaner_.join();
+}
+
+/**
+ * @brief 刷脏线程的主循环：依次清理各分区，有页面写回时立即开始下一轮，否则等待 PAGE_CLEANER_INTERVAL_MS 或被唤醒
+ */
+void BufferPoolManager::RunPageCleaner() {
+    std::unique_lock lock{cleaner_latch_};
+    while (cleaner_running_) {
+        lock.unlock();
+        size_t cleaned = 0;
+        for (auto &instance : instances_) {
+            try {
+                cleaned += instance->CleanPages(PAGE_CLEANER_BATCH_PAGES);
+            } catch (RedBaseError &e) {
+                LOG_WARN("page cleaner failed: %s", e.what());
+            }
+        }
+        lock.lock();
+        if (cleaned == 0) {
+            cleaner_cv_.wait_for(lock, std::chrono::milliseconds(PAGE_CLEANER_INTERVAL_MS));
         }
     }
-}
\ No newline at end of file
+}
+
+void BufferPoolManager::EnablePageCache(size_t capacity) {
+    page_cache_ = std::make_unique<CompressedPageCache>(capacity);
+    for (auto &instance : instances_) {
+        std::scoped_lock lock{instance->latch_};
+        instance->page_cache_ = page_cache_.get();
+    }
+}
+
+void BufferPoolManager::SetLogFlusher(const std::function<void(lsn_t)> &flush_log) {
+    for (auto &instance : instances_) {
+        std::scoped_lock lock{instance->latch_};
+        instance->flush_log_ = flush_log;
+    }
+}
+
+std::vector<PageId> BufferPoolManager::GetHotPages() {
+    std::vector<std::vector<PageId>> lists(instances_.size());
+    for (size_t i = 0; i < instances_.size(); i++) {
+        instances_[i]->CollectHotPages(&lists[i]);
+    }
+    std::vector<PageId> pages;
+    for (size_t rank = 0;; rank++) {
+        bool found = false;
+        for (auto &list : lists) {
+            if (rank < list.size()) {
+                pages.push_back(list[rank]);
+                found = true;
+            }
+        }
+        if (!found) {
+            break;
+        }
+    }
+    return pages;
+}
+
+void BufferPoolManager::DumpHotPages(const std::string &path) {
+    std::vector<PageId> pages = GetHotPages();
+    std::unordered_map<int, std::string> file_names;
+    std::string tmp_path = path + ".tmp";
+    std::ofstream ofs(tmp_path);
+    for (PageId page_id : pages) {
+        auto it = file_names.find(page_id.fd);
+        if (it == file_names.end()) {
+            std::string file_name;
+            try {
+                file_name = disk_manager_->GetFileName(page_id.fd);
+            } catch (FileNotOpenError &) {
+                // 文件已经关闭，它的页面不再转储
+            }
+            it = file_names.emplace(page_id.fd, file_name).first;
+        }
+        if (!it->second.empty()) {
+            ofs << it->second << ' ' << page_id.page_no << '\n';
+        }
+    }
+    ofs.close();
+    if (!ofs || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw UnixError();
+    }
+}
+
+void BufferPoolManager::StartPageDumper(const std::string &path, int interval_ms) {
+    std::scoped_lock lock{dumper_latch_};
+    if (dumper_running_) {
+        return;
+    }
+    dumper_running_ = true;
+    dumper_ = std::thread(&BufferPoolManager::RunPageDumper, this, path, interval_ms);
+}
+
+void BufferPoolManager::StopPageDumper() {
+    {
+        std::scoped_lock lock{dumper_latch_};
+        if (!dumper_running_) {
+            return;
+        }
+        dumper_running_ = false;
+    }
+    dumper_cv_.notify_all();
+    dumper_.join();
+}
+
+/**
+ * @brief 转储线程的主循环；预热还没完成时缓冲池中的页面大多还没被访问过，转储出的列表会丢掉没读入的页面，因此跳过
+ */
+void BufferPoolManager::RunPageDumper(const std::string &path, int interval_ms) {
+    std::unique_lock lock{dumper_latch_};
+    while (dumper_running_) {
+        dumper_cv_.wait_for(lock, std::chrono::milliseconds(interval_ms));
+        if (!dumper_running_ || prewarm_running_) {
+            continue;
+        }
+        lock.unlock();
+        try {
+            DumpHotPages(path);
+        } catch (RedBaseError &e) {
+            LOG_WARN("Failed to dump the hot pages to %s: %s", path.c_str(), e.what());
+        }
+        lock.lock();
+    }
+}
+
+void BufferPoolManager::StartPrewarm(const std::string &path) {
+    StopPrewarm();
+    std::ifstream ifs(path);
+    if (!ifs) {
+        return;
+    }
+    size_t max_pages = 0;
+    for (auto &pool : pools_) {
+        max_pages += pool->pool_size;
+    }
+    // 文件名 -> fd，不存在的文件为 -1
+    std::unordered_map<std::string, int> fds;
+    std::unordered_set<PageId, PageIdHash> seen;
+    std::vector<PageId> pages;
+    std::string file_name;
+    page_id_t page_no;
+    for (size_t n = 0; n < max_pages && ifs >> file_name >> page_no; n++) {
+        auto it = fds.find(file_name);
+        if (it == fds.end()) {
+            it = fds.emplace(file_name, disk_manager_->FindFd(file_name)).first;
+        }
+        int fd = it->second;
+        // 文件在转储之后可能被删除重建，超出文件大小的页面不读
+        if (fd < 0 || page_no < 0 || page_no >= disk_manager_->get_fd2pageno(fd)) {
+            continue;
+        }
+        if (seen.insert(PageId{fd, page_no}).second) {
+            pages.push_back(PageId{fd, page_no});
+        }
+    }
+    if (pages.empty()) {
+        return;
+    }
+    {
+        std::scoped_lock lock{prewarm_latch_};
+        prewarm_pages_ = std::move(pages);
+        prewarm_next_ = 0;
+        prewarm_running_ = true;
+    }
+    prewarm_ = std::thread(&BufferPoolManager::RunPrewarm, this);
+}
+
+void BufferPoolManager::WaitForPrewarm() {
+    if (prewarm_.joinable()) {
+        prewarm_.join();
+    }
+}
+
+void BufferPoolManager::StopPrewarm() {
+    prewarm_running_ = false;
+    WaitForPrewarm();
+}
+
+/**
+ * @brief 预热线程的主循环：按转储的顺序每次取出下一批页面，批内按文件分组、按 page_no 排序后读入，
+ * 读完或被 StopPrewarm 停止时退出
+ */
+void BufferPoolManager::RunPrewarm() {
+    std::unique_lock lock{prewarm_latch_};
+    size_t loaded = 0;
+    while (prewarm_running_ && prewarm_next_ < prewarm_pages_.size()) {
+        size_t count = std::min(PREWARM_BATCH_PAGES, prewarm_pages_.size() - prewarm_next_);
+        std::vector<PageId> batch(prewarm_pages_.begin() + prewarm_next_,
+                                  prewarm_pages_.begin() + prewarm_next_ + count);
+        prewarm_next_ += count;
+        std::sort(batch.begin(), batch.end(), [](const PageId &a, const PageId &b) {
+            return a.fd != b.fd ? a.fd < b.fd : a.page_no < b.page_no;
+        });
+        for (size_t start = 0; start < batch.size();) {
+            std::vector<page_id_t> page_nos;
+            size_t end = start;
+            for (; end < batch.size() && batch[end].fd == batch[start].fd; end++) {
+                page_nos.push_back(batch[end].page_no);
+            }
+            loaded += PrewarmPages(batch[start].fd, page_nos);
+            start = end;
+        }
+        // 每批之间放开 prewarm_latch_，让等待关闭文件的线程进入
+        lock.unlock();
+        lock.lock();
+    }
+    prewarm_pages_.clear();
+    prewarm_next_ = 0;
+    LOG_INFO("Buffer pool prewarm loaded %zu pages", loaded);
+    prewarm_running_ = false;
+}
+
+/**
+ * @brief 把一批页面按所在分区分组读入空闲帧，等待读完成后使它们可以被淘汰，调用者需持有 prewarm_latch_
+ */
+size_t BufferPoolManager::PrewarmPages(int fd, const std::vector<page_id_t> &page_nos) {
+    std::vector<std::vector<page_id_t>> page_nos_by_instance(instances_.size());
+    for (page_id_t page_no : page_nos) {
+        page_nos_by_instance[GetInstanceIndex(PageId{fd, page_no})].push_back(page_no);
+    }
+    std::vector<IoRequestPtr> requests;
+    for (size_t i = 0; i < instances_.size(); i++) {
+        if (!page_nos_by_instance[i].empty()) {
+            instances_[i]->PrewarmPages(fd, page_nos_by_instance[i], &requests);
+        }
+    }
+    for (auto &request : requests) {
+        try {
+            request->Wait();
+        } catch (UnixError &) {
+            // 读失败的页面由 ReapPrefetches 丢弃
+        }
+    }
+    for (size_t i = 0; i < instances_.size(); i++) {
+        if (!page_nos_by_instance[i].empty()) {
+            std::scoped_lock lock{instances_[i]->latch_};
+            instances_[i]->ReapPrefetches();
+        }
+    }
+    return requests.size();
+}
+
+size_t BufferPoolManager::GetDirtyEvictions() const {
+    size_t dirty_evictions = 0;
+    for (auto &instance : instances_) {
+        dirty_evictions += instance->dirty_evictions_;
+    }
+    return dirty_evictions;
+}
@@ -23,90 +23,180 @@
 //===----------------------------------------------------------------------===//
 
 #pragma once
-#include <fcntl.h>
-#include <unistd.h>
-
-#include <cassert>
-#include <list>
-#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
-#include "common/logger.h"  // for debug
-#include "disk_manager.h"
-#include "errors.h"
-#include "page.h"
-#include "replacer/clock_replacer.h"
-#include "replacer/lru_replacer.h"
-#include "replacer/replacer.h"
+#include "buffer_pool_instance.h"
+#include "page_guard.h"
+
+/**
+ * @brief 一个命名缓冲池的统计信息，见 BufferPoolManager::GetPoolStats
+ */
+struct BufferPoolStats {
+    std::string name;
+    std::string replacer_type;
+    size_t pool_size;
+    size_t max_pool_size;
+    size_t num_pages;        // 驻留的页面数
+    size_t hits;             // FetchPage 命中次数
+    size_t misses;           // FetchPage 缺页次数
+    size_t dirty_evictions;  // 前台换出脏页、同步写回的次数
+};
 
+/**
+ * @brief 缓冲池，由 num_instances 个独立加锁的 BufferPoolInstance 组成
+ * @note 页面按 PageIdHash 的值固定映射到一个分区，不同分区上的 FetchPage/UnpinPage 互不竞争同一个 latch；
+ * 每个分区独立淘汰，只有当页面所在分区的帧全部被 pin 住时才会分配失败。
+ * 缓冲池的大小可以通过 Resize 在线修改，上限为构造时给出的 max_pool_size，分区数不变。
+ * 除默认缓冲池外还可以用 AddPool 添加有独立帧数和替换策略的命名缓冲池（如常驻小表的 keep、大表扫描的 recycle），
+ * 文件通过 SetFilePool 分配到某个缓冲池，它的页面只在该缓冲池的分区中换入换出，不会挤掉其他缓冲池的页面
+ */
 class BufferPoolManager {
    private:
     /**
-     * @brief Number of pages in the buffer pool.
+     * @brief 一个命名缓冲池，由 instances_ 中 [first_instance, first_instance + num_instances) 的分区组成
+     */
+    struct BufferPool {
+        std::string name;
+        std::string replacer_type;
+        size_t first_instance;
+        size_t num_instances;
+        /** Number of pages in the buffer pool. */
+        std::atomic<size_t> pool_size;
+        /** Resize 允许的最大帧数，各分区按它预留帧 */
+        size_t max_pool_size;
+        /** 串行化 Resize */
+        std::mutex resize_latch;
+    };
+
+    /** fd 的上限，与 FileRegistry 的 fd 表一致 */
+    static constexpr int MAX_FILES = FileRegistry::CHUNK_SIZE * FileRegistry::MAX_CHUNKS;
+
+    /** 上层传入disk_manager */
+    DiskManager *disk_manager_;
+    /**
+     * @brief 缓冲池分区，一个命名缓冲池的分区是连续的一段，帧数平均分配，余数分给前面的分区
      */
-    size_t pool_size_;
+    std::vector<std::unique_ptr<BufferPoolInstance>> instances_;
     /**
-     * @brief BufferPool中的Page对象数组(指针)
-     * @note 在构造函数中申请内存空间,折构函数中释放,大小为BUFFER_POOL_SIZE
+     * @brief 命名缓冲池，pools_[0] 为默认缓冲池 DEFAULT_BUFFER_POOL
      */
-    Page *pages_;
+    std::vector<std::unique_ptr<BufferPool>> pools_;
     /**
-     * @brief 以自定义PageIdHash为哈希函数的<PageId,frame_id_t>哈希表.
-     * @note 用于根据PageId定位其在BufferPool中的frame_id_t
+     * @brief 各 fd 所在的缓冲池在 pools_ 中的下标，按 fd 无锁查找；只有默认缓冲池时为 nullptr
      */
-    std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_;
+    std::unique_ptr<std::atomic<uint8_t>[]> file_pools_;
     /**
-     * @brief BufferPool空闲帧的id构成的链表
+     * @brief 各 fd 的访问闸门，与 file_pools_ 一起分配：FILE_MOVING 位表示 SetFilePool 正在移动该文件，
+     * 其余位为正在该文件上 FetchPage/NewPage/PrefetchPages 的线程数；移动期间这些访问在 gate_cv_ 上等待
      */
-    std::list<frame_id_t> free_list_;
-    /** 上层传入disk_manager */
-    DiskManager *disk_manager_;
+    std::unique_ptr<std::atomic<uint32_t>[]> file_gates_;
+    std::mutex gate_latch_;
+    std::condition_variable gate_cv_;
+    static constexpr uint32_t FILE_MOVING = 1u << 31;
 
     /**
-     * @brief BufferPool页面替换策略类
-     *
+     * @brief 后台刷脏线程，见 StartPageCleaner
      */
-    Replacer *replacer_;
+    std::thread cleaner_;
+    std::mutex cleaner_latch_;
+    /** 刷脏线程空闲时在此等待，前台换出脏页或 StopPageCleaner 时唤醒 */
+    std::condition_variable cleaner_cv_;
+    bool cleaner_running_ = false;
 
-    /** This latch protects shared data structures */
-    std::mutex latch_;
+    /**
+     * @brief 各分区共用的压缩页面缓存，见 EnablePageCache
+     */
+    std::unique_ptr<CompressedPageCache> page_cache_;
 
-   public:
-    BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-        : pool_size_(pool_size), disk_manager_(disk_manager) {
-        // We allocate a consecutive memory space for the buffer pool.
-        pages_ = new Page[pool_size_];
-        // can be changed to ClockReplacer
-        if (REPLACER_TYPE.compare("LRU"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else if (REPLACER_TYPE.compare("CLOCK"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else {
-            LOG_WARN("BufferPoolManager Replacer type defined wrong, use LRU as replacer.\n");
-            replacer_ = new LRUReplacer(pool_size_);
-        }
-        // Initially, every page is in the free list.
-        for (size_t i = 0; i < pool_size_; ++i) {
-            free_list_.emplace_back(static_cast<frame_id_t>(i));  // static_cast转换数据类型
-        }
-    }
+    /**
+     * @brief 定期转储热页面列表的后台线程，见 StartPageDumper
+     */
+    std::thread dumper_;
+    std::mutex dumper_latch_;
+    std::condition_variable dumper_cv_;
+    bool dumper_running_ = false;
 
     /**
-     * @brief Destroy the Buffer Pool object
-     *
+     * @brief 后台预热线程，见 StartPrewarm
      */
+    std::thread prewarm_;
+    /**
+     * @brief 保护 prewarm_pages_，预热线程读入一批页面期间一直持有；
+     * DiscardPages 和 SetFilePool 持有它，保证移出文件的页面之后不会再有该文件的预热
+     */
+    std::mutex prewarm_latch_;
+    /**
+     * @brief 待预热的页面，保持转储时从热到冷的顺序，从 prewarm_next_ 开始还没有读入
+     */
+    std::vector<PageId> prewarm_pages_;
+    size_t prewarm_next_ = 0;
+    std::atomic<bool> prewarm_running_{false};
+
+   public:
+    /**
+     * @param replacer_type 替换策略的名称，见 Replacer::Create；默认由环境变量 RUCBASE_REPLACER 或 REPLACER_TYPE 决定
+     * @param max_pool_size Resize 允许的最大帧数，为 0 或小于 pool_size 时等于 pool_size（不能扩容）
+     */
+    BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t num_instances = 1,
+                      const std::string &replacer_type = Replacer::DefaultType(), size_t max_pool_size = 0)
+        : disk_manager_(disk_manager) {
+        CreatePool(DEFAULT_BUFFER_POOL, pool_size, num_instances, replacer_type, max_pool_size);
+    }
+
     ~BufferPoolManager() {
-        delete[] pages_;
-        delete replacer_;
+        StopPageDumper();
+        StopPrewarm();
+        StopPageCleaner();
     }
 
    public:
     /**
      * Fetch the requested page from the buffer pool.
      * @param page_id id of page to be fetched
+     * @param strategy 访问策略，为 nullptr 时使用缓冲池的替换策略，见 GetAccessStrategy
      * @return the requested page
      */
-    Page *FetchPage(PageId page_id);
+    Page *FetchPage(PageId page_id, BufferAccessStrategy *strategy = nullptr) {
+        FileAccess access(this, page_id.fd);
+        size_t index = GetInstanceIndex(page_id);
+        return instances_[index]->FetchPage(page_id, strategy != nullptr ? &strategy->rings_[index] : nullptr);
+    }
+
+    /**
+     * @brief FetchPage，返回持有 pin 的 guard，guard 析构时按帧号 unpin
+     * @return 分区中的帧都被 pin 住时返回空的 guard
+     */
+    BasicPageGuard FetchPageBasic(PageId page_id, BufferAccessStrategy *strategy = nullptr) {
+        FileAccess access(this, page_id.fd);
+        size_t index = GetInstanceIndex(page_id);
+        BufferPoolInstance *instance = instances_[index].get();
+        Page *page = instance->FetchPage(page_id, strategy != nullptr ? &strategy->rings_[index] : nullptr);
+        if (page == nullptr) {
+            return BasicPageGuard();
+        }
+        return BasicPageGuard(instance, instance->GetFrameId(page), page);
+    }
+
+    /**
+     * @brief FetchPage 并对页面加读 latch
+     */
+    ReadPageGuard FetchPageRead(PageId page_id, BufferAccessStrategy *strategy = nullptr) {
+        return FetchPageBasic(page_id, strategy).UpgradeRead();
+    }
+
+    /**
+     * @brief FetchPage 并对页面加写 latch，通过 guard 修改过的页面在 unpin 时自动置脏
+     */
+    WritePageGuard FetchPageWrite(PageId page_id, BufferAccessStrategy *strategy = nullptr) {
+        return FetchPageBasic(page_id, strategy).UpgradeWrite();
+    }
 
     /**
      * Unpin the target page from the buffer pool.
@@ -114,14 +204,14 @@ class BufferPoolManager {
      * @param is_dirty true if the page should be marked as dirty, false otherwise
      * @return false if the page pin count is <= 0 before this call, true otherwise
      */
-    bool UnpinPage(PageId page_id, bool is_dirty);
+    bool UnpinPage(PageId page_id, bool is_dirty) { return GetInstance(page_id)->UnpinPage(page_id, is_dirty); }
 
     /**
      * Flushes the target page to disk.
      * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
      * @return false if the page could not be found in the page table, true otherwise
      */
-    bool FlushPage(PageId page_id);
+    bool FlushPage(PageId page_id) { return GetInstance(page_id)->FlushPage(page_id); }
 
     /**
      * Creates a new page in the buffer pool.
@@ -130,20 +220,263 @@ class BufferPoolManager {
      */
     Page *NewPage(PageId *page_id);
 
+    /**
+     * @brief NewPage，返回持有 pin 的 guard
+     * @param[out] page_id id of created page
+     * @return 分区中的帧都被 pin 住时返回空的 guard
+     */
+    BasicPageGuard NewPageGuarded(PageId *page_id) {
+        Page *page = NewPage(page_id);
+        if (page == nullptr) {
+            return BasicPageGuard();
+        }
+        BufferPoolInstance *instance = GetInstance(*page_id);
+        return BasicPageGuard(instance, instance->GetFrameId(page), page);
+    }
+
     /**
      * Deletes a page from the buffer pool.
      * @param page_id id of page to be deleted
      * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
      */
-    bool DeletePage(PageId page_id);
+    bool DeletePage(PageId page_id) { return GetInstance(page_id)->DeletePage(page_id); }
 
     /**
-     * Flushes all the pages in the buffer pool to disk.
+     * Flushes all the dirty pages of file fd in the buffer pool to disk.
+     * @note 只访问该文件的脏页，代价与缓冲池大小无关
      */
     void FlushAllPages(int fd);
 
+    /**
+     * @brief 把文件 fd 驻留在缓冲池中的页面移出缓冲池，不写回，空出的帧可以直接复用
+     * @note 关闭文件时先 FlushAllPages 再调用，否则之后打开、复用了同一个 fd 的文件会命中旧页面；
+     * 仍被 pin 住的页面不移出
+     */
+    void DiscardPages(int fd);
+
+    /**
+     * @brief 异步预读文件 fd 中从 first_page_no 开始的 count 个页面，提交后立即返回
+     * @note 页面按所在分区分组后交给各分区预读，见 BufferPoolInstance::PrefetchPages
+     */
+    void PrefetchPages(int fd, page_id_t first_page_no, int count, BufferAccessStrategy *strategy = nullptr);
+
+    /**
+     * @brief 为访问文件 fd 中 num_pages 个页面的大扫描或批量读写创建访问策略，访问的页面不多时返回 nullptr
+     * @note 策略只能用于创建它的缓冲池，环只建在文件所在的命名缓冲池中
+     */
+    std::unique_ptr<BufferAccessStrategy> GetAccessStrategy(int fd, size_t num_pages);
+
+    /**
+     * @brief 文件在缓冲池中是否还有比磁盘上更新的页面（脏页，或仍被 pin 住、可能正在被原地修改的页面）
+     * @note 没有这样的页面时，磁盘上的内容就是文件的最新内容，只读扫描可以绕过缓冲池直接读取文件
+     */
+    bool HasUnflushedPages(int fd);
+
+    /**
+     * @brief 启动后台刷脏线程：在页面被淘汰之前写回替换策略接下来要淘汰的脏页，使前台缺页几乎不需要同步写回
+     * @note 每个分区保持 PAGE_CLEANER_CLEAN_PERCENT% 的空闲或干净的可淘汰帧；没有要写的页面时每
+     * PAGE_CLEANER_INTERVAL_MS 毫秒检查一次，前台换出脏页时立即被唤醒
+     */
+    void StartPageCleaner();
+
+    /**
+     * @brief 停止后台刷脏线程，等待正在进行的写回完成
+     */
+    void StopPageCleaner();
+
+    /**
+     * @brief 设置写回页面前调用的日志刷盘函数（WAL 规则），参数为页面 LSN，返回时日志需已持久化到该 LSN
+     * @note 需在缓冲池开始使用之前（或刷脏线程停止时）设置
+     */
+    void SetLogFlusher(const std::function<void(lsn_t)> &flush_log);
+
+    /**
+     * @brief 启用容量为 capacity 字节的压缩页面缓存：换出的页面压缩后放入，缺页时先在其中查找再读磁盘
+     * @note 需在缓冲池开始使用之前调用，见 CompressedPageCache
+     */
+    void EnablePageCache(size_t capacity);
+
+    /** @return 压缩页面缓存，未启用时为 nullptr */
+    CompressedPageCache *GetPageCache() { return page_cache_.get(); }
+
+    /**
+     * @return 启动时压缩页面缓存的容量（字节）：环境变量 RUCBASE_PAGE_CACHE_SIZE，未设置时为 COMPRESSED_PAGE_CACHE_SIZE，
+     * 为 0 表示不启用
+     */
+    static size_t DefaultPageCacheSize();
+
+    /**
+     * @return 各分区的热页面，按替换策略的优先级排列，最不容易被淘汰的在前，见 BufferPoolInstance::CollectHotPages
+     * @note 各分区的列表交替合并
+     */
+    std::vector<PageId> GetHotPages();
+
+    /**
+     * @brief 把热页面列表以 "<文件名> <page_no>" 的形式逐行写入文件 path，最热的在前；已关闭的文件的页面跳过
+     * @note 先写入临时文件再改名，转储中途崩溃不会破坏上一次的列表
+     */
+    void DumpHotPages(const std::string &path);
+
+    /**
+     * @brief 启动后台线程，每 interval_ms 毫秒调用一次 DumpHotPages(path)，预热期间不转储
+     */
+    void StartPageDumper(const std::string &path, int interval_ms);
+
+    void StopPageDumper();
+
+    /**
+     * @brief 按 DumpHotPages 写入的列表在后台预热缓冲池，提交后立即返回，文件不存在时什么也不做
+     * @note 只预热已打开的文件，最多读入缓冲池总帧数的页面；按转储的顺序先读最热的页面，每次读入
+     * PREWARM_BATCH_PAGES 个，批内按文件和 page_no 排序合并读；各分区只使用空闲帧，不会换出前台已经访问的页面
+     */
+    void StartPrewarm(const std::string &path);
+
+    /** @brief 等待预热完成 */
+    void WaitForPrewarm();
+
+    /** @brief 停止预热，等待正在读入的一批页面完成 */
+    void StopPrewarm();
+
+    /**
+     * @return 前台缺页换出脏页、同步写回的总次数
+     */
+    size_t GetDirtyEvictions() const;
+
+    int GetPageSize() const { return instances_[0]->GetPageSize(); }
+
+    void SetPageSize(int page_size);
+
+    /** @return 默认缓冲池的帧数 */
+    size_t GetPoolSize() const { return pools_[0]->pool_size; }
+
+    size_t GetMaxPoolSize() const { return pools_[0]->max_pool_size; }
+
+    /**
+     * @brief 在线修改默认缓冲池的帧数，见 Resize(const std::string &, size_t)
+     */
+    void Resize(size_t pool_size) { Resize(DEFAULT_BUFFER_POOL, pool_size); }
+
+    /**
+     * @brief 在线修改命名缓冲池 name 的帧数，帧数按分区平均分配
+     * @note 扩容立即生效；缩小时等待多出的帧上的 pin 和读写结束并写回其中的脏页，只阻塞调用者，
+     * 其他线程照常访问缓冲池。写回失败时缓冲池停在已经缩小到的大小并抛出异常
+     * @throws InvalidPoolSizeError pool_size 小于分区数或大于 max_pool_size
+     * @throws BufferPoolNotFoundError 没有名为 name 的缓冲池
+     */
+    void Resize(const std::string &name, size_t pool_size);
+
+    /**
+     * @brief 添加一个有独立帧数和替换策略的命名缓冲池，参数含义同构造函数；缓冲池的名字不区分大小写
+     * @note 需在缓冲池开始使用之前、StartPageCleaner/StartPageDumper/StartPrewarm 之前调用：GetInstanceIndex
+     * 和后台线程不加锁地读取 instances_ 和 pools_；新的分区沿用已有的日志刷盘函数和压缩页面缓存
+     * @throws BufferPoolExistsError 已有名为 name 的缓冲池
+     * @throws InternalError 后台线程已经启动
+     */
+    void AddPool(const std::string &name, size_t pool_size, size_t num_instances = 1,
+                 const std::string &replacer_type = Replacer::DefaultType(), size_t max_pool_size = 0);
+
+    /**
+     * @brief 按 "<name>:<size>[:<replacer>],..." 格式的配置添加命名缓冲池，格式错误的项打印警告后跳过
+     * @note 每个缓冲池按每个分区至少 BUFFER_POOL_PARTITION_MIN_SIZE 帧分区，最多 BUFFER_POOL_INSTANCES 个分区，可在线扩容到 size 的
+     * BUFFER_POOL_MAX_SIZE / BUFFER_POOL_SIZE 倍
+     */
+    void AddPools(const std::string &config);
+
+    /**
+     * @return 启动时的命名缓冲池配置：环境变量 RUCBASE_BUFFER_POOLS，未设置时为 BUFFER_POOLS
+     */
+    static std::string DefaultPoolConfig();
+
+    /** @return 是否有名为 name 的缓冲池，不区分大小写 */
+    bool HasPool(const std::string &name) const;
+
+    /**
+     * @brief 把文件 fd 分配到命名缓冲池 name，之后它的页面只在该缓冲池中换入换出
+     * @note 文件已在其他缓冲池中的页面先写回再移出，期间其他线程对该文件的 FetchPage/NewPage 等待移动完成；
+     * 文件关闭时 DiscardPages 把 fd 重新分配给默认缓冲池
+     * @throws BufferPoolNotFoundError 没有名为 name 的缓冲池
+     * @throws InternalError 该文件还有页面被 pin 住，此时不移出任何页面
+     */
+    void SetFilePool(int fd, const std::string &name);
+
+    /** @return 文件 fd 所在的缓冲池添加时的名字 */
+    const std::string &GetFilePool(int fd) const { return pools_[GetPoolIndex(fd)]->name; }
+
+    /**
+     * @return 各命名缓冲池的统计信息，默认缓冲池在最前
+     */
+    std::vector<BufferPoolStats> GetPoolStats();
+
+    /**
+     * @return 启动时的缓冲池大小：环境变量 RUCBASE_BUFFER_POOL_SIZE，未设置时为 BUFFER_POOL_SIZE
+     */
+    static size_t DefaultPoolSize();
+
+    /**
+     * @return 启动时为在线扩容预留的最大帧数：环境变量 RUCBASE_BUFFER_POOL_MAX_SIZE，未设置时为 BUFFER_POOL_MAX_SIZE
+     */
+    static size_t DefaultMaxPoolSize();
+
+    /** @return 所有命名缓冲池的分区总数 */
+    size_t GetNumInstances() const { return instances_.size(); }
+
    private:
-    bool FindVictimPage(frame_id_t *frame_id);
+    void RunPageCleaner();
+
+    void RunPageDumper(const std::string &path, int interval_ms);
+
+    void RunPrewarm();
+
+    /** @return 读入的页面数 */
+    size_t PrewarmPages(int fd, const std::vector<page_id_t> &page_nos);
+
+    void CreatePool(const std::string &name, size_t pool_size, size_t num_instances,
+                    const std::string &replacer_type, size_t max_pool_size);
+
+    /** @return 名为 name（不区分大小写）的缓冲池在 pools_ 中的下标 */
+    size_t FindPool(const std::string &name) const;
+
+    /** @return 文件 fd 所在的缓冲池在 pools_ 中的下标 */
+    size_t GetPoolIndex(int fd) const {
+        if (file_pools_ == nullptr || fd < 0 || fd >= MAX_FILES) {
+            return 0;
+        }
+        return file_pools_[fd].load(std::memory_order_acquire);
+    }
+
+    /** @return 共 pool_size 个帧平均分给 num_instances 个分区时第 i 个分区的帧数，余数分给前面的分区 */
+    static size_t GetPartitionSize(size_t pool_size, size_t num_instances, size_t i) {
+        return pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0);
+    }
+
+    size_t GetInstanceIndex(PageId page_id) const {
+        const BufferPool &pool = *pools_[GetPoolIndex(page_id.fd)];
+        return pool.first_instance + PageIdHash()(page_id) % pool.num_instances;
+    }
+
+    BufferPoolInstance *GetInstance(PageId page_id) { return instances_[GetInstanceIndex(page_id)].get(); }
+
+    /** 进入文件 fd 的访问闸门，文件正在被 SetFilePool 移动时等待移动完成 */
+    void EnterFile(int fd);
+
+    void LeaveFile(int fd);
+
+    /** 关闭文件 fd 的访问闸门，等待已经进入的访问离开 */
+    void CloseFileGate(int fd);
+
+    void OpenFileGate(int fd);
+
+    /** 在作用域内持有文件 fd 的访问闸门，见 file_gates_ */
+    class FileAccess {
+       public:
+        FileAccess(BufferPoolManager *bpm, int fd) : bpm_(bpm), fd_(fd) { bpm_->EnterFile(fd_); }
+
+        ~FileAccess() { bpm_->LeaveFile(fd_); }
+
+        DISALLOW_COPY(FileAccess);
 
-    void UpdatePage(Page *page, PageId new_page_id, frame_id_t new_frame_id);
-};
\ No newline at end of file
+       private:
+        BufferPoolManager *bpm_;
+        int fd_;
+    };
+};
@@ -22,11 +22,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#define private public
 #include "buffer_pool_manager.h"
+#include "compressed_page_cache.h"
+#include "frame_arena.h"
+#undef private  // for use private variables in "buffer_pool_manager.h"
+#include "read_ahead.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <ctime>
+#include <fstream>
+#include <random>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -454,3 +464,1148 @@ TEST_F(BufferPoolManagerTest, ConcurrencyTest) {
 
     disk_manager_->close_file(fd);
 }
+
+/**
+ * @brief 测试非默认页面大小：缓冲池按新的页面大小分配帧，页面在磁盘上按新的页面大小定位
+ */
+TEST_F(BufferPoolManagerTest, LargePageTest) {
+    const std::string filename = "large_page_test";
+    const size_t buffer_pool_size = 4;
+    const int page_size = 4 * PAGE_SIZE;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    bpm->SetPageSize(page_size);
+    EXPECT_EQ(disk_manager->get_page_size(), page_size);
+    EXPECT_THROW(bpm->SetPageSize(PAGE_SIZE + 1), InvalidPageSizeError);
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+
+    std::vector<std::vector<char>> data(buffer_pool_size * 2, std::vector<char>(page_size));
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    for (size_t i = 0; i < data.size(); i++) {
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(page_id.page_no, (page_id_t)i);
+        rand_buf(data[i].data(), page_size);
+        memcpy(page->GetData(), data[i].data(), page_size);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    // 前半部分页面已被换出并写回磁盘
+    for (size_t i = 0; i < data.size(); i++) {
+        Page *page = bpm->FetchPage(PageId{fd, (page_id_t)i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(memcmp(page->GetData(), data[i].data(), page_size), 0);
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+    bpm->FlushAllPages(fd);
+    EXPECT_EQ(disk_manager_->GetFileSize(filename), (int)data.size() * page_size);
+    // 缓冲池中仍有页面时不能修改页面大小
+    EXPECT_THROW(bpm->SetPageSize(PAGE_SIZE), InternalError);
+
+    disk_manager_->close_file(fd);
+}
+
+/**
+ * @brief 预读的页面在 FetchPage 时直接命中，且不占满缓冲池
+ */
+TEST_F(BufferPoolManagerTest, PrefetchTest) {
+    const std::string filename = "prefetch_test";
+    const size_t buffer_pool_size = 16;
+    const int num_pages = 32;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    std::vector<std::vector<char>> data(num_pages, std::vector<char>(PAGE_SIZE));
+    for (int i = 0; i < num_pages; i++) {
+        rand_buf(data[i].data(), PAGE_SIZE);
+        disk_manager->write_page(fd, disk_manager->AllocatePage(fd), data[i].data(), PAGE_SIZE);
+    }
+
+    bpm->PrefetchPages(fd, 0, num_pages);
+    // 正在预读的帧不超过缓冲池的四分之一
+    EXPECT_EQ(bpm->instances_[0]->prefetching_.size(), buffer_pool_size / 4);
+    for (page_id_t i = 0; i < (page_id_t)(buffer_pool_size / 4); i++) {
+        EXPECT_TRUE(bpm->instances_[0]->page_table_.Contains(PageId{fd, i}));
+    }
+
+    ReadAheadWindow read_ahead;
+    for (page_id_t i = 0; i < num_pages; i++) {
+        page_id_t first;
+        int count = read_ahead.OnAccess(i, num_pages, &first);
+        if (count > 0) {
+            bpm->PrefetchPages(fd, first, count);
+        }
+        Page *page = bpm->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(memcmp(page->GetData(), data[i].data(), PAGE_SIZE), 0);
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+    EXPECT_EQ(read_ahead.GetWindow(), READ_AHEAD_MAX_PAGES);
+
+    // 跳跃访问时窗口重置
+    page_id_t first;
+    EXPECT_EQ(read_ahead.OnAccess(3, num_pages, &first), 0);
+    EXPECT_EQ(read_ahead.GetWindow(), READ_AHEAD_MIN_PAGES);
+
+    // 全部页面都在被 pin 时，预读不会发生
+    std::vector<Page *> pinned;
+    for (page_id_t i = 0; i < (page_id_t)buffer_pool_size; i++) {
+        pinned.push_back(bpm->FetchPage(PageId{fd, i}));
+        ASSERT_NE(pinned.back(), nullptr);
+    }
+    bpm->PrefetchPages(fd, buffer_pool_size, 4);
+    EXPECT_TRUE(bpm->instances_[0]->prefetching_.empty());
+    for (Page *page : pinned) {
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+
+    bpm->FlushAllPages(fd);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 多分区缓冲池：页面按哈希固定落在一个分区，各分区独立淘汰，多线程并发读写同一个文件
+ */
+TEST_F(BufferPoolManagerTest, MultiInstanceTest) {
+    const std::string filename = "multi_instance_test";
+    const size_t buffer_pool_size = 18;
+    const size_t num_instances = 4;
+    const int num_pages = 64;
+    const int num_threads = 8;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, num_instances);
+    ASSERT_EQ(bpm->GetNumInstances(), num_instances);
+    size_t total = 0;
+    for (auto &instance : bpm->instances_) {
+        EXPECT_GE(instance->GetPoolSize(), buffer_pool_size / num_instances);
+        total += instance->GetPoolSize();
+    }
+    EXPECT_EQ(total, buffer_pool_size);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    for (int i = 0; i < num_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(page_id.page_no, i);
+        EXPECT_TRUE(bpm->GetInstance(page_id)->page_table_.Contains(page_id));
+        snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // 某个分区的帧全部被 pin 住时，落在该分区的新页面分配失败，页面编号被归还
+    BufferPoolInstance *instance = bpm->GetInstance(PageId{fd, num_pages});
+    std::vector<PageId> pinned;
+    for (page_id_t i = 0; i < num_pages; i++) {
+        PageId page_id = {fd, i};
+        if (bpm->GetInstance(page_id) == instance && pinned.size() < instance->GetPoolSize()) {
+            ASSERT_NE(bpm->FetchPage(page_id), nullptr);
+            pinned.push_back(page_id);
+        }
+    }
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    EXPECT_EQ(bpm->NewPage(&page_id), nullptr);
+    for (auto &id : pinned) {
+        EXPECT_TRUE(bpm->UnpinPage(id, false));
+    }
+    ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+    EXPECT_EQ(page_id.page_no, num_pages);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < num_pages * 4; i++) {
+                page_id_t page_no = (i * 7 + t) % num_pages;
+                Page *page = bpm->FetchPage(PageId{fd, page_no});
+                if (page == nullptr) {
+                    continue;  // 分区暂时被其他线程 pin 满
+                }
+                EXPECT_EQ(std::string(page->GetData()), "page " + std::to_string(page_no));
+                EXPECT_TRUE(bpm->UnpinPage(PageId{fd, page_no}, false));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // 分散在各分区中的页面合并写回
+    bpm->FlushAllPages(fd);
+    EXPECT_FALSE(bpm->HasUnflushedPages(fd));
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+        disk_manager->read_page(fd, i, buf, PAGE_SIZE);
+        EXPECT_EQ(std::string(buf), "page " + std::to_string(i));
+    }
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 缺页的读写不持有 latch：多个线程在很小的缓冲池上反复换入换出脏页，页面内容不会丢失或读到旧版本
+ */
+TEST_F(BufferPoolManagerTest, ConcurrentMissTest) {
+    const std::string filename = "concurrent_miss_test";
+    const size_t buffer_pool_size = 8;
+    const int num_pages = 32;
+    const int num_threads = 4;
+    const int ops_per_thread = 2000;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    for (int i = 0; i < num_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    std::vector<std::mutex> page_latches(num_pages);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int i = 0; i < ops_per_thread; i++) {
+                PageId page_id = {fd, static_cast<page_id_t>(rng() % num_pages)};
+                Page *page;
+                while ((page = bpm->FetchPage(page_id)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                ASSERT_EQ(page->GetPageId(), page_id);
+                {
+                    std::scoped_lock latch{page_latches[page_id.page_no]};
+                    (*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR))++;
+                }
+                EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // 同一页面只占用一个帧，且没有帧停留在换入状态
+    EXPECT_TRUE(bpm->instances_[0]->writing_back_.empty());
+    EXPECT_EQ(bpm->instances_[0]->page_table_.Size(), buffer_pool_size);
+
+    int total = 0;
+    for (int i = 0; i < num_pages; i++) {
+        Page *page = bpm->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_FALSE(page->io_in_progress_);
+        total += *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR);
+        EXPECT_TRUE(bpm->UnpinPage(PageId{fd, i}, false));
+    }
+    EXPECT_EQ(total, num_threads * ops_per_thread);
+    bpm->FlushAllPages(fd);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 大扫描通过访问策略的环读取：只占用环大小的帧，热点页面不被换出，环中写过的页面换出时写回磁盘
+ */
+TEST_F(BufferPoolManagerTest, AccessStrategyTest) {
+    const std::string filename = "access_strategy_test";
+    const size_t buffer_pool_size = 64;
+    const int num_hot_pages = 16;
+    const int num_pages = 256;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    std::vector<char> buf(PAGE_SIZE, 0);
+    for (int i = 0; i < num_pages; i++) {
+        *reinterpret_cast<int *>(buf.data()) = i;
+        disk_manager->write_page(fd, disk_manager->AllocatePage(fd), buf.data(), PAGE_SIZE);
+    }
+    auto instance = bpm->instances_[0].get();
+
+    // 不超过缓冲池 1/4 的访问不需要环
+    EXPECT_EQ(bpm->GetAccessStrategy(fd, buffer_pool_size / 4), nullptr);
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+        for (int j = 0; j < 2; j++) {
+            ASSERT_NE(bpm->FetchPage(PageId{fd, i}), nullptr);
+            EXPECT_TRUE(bpm->UnpinPage(PageId{fd, i}, false));
+        }
+    }
+
+    // 带预读的顺序扫描，每个页面写一次
+    auto strategy = bpm->GetAccessStrategy(fd, num_pages);
+    ASSERT_NE(strategy, nullptr);
+    const size_t ring_size = strategy->GetRingSize();
+    EXPECT_EQ(ring_size, buffer_pool_size / 8);
+    ReadAheadWindow read_ahead;
+    for (page_id_t i = num_hot_pages; i < num_pages; i++) {
+        page_id_t first;
+        int count = read_ahead.OnAccess(i, num_pages, &first);
+        if (count > 0) {
+            bpm->PrefetchPages(fd, first, count, strategy.get());
+        }
+        Page *page = bpm->FetchPage(PageId{fd, i}, strategy.get());
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData()), i);
+        *reinterpret_cast<int *>(page->GetData() + sizeof(int)) = -i;
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), true));
+    }
+    EXPECT_EQ(instance->page_table_.Size(), num_hot_pages + ring_size);
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+        EXPECT_TRUE(instance->page_table_.Contains(PageId{fd, i}));
+    }
+
+    // 环外访问过的页面归缓冲池所有，环不再复用它的帧
+    PageId shared_id = {fd, num_pages - 1};
+    ASSERT_NE(bpm->FetchPage(shared_id), nullptr);
+    EXPECT_TRUE(bpm->UnpinPage(shared_id, false));
+    for (page_id_t i = num_hot_pages; i < num_hot_pages + (page_id_t)ring_size * 2; i++) {
+        ASSERT_NE(bpm->FetchPage(PageId{fd, i}, strategy.get()), nullptr);
+        EXPECT_TRUE(bpm->UnpinPage(PageId{fd, i}, false));
+    }
+    EXPECT_TRUE(instance->page_table_.Contains(shared_id));
+    EXPECT_EQ(instance->page_table_.Size(), num_hot_pages + ring_size + 1);
+
+    // 环中复用的脏页已写回磁盘
+    for (page_id_t i = num_hot_pages; i < num_pages; i++) {
+        Page *page = bpm->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + sizeof(int)), -i);
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+    bpm->FlushAllPages(fd);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 后台刷脏线程提前写回即将被淘汰的脏页：之后的缺页不再同步写回，写回前按 WAL 规则刷日志，页面内容不丢失
+ */
+TEST_F(BufferPoolManagerTest, PageCleanerTest) {
+    const std::string filename = "page_cleaner_test";
+    const size_t buffer_pool_size = 40;
+    const int num_pages = 120;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    std::atomic<lsn_t> flushed_lsn{INVALID_LSN};
+    bpm->SetLogFlusher([&](lsn_t lsn) {
+        lsn_t old = flushed_lsn;
+        while (old < lsn && !flushed_lsn.compare_exchange_weak(old, lsn)) {
+        }
+    });
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    auto instance = bpm->instances_[0].get();
+
+    // 缓冲池中全是脏页
+    for (int i = 0; i < (int)buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = i;
+        page->SetPageLsn(i + 1);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // 等待刷脏线程写回接下来要淘汰的帧
+    const size_t target = buffer_pool_size * PAGE_CLEANER_CLEAN_PERCENT / 100;
+    bpm->StartPageCleaner();
+    auto clean = [&] {
+        std::scoped_lock lock{instance->latch_};
+        std::vector<frame_id_t> victims;
+        instance->replacer_->PeekVictims(target, &victims);
+        return std::none_of(victims.begin(), victims.end(), [&](frame_id_t f) { return instance->pages_[f].is_dirty_; });
+    };
+    for (int i = 0; i < 5000 && !clean(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(clean());
+    EXPECT_GE(flushed_lsn, (lsn_t)target);
+
+    // 淘汰这些帧时不需要同步写回
+    for (int i = 0; i < (int)target; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    EXPECT_EQ(bpm->GetDirtyEvictions(), 0);
+
+    // 刷脏线程运行期间反复换入换出并修改页面，内容不会丢失
+    for (int i = buffer_pool_size + target; i < num_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    std::vector<int> expected(num_pages, 0);
+    for (int i = 0; i < (int)buffer_pool_size; i++) {
+        expected[i] = i;
+    }
+    std::mt19937 rng(0);
+    for (int i = 0; i < 2000; i++) {
+        page_id_t page_no = rng() % num_pages;
+        Page *page = bpm->FetchPage(PageId{fd, page_no});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), expected[page_no]);
+        bool dirty = rng() % 2 == 0;
+        if (dirty) {
+            *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = ++expected[page_no];
+        }
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), dirty));
+    }
+    bpm->StopPageCleaner();
+    EXPECT_TRUE(instance->writing_back_.empty());
+    bpm->FlushAllPages(fd);
+
+    auto reader = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    for (int i = 0; i < num_pages; i++) {
+        Page *page = reader->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), expected[i]);
+        EXPECT_TRUE(reader->UnpinPage(page->GetPageId(), false));
+    }
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 刷脏时日志刷盘或写回失败：页面重新置脏，writing_back_ 被清空，之后的换出和刷脏照常进行
+ */
+TEST_F(BufferPoolManagerTest, PageCleanerErrorTest) {
+    const std::string filename = "page_cleaner_error_test";
+    const size_t buffer_pool_size = 8;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    bool log_failed = true;
+    bpm->SetLogFlusher([&](lsn_t lsn) {
+        if (log_failed) {
+            throw InternalError("log flush failed");
+        }
+    });
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    auto instance = bpm->instances_[0].get();
+    for (int i = 0; i < (int)buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = i + 1;
+        page->SetPageLsn(i + 1);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    auto num_dirty = [&] {
+        std::scoped_lock lock{instance->latch_};
+        size_t dirty = 0;
+        for (size_t i = 0; i < buffer_pool_size; i++) {
+            dirty += instance->pages_[i].is_dirty_ ? 1 : 0;
+        }
+        return dirty;
+    };
+
+    EXPECT_EQ(instance->CleanPages(buffer_pool_size), 0u);
+    EXPECT_EQ(num_dirty(), buffer_pool_size);
+    EXPECT_TRUE(instance->writing_back_.empty());
+
+    log_failed = false;
+    EXPECT_GT(instance->CleanPages(buffer_pool_size), 0u);
+    EXPECT_LT(num_dirty(), buffer_pool_size);
+    EXPECT_TRUE(instance->writing_back_.empty());
+
+    // 换出刷脏后的页面再读回，内容不变
+    for (int i = 0; i < (int)buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    for (int i = 0; i < (int)buffer_pool_size; i++) {
+        Page *page = bpm->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), i + 1);
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+    bpm->FlushAllPages(fd);
+    bpm->DiscardPages(fd);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief page guard 析构时按帧号 unpin，只有通过 GetDataMut/AsMut 修改过的页面被置脏；写 guard 与读 guard 互斥
+ */
+TEST_F(BufferPoolManagerTest, PageGuardTest) {
+    const std::string filename = "page_guard_test";
+    const size_t buffer_pool_size = 4;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    Page *page = nullptr;
+    {
+        WritePageGuard guard = bpm->NewPageGuarded(&page_id).UpgradeWrite();
+        ASSERT_TRUE(guard.IsValid());
+        page = guard.GetPage();
+        strcpy(guard.GetDataMut() + Page::OFFSET_PAGE_HDR, "guard");
+        EXPECT_EQ(page->pin_count_, 1);
+        // 移动不改变 pin 数，被移走的 guard 为空
+        WritePageGuard moved = std::move(guard);
+        EXPECT_FALSE(guard.IsValid());
+        EXPECT_EQ(page->pin_count_, 1);
+    }
+    EXPECT_EQ(page->pin_count_, 0);
+    EXPECT_TRUE(page->IsDirty());
+    EXPECT_TRUE(bpm->FlushPage(page_id));
+    EXPECT_FALSE(page->IsDirty());
+
+    // 读 guard 可以同时持有，不会把页面置脏
+    {
+        ReadPageGuard guard1 = bpm->FetchPageRead(page_id);
+        ReadPageGuard guard2 = bpm->FetchPageRead(page_id);
+        EXPECT_EQ(page->pin_count_, 2);
+        EXPECT_STREQ(guard2.GetData() + Page::OFFSET_PAGE_HDR, "guard");
+        guard1.Drop();
+        EXPECT_EQ(page->pin_count_, 1);
+    }
+    EXPECT_EQ(page->pin_count_, 0);
+    EXPECT_FALSE(page->IsDirty());
+
+    // 写 guard 释放之前，其他线程拿不到读 guard
+    std::atomic<bool> read{false};
+    {
+        WritePageGuard guard = bpm->FetchPageWrite(page_id);
+        std::thread reader([&] {
+            ReadPageGuard guard = bpm->FetchPageRead(page_id);
+            EXPECT_STREQ(guard.GetData() + Page::OFFSET_PAGE_HDR, "latch");
+            read = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(read);
+        strcpy(guard.GetDataMut() + Page::OFFSET_PAGE_HDR, "latch");
+        guard.Drop();
+        reader.join();
+    }
+    EXPECT_TRUE(read);
+    EXPECT_EQ(page->pin_count_, 0);
+
+    // 帧全被 guard pin 住时返回空 guard，guard 析构后帧可以被淘汰
+    {
+        std::vector<BasicPageGuard> guards;
+        for (size_t i = 0; i < buffer_pool_size; i++) {
+            PageId new_page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+            guards.push_back(bpm->NewPageGuarded(&new_page_id));
+            ASSERT_TRUE(guards.back().IsValid());
+        }
+        PageId new_page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        EXPECT_FALSE(bpm->NewPageGuarded(&new_page_id).IsValid());
+    }
+    BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_STREQ(guard.GetData() + Page::OFFSET_PAGE_HDR, "latch");
+    guard.Drop();
+
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 按文件维护驻留页面和脏页：整文件刷盘只写回该文件的脏页，DiscardPages 只移出该文件的页面
+ */
+TEST_F(BufferPoolManagerTest, FilePagesTest) {
+    const size_t buffer_pool_size = 64;
+    const int pages_per_file = 16;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 4);
+    int fds[2];
+    for (int f = 0; f < 2; f++) {
+        std::string filename = "file_pages_test" + std::to_string(f);
+        disk_manager->create_file(filename);
+        fds[f] = disk_manager->open_file(filename);
+        for (int i = 0; i < pages_per_file; i++) {
+            PageId page_id = {.fd = fds[f], .page_no = INVALID_PAGE_ID};
+            Page *page = bpm->NewPage(&page_id);
+            ASSERT_NE(page, nullptr);
+            *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = f * 100 + i;
+            EXPECT_TRUE(bpm->UnpinPage(page_id, i % 2 == 0));
+        }
+    }
+    auto count = [&](int fd, bool dirty) {
+        size_t n = 0;
+        for (auto &instance : bpm->instances_) {
+            n += dirty ? instance->dirty_frames_.Size(fd) : instance->resident_frames_.Size(fd);
+        }
+        return n;
+    };
+    for (int f = 0; f < 2; f++) {
+        EXPECT_EQ(count(fds[f], false), (size_t)pages_per_file);
+        EXPECT_EQ(count(fds[f], true), (size_t)pages_per_file / 2);
+    }
+
+    bpm->FlushAllPages(fds[0]);
+    EXPECT_EQ(count(fds[0], true), 0);
+    EXPECT_EQ(count(fds[1], true), (size_t)pages_per_file / 2);
+    EXPECT_FALSE(bpm->HasUnflushedPages(fds[0]));
+    EXPECT_TRUE(bpm->HasUnflushedPages(fds[1]));
+    // 只有脏页被写回，干净的页面在磁盘上仍是 0
+    std::vector<char> buf(PAGE_SIZE);
+    for (int i = 0; i < pages_per_file; i++) {
+        std::fill(buf.begin(), buf.end(), 0);
+        disk_manager->read_page(fds[0], i, buf.data(), PAGE_SIZE);
+        EXPECT_EQ(*reinterpret_cast<int *>(buf.data() + Page::OFFSET_PAGE_HDR), i % 2 == 0 ? i : 0);
+    }
+
+    // 移出 fds[0] 的页面后再读取，得到的是磁盘上的内容；fds[1] 的页面不受影响
+    bpm->DiscardPages(fds[0]);
+    EXPECT_EQ(count(fds[0], false), 0);
+    EXPECT_EQ(count(fds[1], false), (size_t)pages_per_file);
+    for (int f = 0; f < 2; f++) {
+        for (int i = 0; i < pages_per_file; i++) {
+            Page *page = bpm->FetchPage(PageId{fds[f], i});
+            ASSERT_NE(page, nullptr);
+            int expected = f == 0 && i % 2 != 0 ? 0 : f * 100 + i;
+            EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), expected);
+            EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+        }
+    }
+    bpm->FlushAllPages(fds[1]);
+    for (int f = 0; f < 2; f++) {
+        bpm->DiscardPages(fds[f]);
+        disk_manager->close_file(fds[f]);
+    }
+    for (auto &instance : bpm->instances_) {
+        EXPECT_TRUE(instance->IsEmpty());
+        EXPECT_EQ(instance->free_list_.size(), instance->GetPoolSize());
+    }
+}
+
+/**
+ * @brief 在线修改缓冲池大小：扩容后可以同时 pin 住更多页面；缩小时等待退役帧上的 pin 解除，
+ * 写回其中的脏页，页面内容不丢失；超出 [分区数, max_pool_size] 的大小被拒绝
+ */
+TEST_F(BufferPoolManagerTest, ResizeTest) {
+    const size_t num_instances = 4;
+    const size_t max_pool_size = 64;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager, num_instances, "LRU", max_pool_size);
+    std::string filename = "resize_test";
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    auto pool_size = [&]() {
+        size_t n = 0;
+        for (auto &instance : bpm->instances_) {
+            n += instance->GetPoolSize();
+        }
+        return n;
+    };
+
+    // 扩容后新的帧直接进入各分区的 free_list_
+    bpm->Resize(max_pool_size);
+    EXPECT_EQ(bpm->GetPoolSize(), max_pool_size);
+    EXPECT_EQ(pool_size(), max_pool_size);
+    for (auto &instance : bpm->instances_) {
+        EXPECT_EQ(instance->free_list_.size(), max_pool_size / num_instances);
+    }
+
+    // 留一个退役帧中的页面被 pin 住，缩小要等它 unpin 之后才能完成
+    const size_t new_size = 8;
+    Page *pinned = nullptr;
+    std::vector<PageId> page_ids;
+    for (size_t i = 0; i < max_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = page_id.page_no + 1;
+        page_ids.push_back(page_id);
+        BufferPoolInstance *instance = bpm->GetInstance(page_id);
+        if (pinned == nullptr && static_cast<size_t>(instance->GetFrameId(page)) >= new_size / num_instances) {
+            pinned = page;
+        } else {
+            EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+        }
+    }
+    ASSERT_NE(pinned, nullptr);
+    std::atomic<bool> resized{false};
+    std::thread resizer([&] {
+        bpm->Resize(new_size);
+        resized = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(resized);
+    // 缩小期间其他页面照常访问
+    Page *page = bpm->FetchPage(page_ids[0] == pinned->GetPageId() ? page_ids[1] : page_ids[0]);
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    EXPECT_TRUE(bpm->UnpinPage(pinned->GetPageId(), true));
+    resizer.join();
+    EXPECT_TRUE(resized);
+    EXPECT_EQ(bpm->GetPoolSize(), new_size);
+    EXPECT_EQ(pool_size(), new_size);
+    for (auto &instance : bpm->instances_) {
+        EXPECT_LE(instance->page_table_.Size(), instance->GetPoolSize());
+    }
+
+    // 退役帧中的脏页已写回，所有页面都能读到原来的内容
+    for (PageId page_id : page_ids) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), page_id.page_no + 1);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+
+    EXPECT_THROW(bpm->Resize(num_instances - 1), InvalidPoolSizeError);
+    EXPECT_THROW(bpm->Resize(max_pool_size + 1), InvalidPoolSizeError);
+    EXPECT_EQ(bpm->GetPoolSize(), new_size);
+    bpm->Resize(32);
+    EXPECT_EQ(pool_size(), 32);
+
+    bpm->FlushAllPages(fd);
+    bpm->DiscardPages(fd);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 压缩页面缓存：命中时解压出原来的内容并移出缓存，不可压缩的页面不放入，超出容量时淘汰最久未放入的页面
+ */
+TEST(CompressedPageCacheTest, InsertLookupEvict) {
+    std::vector<char> page(PAGE_SIZE, 0);
+    std::vector<char> out(PAGE_SIZE);
+    auto fill = [&](int value) {
+        std::fill(page.begin(), page.end(), 0);
+        snprintf(page.data(), 32, "row %d", value);
+    };
+    fill(0);
+    CompressedPageCache probe(PAGE_SIZE);
+    probe.Insert(PageId{0, 0}, page.data(), PAGE_SIZE);
+    size_t compressed_size = probe.GetSize();
+    ASSERT_GT(compressed_size, 0u);
+    ASSERT_LT(compressed_size, static_cast<size_t>(PAGE_SIZE) / 4);
+
+    // 容量放得下 4 个页面
+    CompressedPageCache cache(compressed_size * 4 + compressed_size / 2);
+    for (int i = 0; i < 6; i++) {
+        fill(i);
+        cache.Insert(PageId{1, i}, page.data(), PAGE_SIZE);
+    }
+    EXPECT_EQ(cache.GetNumPages(), 4u);
+    EXPECT_LE(cache.GetSize(), cache.GetCapacity());
+    EXPECT_FALSE(cache.Contains(PageId{1, 0}));
+    EXPECT_FALSE(cache.Contains(PageId{1, 1}));
+    for (int i = 2; i < 6; i++) {
+        fill(i);
+        ASSERT_TRUE(cache.Lookup(PageId{1, i}, out.data(), PAGE_SIZE));
+        EXPECT_EQ(memcmp(out.data(), page.data(), PAGE_SIZE), 0);
+        EXPECT_FALSE(cache.Contains(PageId{1, i}));
+    }
+    EXPECT_FALSE(cache.Lookup(PageId{1, 0}, out.data(), PAGE_SIZE));
+    EXPECT_EQ(cache.GetHits(), 4u);
+    EXPECT_EQ(cache.GetMisses(), 1u);
+    EXPECT_EQ(cache.GetSize(), 0u);
+
+    // 不可压缩的页面不放入，且替换掉同一页面旧的副本
+    cache.Insert(PageId{1, 0}, page.data(), PAGE_SIZE);
+    std::mt19937 rng(0);
+    std::generate(page.begin(), page.end(), [&] { return static_cast<char>(rng()); });
+    cache.Insert(PageId{1, 0}, page.data(), PAGE_SIZE);
+    EXPECT_FALSE(cache.Contains(PageId{1, 0}));
+
+    // 页面大小不同时不命中
+    fill(7);
+    cache.Insert(PageId{1, 7}, page.data(), PAGE_SIZE);
+    std::vector<char> large(2 * PAGE_SIZE);
+    EXPECT_FALSE(cache.Lookup(PageId{1, 7}, large.data(), 2 * PAGE_SIZE));
+
+    cache.Insert(PageId{1, 8}, page.data(), PAGE_SIZE);
+    cache.Insert(PageId{2, 8}, page.data(), PAGE_SIZE);
+    cache.Erase(PageId{2, 8});
+    EXPECT_FALSE(cache.Contains(PageId{2, 8}));
+    cache.EraseFile(1);
+    EXPECT_EQ(cache.GetNumPages(), 0u);
+}
+
+/**
+ * @brief 缓冲池启用压缩页面缓存：换出的页面缺页时从缓存中解压，内容不变；删除页面、丢弃文件时缓存中的副本一并丢弃
+ */
+TEST_F(BufferPoolManagerTest, PageCacheTest) {
+    const size_t buffer_pool_size = 8;
+    const int num_pages = 32;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    bpm->EnablePageCache(1 << 20);
+    CompressedPageCache *cache = bpm->GetPageCache();
+    std::string filename = "page_cache_test";
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    for (int i = 0; i < num_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = i + 1;
+        EXPECT_TRUE(bpm->UnpinPage(page_id, i % 2 == 0));
+    }
+    // 除了仍在缓冲池中的页面，其余页面都在压缩缓存中
+    EXPECT_EQ(cache->GetNumPages(), num_pages - buffer_pool_size);
+
+    for (int i = 0; i < num_pages; i++) {
+        Page *page = bpm->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), i + 1);
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+    // 顺序访问比缓冲池大的页面集合，每个页面都缺页，都从缓存中取得
+    EXPECT_EQ(cache->GetHits(), static_cast<size_t>(num_pages));
+    EXPECT_EQ(cache->GetMisses(), 0u);
+    EXPECT_EQ(cache->GetNumPages(), num_pages - buffer_pool_size);
+
+    // 不在缓冲池中的页面被删除后，缓存中的副本也被丢弃
+    PageId deleted = {fd, 0};
+    ASSERT_TRUE(cache->Contains(deleted));
+    EXPECT_TRUE(bpm->DeletePage(deleted));
+    EXPECT_FALSE(cache->Contains(deleted));
+
+    bpm->FlushAllPages(fd);
+    bpm->DiscardPages(fd);
+    EXPECT_EQ(cache->GetNumPages(), 0u);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 页表与 std::unordered_map 对拍：随机插入、修改、删除大编号页面后查找结果一致，删除回移不丢失元素
+ */
+TEST(PageTableTest, RandomOperations) {
+    const size_t max_entries = 1000;
+    PageTable table(max_entries);
+    std::unordered_map<PageId, frame_id_t, PageIdHash> expected;
+    std::mt19937 rng(0);
+    for (int i = 0; i < 200000; i++) {
+        // 编号集中在很小的范围内，制造大量冲突和长探测链
+        PageId page_id = {static_cast<int>(rng() % 3), static_cast<page_id_t>(65536 + rng() % 1500)};
+        frame_id_t frame_id = static_cast<frame_id_t>(rng() % max_entries);
+        if (rng() % 2 == 0 && expected.size() < max_entries) {
+            table.Insert(page_id, frame_id);
+            expected[page_id] = frame_id;
+        } else {
+            EXPECT_EQ(table.Erase(page_id), expected.erase(page_id) == 1);
+        }
+        ASSERT_EQ(table.Size(), expected.size());
+    }
+    for (int fd = 0; fd < 3; fd++) {
+        for (page_id_t page_no = 65536; page_no < 65536 + 1500; page_no++) {
+            PageId page_id = {fd, page_no};
+            frame_id_t frame_id;
+            auto it = expected.find(page_id);
+            ASSERT_EQ(table.Find(page_id, &frame_id), it != expected.end());
+            if (it != expected.end()) {
+                EXPECT_EQ(frame_id, it->second);
+            }
+        }
+    }
+    // 原来的 (fd << 16) | page_no 哈希中 {0, 65536} 与 {1, 0} 冲突
+    EXPECT_NE(PageIdHash()(PageId{0, 65536}), PageIdHash()(PageId{1, 0}));
+}
+
+/**
+ * @brief 帧内存不小于一个大页时按大页对齐映射，较小时退回 aligned_alloc；两种情况下都对齐且已清零，可重复分配
+ */
+TEST(FrameArenaTest, Allocate) {
+    FrameArena arena;
+    for (size_t size : {HUGE_PAGE_SIZE + 3 * PAGE_SIZE, 16 * static_cast<size_t>(PAGE_SIZE), HUGE_PAGE_SIZE}) {
+        arena.Allocate(size);
+        char *data = arena.GetData();
+        ASSERT_NE(data, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT, 0u);
+        if (USE_HUGE_PAGES && size >= HUGE_PAGE_SIZE) {
+            EXPECT_TRUE(arena.IsHugePageBacked());
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % HUGE_PAGE_SIZE, 0u);
+        } else {
+            EXPECT_FALSE(arena.IsHugePageBacked());
+        }
+        EXPECT_EQ(std::count(data, data + size, 0), static_cast<long>(size));
+        memset(data, 'x', size);
+    }
+    arena.Release();
+    EXPECT_EQ(arena.GetData(), nullptr);
+
+    // 帧描述符各占独立的缓存行
+    Page pages[2];
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&pages[0]) % CACHE_LINE_SIZE, 0u);
+    EXPECT_GE(reinterpret_cast<char *>(&pages[1]) - reinterpret_cast<char *>(&pages[0]),
+              static_cast<long>(CACHE_LINE_SIZE));
+}
+
+/**
+ * @brief 命名缓冲池：分配到 recycle 的大文件扫描不会挤掉 keep 中的页面；文件可以在线移到其他缓冲池，
+ * 页面内容不变；关闭文件后 fd 回到默认缓冲池；各缓冲池分别统计命中与缺页
+ */
+TEST_F(BufferPoolManagerTest, NamedPoolTest) {
+    const int num_hot_pages = 8;
+    const int num_scan_pages = 64;
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager, 2, "LRU");
+    bpm->AddPool("keep", num_hot_pages, 1, "LRU", 2 * num_hot_pages);
+    bpm->AddPool("recycle", 4, 2, "CLOCK");
+    EXPECT_THROW(bpm->AddPool("keep", 4), BufferPoolExistsError);
+    EXPECT_TRUE(bpm->HasPool(DEFAULT_BUFFER_POOL));
+    EXPECT_FALSE(bpm->HasPool("unknown"));
+
+    disk_manager->create_file("named_pool_hot");
+    disk_manager->create_file("named_pool_scan");
+    int hot_fd = disk_manager->open_file("named_pool_hot");
+    int scan_fd = disk_manager->open_file("named_pool_scan");
+    EXPECT_EQ(bpm->GetFilePool(hot_fd), DEFAULT_BUFFER_POOL);
+    bpm->SetFilePool(hot_fd, "keep");
+    bpm->SetFilePool(scan_fd, "recycle");
+    EXPECT_THROW(bpm->SetFilePool(scan_fd, "unknown"), BufferPoolNotFoundError);
+    EXPECT_EQ(bpm->GetFilePool(hot_fd), "keep");
+
+    auto write_pages = [&](int fd, int num_pages) {
+        for (int i = 0; i < num_pages; i++) {
+            PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+            Page *page = bpm->NewPage(&page_id);
+            ASSERT_NE(page, nullptr);
+            *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = fd * 1000 + i;
+            EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+        }
+    };
+    auto read_pages = [&](int fd, int num_pages) {
+        for (int i = 0; i < num_pages; i++) {
+            Page *page = bpm->FetchPage(PageId{fd, i});
+            ASSERT_NE(page, nullptr);
+            EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), fd * 1000 + i);
+            EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+        }
+    };
+    auto pool_stats = [&](const std::string &name) {
+        for (auto &stats : bpm->GetPoolStats()) {
+            if (stats.name == name) {
+                return stats;
+            }
+        }
+        ADD_FAILURE() << "no buffer pool " << name;
+        return BufferPoolStats{};
+    };
+
+    write_pages(hot_fd, num_hot_pages);
+    write_pages(scan_fd, num_scan_pages);
+    read_pages(scan_fd, num_scan_pages);
+    // 扫描只在 recycle 中换页，keep 中的页面全部命中
+    read_pages(hot_fd, num_hot_pages);
+    auto keep = pool_stats("keep");
+    EXPECT_EQ(keep.num_pages, static_cast<size_t>(num_hot_pages));
+    EXPECT_EQ(keep.hits, static_cast<size_t>(num_hot_pages));
+    EXPECT_EQ(keep.misses, 0u);
+    EXPECT_EQ(keep.replacer_type, "LRU");
+    auto recycle = pool_stats("recycle");
+    EXPECT_EQ(recycle.pool_size, 4u);
+    EXPECT_LE(recycle.num_pages, 4u);
+    EXPECT_EQ(recycle.misses, static_cast<size_t>(num_scan_pages));
+    EXPECT_EQ(pool_stats(DEFAULT_BUFFER_POOL).num_pages, 0u);
+
+    // 访问策略按文件所在缓冲池的大小决定是否需要环
+    EXPECT_EQ(bpm->GetAccessStrategy(hot_fd, 2), nullptr);
+    EXPECT_NE(bpm->GetAccessStrategy(scan_fd, 2), nullptr);
+
+    // 在线移到默认缓冲池：脏页已写回，页面在默认缓冲池中重新换入
+    bpm->SetFilePool(hot_fd, DEFAULT_BUFFER_POOL);
+    EXPECT_EQ(pool_stats("keep").num_pages, 0u);
+    read_pages(hot_fd, num_hot_pages);
+    EXPECT_EQ(pool_stats(DEFAULT_BUFFER_POOL).misses, static_cast<size_t>(num_hot_pages));
+
+    // 还有页面被 pin 住时不移出任何页面
+    size_t resident = pool_stats(DEFAULT_BUFFER_POOL).num_pages;
+    Page *pinned = bpm->FetchPage(PageId{hot_fd, num_hot_pages - 1});
+    ASSERT_NE(pinned, nullptr);
+    EXPECT_THROW(bpm->SetFilePool(hot_fd, "keep"), InternalError);
+    EXPECT_EQ(pool_stats(DEFAULT_BUFFER_POOL).num_pages, resident);
+    EXPECT_EQ(bpm->GetFilePool(hot_fd), DEFAULT_BUFFER_POOL);
+    EXPECT_TRUE(bpm->UnpinPage(pinned->GetPageId(), false));
+    // 移动期间其他线程对该文件的访问等待闸门打开
+    bpm->CloseFileGate(hot_fd);
+    std::atomic<bool> fetched{false};
+    std::thread reader([&] {
+        Page *page = bpm->FetchPage(PageId{hot_fd, 0});
+        fetched = true;
+        bpm->UnpinPage(page->GetPageId(), false);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(fetched);
+    bpm->OpenFileGate(hot_fd);
+    reader.join();
+    EXPECT_TRUE(fetched);
+
+    bpm->Resize("keep", 2 * num_hot_pages);
+    EXPECT_EQ(pool_stats("keep").pool_size, static_cast<size_t>(2 * num_hot_pages));
+    EXPECT_THROW(bpm->Resize("keep", 2 * num_hot_pages + 1), InvalidPoolSizeError);
+    EXPECT_THROW(bpm->Resize("unknown", 8), BufferPoolNotFoundError);
+
+    for (int fd : {hot_fd, scan_fd}) {
+        bpm->FlushAllPages(fd);
+        bpm->DiscardPages(fd);
+        disk_manager->close_file(fd);
+    }
+    // 关闭后复用同一个 fd 的文件使用默认缓冲池
+    EXPECT_EQ(bpm->GetFilePool(scan_fd), DEFAULT_BUFFER_POOL);
+}
+
+/**
+ * @brief 按 "<name>:<size>[:<replacer>]" 配置命名缓冲池，格式错误的项被跳过，重名（不区分大小写）的项被忽略
+ */
+TEST_F(BufferPoolManagerTest, AddPoolsTest) {
+    auto bpm = std::make_unique<BufferPoolManager>(8, BufferPoolManagerTest::disk_manager_.get());
+    bpm->AddPools("keep:16:LRU,,recycle:4096,bad,zero:0,neg:-1,keep:8");
+    auto stats = bpm->GetPoolStats();
+    ASSERT_EQ(stats.size(), 3u);
+    EXPECT_EQ(stats[0].name, DEFAULT_BUFFER_POOL);
+    EXPECT_EQ(stats[1].name, "keep");
+    EXPECT_EQ(stats[1].pool_size, 16u);
+    EXPECT_EQ(stats[1].replacer_type, "LRU");
+    EXPECT_EQ(stats[2].name, "recycle");
+    EXPECT_EQ(stats[2].max_pool_size, 4096 * (BUFFER_POOL_MAX_SIZE / BUFFER_POOL_SIZE));
+    EXPECT_EQ(bpm->GetNumInstances(), 1 + 1 + 4096 / BUFFER_POOL_PARTITION_MIN_SIZE);
+
+    // 缓冲池的名字不区分大小写
+    EXPECT_TRUE(bpm->HasPool("KEEP"));
+    bpm->Resize("Keep", 32);
+    EXPECT_EQ(bpm->GetPoolStats()[1].pool_size, 32u);
+    EXPECT_THROW(bpm->AddPool("KEEP", 8), BufferPoolExistsError);
+
+    // 刷脏线程启动后不能再添加缓冲池
+    bpm->StartPageCleaner();
+    EXPECT_THROW(bpm->AddPool("late", 8), InternalError);
+    bpm->StopPageCleaner();
+}
+
+/**
+ * @brief 预热：转储的热页面按替换策略的优先级排列（pin 住的在最前，之后从最近访问到最久未访问），
+ * 新的缓冲池按转储的列表读入这些页面，之后的访问全部命中；不存在的文件和超出文件大小的页面被跳过
+ */
+TEST_F(BufferPoolManagerTest, PrewarmTest) {
+    const size_t buffer_pool_size = 16;
+    const int num_pages = 64;
+    const std::string filename = "prewarm_test";
+    const std::string dump_name = "prewarm_test.dump";
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    std::vector<char> buf(PAGE_SIZE, 0);
+    for (int i = 0; i < num_pages; i++) {
+        *reinterpret_cast<int *>(buf.data()) = i;
+        disk_manager->write_page(fd, disk_manager->AllocatePage(fd), buf.data(), PAGE_SIZE);
+    }
+
+    std::vector<PageId> expected;
+    {
+        auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 1, "LRU");
+        auto access = [&](page_id_t first, page_id_t last) {
+            for (page_id_t i = first; i <= last; i++) {
+                ASSERT_NE(bpm->FetchPage(PageId{fd, i}), nullptr);
+                EXPECT_TRUE(bpm->UnpinPage(PageId{fd, i}, false));
+            }
+        };
+        access(40, 47);
+        ASSERT_NE(bpm->FetchPage(PageId{fd, 50}), nullptr);
+        access(10, 16);
+        expected.push_back(PageId{fd, 50});
+        for (page_id_t i = 16; i >= 10; i--) {
+            expected.push_back(PageId{fd, i});
+        }
+        for (page_id_t i = 47; i >= 40; i--) {
+            expected.push_back(PageId{fd, i});
+        }
+        EXPECT_EQ(bpm->GetHotPages(), expected);
+        bpm->DumpHotPages(dump_name);
+        EXPECT_TRUE(bpm->UnpinPage(PageId{fd, 50}, false));
+        bpm->DiscardPages(fd);
+    }
+    {
+        std::ofstream ofs(dump_name, std::ios::app);
+        ofs << "no_such_file 1\n" << filename << ' ' << num_pages << '\n';
+    }
+
+    auto bpm = std::make_unique<BufferPoolManager>(2 * buffer_pool_size, disk_manager, 2, "LRU");
+    bpm->StartPrewarm(dump_name);
+    bpm->WaitForPrewarm();
+    size_t resident = 0;
+    for (auto &instance : bpm->instances_) {
+        resident += instance->page_table_.Size();
+    }
+    EXPECT_EQ(resident, expected.size());
+    for (PageId page_id : expected) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData()), page_id.page_no);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    auto stats = bpm->GetPoolStats()[0];
+    EXPECT_EQ(stats.hits, expected.size());
+    EXPECT_EQ(stats.misses, 0u);
+
+    // 没有转储文件时什么也不做
+    std::remove(dump_name.c_str());
+    bpm->StartPrewarm(dump_name);
+    bpm->WaitForPrewarm();
+
+    bpm->DiscardPages(fd);
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 换出脏页时写回失败：脏页留在缓冲池中并保持脏位，可以再次访问和淘汰，之后的写回恢复正常
+ */
+TEST_F(BufferPoolManagerTest, WriteBackErrorTest) {
+    const std::string filename = "write_back_error_test";
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(1, disk_manager);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    for (int i = 0; i < 2; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        *reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR) = i + 1;
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // 把 fd 换成同一文件的只读描述符，之后的写回都失败
+    int saved_fd = dup(fd);
+    int read_only_fd = open(filename.c_str(), O_RDONLY);
+    ASSERT_GE(saved_fd, 0);
+    ASSERT_GE(read_only_fd, 0);
+    ASSERT_EQ(dup2(read_only_fd, fd), fd);
+    EXPECT_THROW(bpm->FetchPage(PageId{fd, 0}), UnixError);
+
+    // 页面 1 仍在唯一的帧中，内容和脏位都没有丢失，页面 0 没有被换入
+    BufferPoolInstance *instance = bpm->instances_[0].get();
+    frame_id_t frame_id;
+    ASSERT_TRUE(instance->page_table_.Find(PageId{fd, 1}, &frame_id));
+    EXPECT_FALSE(instance->page_table_.Contains(PageId{fd, 0}));
+    EXPECT_TRUE(instance->pages_[frame_id].IsDirty());
+    Page *page = bpm->FetchPage(PageId{fd, 1});
+    ASSERT_NE(page, nullptr);
+    EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), 2);
+    EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+
+    // 恢复写权限后页面 1 可以正常换出，再读回时内容不变
+    ASSERT_EQ(dup2(saved_fd, fd), fd);
+    close(saved_fd);
+    close(read_only_fd);
+    for (int i = 0; i < 2; i++) {
+        page = bpm->FetchPage(PageId{fd, i});
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(*reinterpret_cast<int *>(page->GetData() + Page::OFFSET_PAGE_HDR), i + 1);
+        EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+
+    bpm->FlushAllPages(fd);
+    bpm->DiscardPages(fd);
+    disk_manager->close_file(fd);
+}
@@ -0,0 +1,96 @@
+#include "compressed_page_cache.h"
+
+#include <cstring>
+#include <vector>
+
+#include "page_codec.h"
+
+/**
+ * @brief 压缩在 latch_ 之外进行，只有放入时持有 latch_
+ */
+void CompressedPageCache::Insert(PageId page_id, const char *data, int page_size) {
+    std::vector<char> buffer(page_size / 2);
+    int size = PageCodec::Compress(data, page_size, buffer.data(), static_cast<int>(buffer.size()));
+    std::scoped_lock lock{latch_};
+    auto it = entries_.find(page_id);
+    if (it != entries_.end()) {
+        EraseLocked(it);
+    }
+    if (size < 0 || static_cast<size_t>(size) > capacity_) {
+        return;
+    }
+    while (size_ + size > capacity_) {
+        EraseLocked(entries_.find(lru_.back()));
+    }
+    Entry entry{std::make_unique<char[]>(size), size, page_size, {}};
+    memcpy(entry.data.get(), buffer.data(), size);
+    lru_.push_front(page_id);
+    entry.lru_pos = lru_.begin();
+    entries_.emplace(page_id, std::move(entry));
+    size_ += size;
+}
+
+bool CompressedPageCache::Lookup(PageId page_id, char *data, int page_size) {
+    std::unique_ptr<char[]> compressed;
+    int size;
+    int stored_page_size;
+    {
+        std::scoped_lock lock{latch_};
+        auto it = entries_.find(page_id);
+        if (it == entries_.end()) {
+            misses_++;
+            return false;
+        }
+        compressed = std::move(it->second.data);
+        size = it->second.size;
+        stored_page_size = it->second.page_size;
+        EraseLocked(it);
+    }
+    // 修改页面大小之前放入的副本或解压失败都当作未命中
+    if (stored_page_size != page_size || PageCodec::Decompress(compressed.get(), size, data, page_size) != page_size) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    return true;
+}
+
+bool CompressedPageCache::Contains(PageId page_id) {
+    std::scoped_lock lock{latch_};
+    return entries_.count(page_id) != 0;
+}
+
+void CompressedPageCache::Erase(PageId page_id) {
+    std::scoped_lock lock{latch_};
+    auto it = entries_.find(page_id);
+    if (it != entries_.end()) {
+        EraseLocked(it);
+    }
+}
+
+void CompressedPageCache::EraseFile(int fd) {
+    std::scoped_lock lock{latch_};
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto next = std::next(it);
+        if (it->first.fd == fd) {
+            EraseLocked(it);
+        }
+        it = next;
+    }
+}
+
+size_t CompressedPageCache::GetSize() {
+    std::scoped_lock lock{latch_};
+    return size_;
+}
+
+size_t CompressedPageCache::GetNumPages() {
+    std::scoped_lock lock{latch_};
+    return entries_.size();
+}
+
+void CompressedPageCache::EraseLocked(std::unordered_map<PageId, Entry, PageIdHash>::iterator it) {
+    size_ -= it->second.size;
+    lru_.erase(it->second.lru_pos);
+    entries_.erase(it);
+}
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// compressed_page_cache.h
+//
+// Identification: src/storage/compressed_page_cache.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/macros.h"
+#include "page.h"
+
+/**
+ * @brief 缓冲池与 DiskManager 之间的第二级缓存：被换出的页面用 PageCodec 压缩后按 LRU 存放在内存中
+ * @note 只存放与磁盘内容一致的页面副本，且与缓冲池互斥：页面换出时放入，缺页时命中则取出，
+ * 页面重新进入缓冲池（NewPage）、被删除或文件被关闭时丢弃，因此缓存中的副本不会比磁盘上的旧。
+ * 压缩后不小于页面一半的页面不放入。容量按压缩后的字节数计算，与缓冲池的帧内存分开
+ */
+class CompressedPageCache {
+   public:
+    /**
+     * @param capacity 压缩页面占用的最大字节数
+     */
+    explicit CompressedPageCache(size_t capacity) : capacity_(capacity) {}
+
+    DISALLOW_COPY(CompressedPageCache);
+
+    /**
+     * @brief 压缩并放入页面，替换该页面已有的副本；放不下时先淘汰最久未使用的页面
+     * @param data 页面内容，需与磁盘上的内容一致
+     */
+    void Insert(PageId page_id, const char *data, int page_size);
+
+    /**
+     * @brief 取出页面：命中时解压到 data 并从缓存中移除
+     * @return 是否命中
+     */
+    bool Lookup(PageId page_id, char *data, int page_size);
+
+    bool Contains(PageId page_id);
+
+    /** @brief 丢弃页面的副本，页面不在缓存中时什么也不做 */
+    void Erase(PageId page_id);
+
+    /** @brief 丢弃文件 fd 的全部页面 */
+    void EraseFile(int fd);
+
+    size_t GetCapacity() const { return capacity_; }
+
+    /** @return 压缩页面当前占用的字节数 */
+    size_t GetSize();
+
+    size_t GetNumPages();
+
+    size_t GetHits() const { return hits_; }
+
+    size_t GetMisses() const { return misses_; }
+
+   private:
+    struct Entry {
+        std::unique_ptr<char[]> data;
+        int size;       // 压缩后的字节数
+        int page_size;  // 压缩前的页面大小
+        std::list<PageId>::iterator lru_pos;
+    };
+
+    void EraseLocked(std::unordered_map<PageId, Entry, PageIdHash>::iterator it);
+
+    size_t capacity_;
+    size_t size_ = 0;
+    std::unordered_map<PageId, Entry, PageIdHash> entries_;
+    /** 最近放入的页面在表头 */
+    std::list<PageId> lru_;
+    std::mutex latch_;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+};
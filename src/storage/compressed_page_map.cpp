@@ -0,0 +1,107 @@
+#include "storage/compressed_page_map.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "errors.h"
+
+CompressedPageMap::CompressedPageMap(int page_size) : page_size_(page_size), end_(page_size) {}
+
+std::unique_ptr<CompressedPageMap> CompressedPageMap::Load(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw UnixError();
+    }
+    uint32_t hdr[4];
+    if (pread(fd, hdr, sizeof(hdr), 0) != sizeof(hdr) || hdr[0] != MAGIC) {
+        close(fd);
+        throw InternalError("Invalid compressed page map: " + path);
+    }
+    auto cmap = std::make_unique<CompressedPageMap>(static_cast<int>(hdr[1]));
+    cmap->slots_.resize(hdr[2]);
+    ssize_t size = static_cast<ssize_t>(hdr[2] * sizeof(Slot));
+    ssize_t ret = pread(fd, cmap->slots_.data(), size, sizeof(hdr));
+    close(fd);
+    if (ret != size) {
+        throw InternalError("Invalid compressed page map: " + path);
+    }
+    // 槽位之间的空隙即空闲槽位
+    std::vector<Slot> used;
+    for (auto &slot : cmap->slots_) {
+        if (slot.capacity > 0) {
+            used.push_back(slot);
+        }
+    }
+    std::sort(used.begin(), used.end(), [](const Slot &a, const Slot &b) { return a.offset < b.offset; });
+    uint64_t pos = cmap->page_size_;
+    for (auto &slot : used) {
+        if (slot.offset > pos) {
+            cmap->free_slots_.emplace(static_cast<uint32_t>(slot.offset - pos), pos);
+        }
+        pos = std::max(pos, slot.offset + slot.capacity);
+    }
+    cmap->end_ = pos;
+    cmap->dirty_ = false;
+    return cmap;
+}
+
+void CompressedPageMap::Save(const std::string &path) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        throw UnixError();
+    }
+    uint32_t hdr[4] = {MAGIC, static_cast<uint32_t>(page_size_), static_cast<uint32_t>(slots_.size()), 0};
+    ssize_t size = static_cast<ssize_t>(slots_.size() * sizeof(Slot));
+    if (pwrite(fd, hdr, sizeof(hdr), 0) != sizeof(hdr) || pwrite(fd, slots_.data(), size, sizeof(hdr)) != size) {
+        close(fd);
+        throw UnixError();
+    }
+    if (close(fd) == -1) {
+        throw UnixError();
+    }
+    dirty_ = false;
+    // 旁路文件中的位置表不再引用这些槽位，可以重用了
+    free_slots_.insert(released_.begin(), released_.end());
+    released_.clear();
+}
+
+CompressedPageMap::Slot CompressedPageMap::Lookup(page_id_t page_no) const {
+    if (page_no < 0 || static_cast<size_t>(page_no) >= slots_.size()) {
+        return Slot();
+    }
+    return slots_[page_no];
+}
+
+CompressedPageMap::Slot CompressedPageMap::Assign(page_id_t page_no, uint32_t length) {
+    if (static_cast<size_t>(page_no) >= slots_.size()) {
+        slots_.resize(page_no + 1);
+    }
+    dirty_ = true;
+    Slot &slot = slots_[page_no];
+    if (slot.capacity >= length) {
+        slot.length = length;
+        return slot;
+    }
+    if (slot.capacity > 0) {
+        released_.emplace_back(slot.capacity, slot.offset);
+    }
+    uint32_t capacity = (length + COMPRESSED_SLOT_ALIGNMENT - 1) / COMPRESSED_SLOT_ALIGNMENT * COMPRESSED_SLOT_ALIGNMENT;
+    auto it = free_slots_.lower_bound(capacity);
+    if (it != free_slots_.end()) {
+        // 空闲槽位多出来的部分仍作为空闲槽位
+        slot.offset = it->second;
+        if (it->first > capacity) {
+            free_slots_.emplace(it->first - capacity, it->second + capacity);
+        }
+        free_slots_.erase(it);
+    } else {
+        slot.offset = end_;
+        end_ += capacity;
+    }
+    slot.capacity = capacity;
+    slot.length = length;
+    return slot;
+}
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// compressed_page_map.h
+//
+// Identification: src/storage/compressed_page_map.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * @brief 压缩存储文件的页面位置表，记录每个页面压缩后所在的变长槽位
+ * @note 压缩文件的第 0 页（文件头页）仍以原样存放在 [0, page_size)，其余页面压缩后存放在其后的槽位中；
+ * 位置表持久化在同名的 SUFFIX 旁路文件中，旁路文件存在即表示该文件以压缩方式存储
+ */
+class CompressedPageMap {
+   public:
+    struct Slot {
+        uint64_t offset = 0;    // 槽位在文件中的偏移量
+        uint32_t length = 0;    // 页面压缩后的字节数，为 0 表示页面从未写入，为 page_size 表示不可压缩、原样存放
+        uint32_t capacity = 0;  // 槽位大小，按 COMPRESSED_SLOT_ALIGNMENT 对齐
+    };
+
+    static constexpr const char *SUFFIX = ".cmap";
+
+    explicit CompressedPageMap(int page_size);
+
+    /**
+     * @brief 从旁路文件中加载位置表，并由已占用的槽位推算出空闲槽位
+     */
+    static std::unique_ptr<CompressedPageMap> Load(const std::string &path);
+
+    /**
+     * @brief 写回位置表，之后才能重用此前被释放的槽位
+     */
+    void Save(const std::string &path);
+
+    int GetPageSize() const { return page_size_; }
+
+    Slot Lookup(page_id_t page_no) const;
+
+    /**
+     * @brief 为页面长度为 length 的新内容分配槽位：原槽位放得下时原地覆盖，否则释放原槽位并重新分配
+     * @return 新内容应写入的槽位
+     * @note 释放的原槽位在下一次 Save 成功之前不会被重用：旁路文件中的位置表可能仍指向它，
+     * 崩溃后按旧的位置表读到的仍是该页面的旧内容，而不是别的页面的数据
+     */
+    Slot Assign(page_id_t page_no, uint32_t length);
+
+    /** @return 数据区（含第 0 页）的末尾 */
+    uint64_t GetEnd() const { return end_; }
+
+    bool IsDirty() const { return dirty_; }
+
+    /** 保护位置表以及该文件压缩页面的读写（槽位可能被释放后立即重用） */
+    std::mutex &GetLatch() { return latch_; }
+
+   private:
+    static constexpr uint32_t MAGIC = 0x31504d43;  // "CMP1"
+
+    int page_size_;
+    std::vector<Slot> slots_;                       // 下标为页面编号
+    std::multimap<uint32_t, uint64_t> free_slots_;  // 空闲槽位：大小 -> 偏移量
+    std::vector<std::pair<uint32_t, uint64_t>> released_;  // 上次 Save 之后释放的槽位，Save 后才并入 free_slots_
+    uint64_t end_;
+    bool dirty_ = true;
+    std::mutex latch_;
+};
@@ -2,29 +2,111 @@
 
 #include <assert.h>    // for assert
 #include <string.h>    // for memset
+#include <fcntl.h>     // for fallocate
+#include <limits.h>    // for IOV_MAX
 #include <sys/stat.h>  // for stat
-#include <unistd.h>    // for lseek
+#include <sys/uio.h>   // for pwritev
+#include <unistd.h>    // for pread, pwrite
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <new>
 
 #include "defs.h"
+#include "storage/page_codec.h"
 
-DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char))); }
+DiskManager::DiskManager() {}
 
 /**
  * @brief Write the contents of the specified page into disk file
  *
  */
+static bool is_aligned(const void *ptr, size_t size) {
+    return reinterpret_cast<uintptr_t>(ptr) % DIRECT_IO_ALIGNMENT == 0 && size % DIRECT_IO_ALIGNMENT == 0;
+}
+
+// 按 DIRECT_IO_ALIGNMENT 对齐分配、自动释放的中转缓冲区
+struct AlignedBuffer {
+    explicit AlignedBuffer(size_t size)
+        : size_((size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT) {
+        data_ = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, size_));
+        if (data_ == nullptr) {
+            throw std::bad_alloc();
+        }
+        memset(data_, 0, size_);
+    }
+    ~AlignedBuffer() { std::free(data_); }
+
+    size_t size_;
+    char *data_;
+};
+
 void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek() 定位到文件头，通过 (fd,page_no) 可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用 write() 函数
-    // 注意处理异常
-    int ret = lseek(fd, page_no * PAGE_SIZE, SEEK_SET) != (off_t)(-1);
-    if (ret == -1) {
-        throw UnixError();
+    FileRef file = registry_.Acquire(fd);
+    if (file->cmap != nullptr && page_no != HEADER_PAGE_ID) {
+        write_compressed_page(*file, fd, page_no, offset, num_bytes);
+        return;
     }
-    ret = write(fd, offset, num_bytes);
-    if (ret != num_bytes) {
-        throw UnixError();
+    write_at(fd, static_cast<off_t>(page_no) * page_size_, offset, num_bytes);
+}
+
+void DiskManager::write_pages(int fd, page_id_t start_page_no, const char *const *pages, int num_pages) {
+    FileRef file = registry_.Acquire(fd);
+    if (file->cmap != nullptr) {
+        // 压缩后的页面不再连续，逐页写回
+        for (int i = 0; i < num_pages; i++) {
+            write_page(fd, start_page_no + i, pages[i], page_size_);
+        }
+        return;
+    }
+    if (file->direct) {
+        for (int i = 0; i < num_pages; i++) {
+            if (!is_aligned(pages[i], page_size_)) {
+                // 存在未对齐的页面时逐页写回，由 write_page 负责中转
+                for (int j = 0; j < num_pages; j++) {
+                    write_page(fd, start_page_no + j, pages[j], page_size_);
+                }
+                return;
+            }
+        }
+    }
+    struct iovec iov[IOV_MAX];
+    while (num_pages > 0) {
+        int cnt = std::min(num_pages, IOV_MAX);
+        for (int i = 0; i < cnt; i++) {
+            iov[i].iov_base = const_cast<char *>(pages[i]);
+            iov[i].iov_len = page_size_;
+        }
+        off_t pos = static_cast<off_t>(start_page_no) * page_size_;
+        struct iovec *cur = iov;
+        int left = cnt;
+        while (left > 0) {
+            ssize_t ret = pwritev(fd, cur, left, pos);
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw UnixError();
+            }
+            if (ret == 0) {
+                throw UnixError();
+            }
+            // 部分写：跳过已写完的 iovec，调整未写完的那一个
+            pos += ret;
+            while (left > 0 && static_cast<size_t>(ret) >= cur->iov_len) {
+                ret -= cur->iov_len;
+                cur++;
+                left--;
+            }
+            if (left > 0) {
+                cur->iov_base = static_cast<char *>(cur->iov_base) + ret;
+                cur->iov_len -= ret;
+            }
+        }
+        pages += cnt;
+        start_page_no += cnt;
+        num_pages -= cnt;
     }
 }
 
@@ -32,38 +114,302 @@ void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int
  * @brief Read the contents of the specified page into the given memory area
  */
 void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek() 定位到文件头，通过 (fd,page_no) 可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用 read() 函数
-    // 注意处理异常
-    int ret = lseek(fd, page_no * PAGE_SIZE, SEEK_SET) != (off_t)(-1);
+    FileRef file = registry_.Acquire(fd);
+    if (file->cmap != nullptr && page_no != HEADER_PAGE_ID) {
+        read_compressed_page(*file, fd, page_no, offset, num_bytes);
+        return;
+    }
+    read_at(fd, static_cast<off_t>(page_no) * page_size_, offset, num_bytes);
+}
+
+/**
+ * @brief 从文件的 pos 偏移处读取 num_bytes 个字节，读越过文件末尾时剩余部分保持不变
+ * @note O_DIRECT 文件上的未对齐读：将覆盖的对齐块整块读入中转缓冲区后拷贝所需部分（如 page 0 上的文件头）
+ */
+void DiskManager::read_at(int fd, off_t pos, char *offset, int num_bytes) {
+    if (!file(fd).direct || (is_aligned(offset, num_bytes) && pos % DIRECT_IO_ALIGNMENT == 0)) {
+        // 使用 pread 按偏移量读取，不依赖文件的共享读写位置，多个线程可以并发读写同一个 fd
+        if (pread(fd, offset, num_bytes, pos) == -1) {
+            throw UnixError();
+        }
+        return;
+    }
+    off_t start = pos / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+    size_t skip = pos - start;
+    AlignedBuffer buf(skip + num_bytes);
+    ssize_t ret = pread(fd, buf.data_, buf.size_, start);
     if (ret == -1) {
         throw UnixError();
     }
-    ret = read(fd, offset, num_bytes);
-    if (ret == -1) {
+    if (static_cast<size_t>(ret) > skip) {
+        memcpy(offset, buf.data_ + skip, std::min<size_t>(ret - skip, num_bytes));
+    }
+}
+
+/**
+ * @brief 将 num_bytes 个字节写入文件的 pos 偏移处
+ * @note O_DIRECT 文件上的未对齐写：不足对齐块的部分先读出原内容再覆盖（read-modify-write）
+ */
+void DiskManager::write_at(int fd, off_t pos, const char *offset, int num_bytes) {
+    if (!file(fd).direct || (is_aligned(offset, num_bytes) && pos % DIRECT_IO_ALIGNMENT == 0)) {
+        if (pwrite(fd, offset, num_bytes, pos) != num_bytes) {
+            throw UnixError();
+        }
+        return;
+    }
+    off_t start = pos / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+    size_t skip = pos - start;
+    AlignedBuffer buf(skip + num_bytes);
+    if ((skip != 0 || buf.size_ != static_cast<size_t>(num_bytes)) && pread(fd, buf.data_, buf.size_, start) == -1) {
+        throw UnixError();
+    }
+    memcpy(buf.data_ + skip, offset, num_bytes);
+    if (pwrite(fd, buf.data_, buf.size_, start) != static_cast<ssize_t>(buf.size_)) {
         throw UnixError();
     }
 }
 
+/**
+ * @brief 持有 FileRef 读取文件状态，close_file 不会在读取期间重置它
+ */
+bool DiskManager::is_compressed(int fd) {
+    try {
+        FileRef file = registry_.Acquire(fd);
+        return file->cmap != nullptr;
+    } catch (FileNotOpenError &) {
+        return false;
+    }
+}
+
+bool DiskManager::is_direct_io(int fd) {
+    try {
+        FileRef file = registry_.Acquire(fd);
+        return file->direct;
+    } catch (FileNotOpenError &) {
+        return false;
+    }
+}
+
+IoRequestPtr DiskManager::async_read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
+    auto req = make_io_request(IoOp::READ, fd, page_no, offset, num_bytes);
+    submit_io({req});
+    return req;
+}
+
+IoRequestPtr DiskManager::async_write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
+    auto req = make_io_request(IoOp::WRITE, fd, page_no, const_cast<char *>(offset), num_bytes);
+    submit_io({req});
+    return req;
+}
+
+IoRequestPtr DiskManager::make_io_request(IoOp op, int fd, page_id_t page_no, char *offset, int num_bytes) {
+    return std::make_shared<IoRequest>(op, fd, static_cast<off_t>(page_no) * page_size_, offset, num_bytes);
+}
+
+void DiskManager::submit_io(const std::vector<IoRequestPtr> &requests) {
+    std::vector<IoRequestPtr> to_submit;
+    for (auto &req : requests) {
+        if (is_compressed(req->GetFd())) {
+            run_compressed_io(req);
+        } else {
+            to_submit.push_back(req);
+        }
+    }
+    if (!to_submit.empty()) {
+        get_io_engine()->Submit(to_submit);
+    }
+}
+
+/**
+ * @brief 压缩文件上的页面需要先查位置表、解压，无法交给异步 I/O 引擎，在调用线程中同步完成
+ */
+void DiskManager::run_compressed_io(const IoRequestPtr &request) {
+    page_id_t page_no = static_cast<page_id_t>(request->offset_ / page_size_);
+    try {
+        if (request->op_ == IoOp::READ) {
+            read_page(request->fd_, page_no, request->buf_, request->num_bytes_);
+        } else {
+            write_page(request->fd_, page_no, request->buf_, request->num_bytes_);
+        }
+        request->Complete(request->num_bytes_);
+    } catch (UnixError &) {
+        request->Complete(-errno);
+    } catch (InternalError &) {
+        request->Complete(-EIO);
+    }
+}
+
+/**
+ * @brief 读出压缩文件中页面的完整内容
+ * @return 页面从未写入时返回 false，page 保持不变
+ */
+bool DiskManager::load_compressed_page(FileEntry &entry, int fd, page_id_t page_no, char *page) {
+    CompressedPageMap::Slot slot = entry.cmap->Lookup(page_no);
+    if (slot.length == 0) {
+        return false;
+    }
+    if (slot.length == static_cast<uint32_t>(page_size_)) {
+        read_at(fd, slot.offset, page, page_size_);  // 不可压缩的页面原样存放
+        return true;
+    }
+    std::vector<char> buf(slot.length);
+    read_at(fd, slot.offset, buf.data(), slot.length);
+    if (PageCodec::Decompress(buf.data(), slot.length, page, page_size_) != page_size_) {
+        throw InternalError("Corrupted compressed page " + std::to_string(page_no) + " in " + entry.path);
+    }
+    return true;
+}
+
+void DiskManager::read_compressed_page(FileEntry &entry, int fd, page_id_t page_no, char *offset, int num_bytes) {
+    std::vector<char> page(page_size_);
+    std::scoped_lock lock{entry.cmap->GetLatch()};
+    if (load_compressed_page(entry, fd, page_no, page.data())) {
+        memcpy(offset, page.data(), std::min(num_bytes, page_size_));
+    }
+}
+
+/**
+ * @brief 压缩页面并写入位置表分配的槽位，压缩后不比原页面小时原样存放
+ * @note 只写页面前 num_bytes 个字节时，先读出页面原来的内容再覆盖（read-modify-write）
+ */
+void DiskManager::write_compressed_page(FileEntry &entry, int fd, page_id_t page_no, const char *offset,
+                                        int num_bytes) {
+    CompressedPageMap *cmap = entry.cmap.get();
+    std::vector<char> page(page_size_);
+    std::vector<char> buf(page_size_);
+    std::scoped_lock lock{cmap->GetLatch()};
+    if (num_bytes < page_size_) {
+        load_compressed_page(entry, fd, page_no, page.data());
+    }
+    memcpy(page.data(), offset, std::min(num_bytes, page_size_));
+    const char *data = buf.data();
+    int length = PageCodec::Compress(page.data(), page_size_, buf.data(), page_size_ - 1);
+    if (length <= 0) {
+        data = page.data();
+        length = page_size_;
+    }
+    CompressedPageMap::Slot slot = cmap->Assign(page_no, length);
+    reserve_space(entry, fd, slot.offset + slot.capacity);
+    write_at(fd, slot.offset, data, length);
+}
+
+AsyncIoEngine *DiskManager::get_io_engine() {
+    std::call_once(io_engine_once_, [this] { io_engine_ = AsyncIoEngine::Create(ASYNC_IO_QUEUE_DEPTH); });
+    return io_engine_.get();
+}
+
 /**
  * @brief Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * 有空闲页面表的文件优先复用被释放的页面，否则简单地自增分配，指定文件的页面编号加 1
  */
 page_id_t DiskManager::AllocatePage(int fd) {
-    // Todo:
-    // 简单的自增分配策略，指定文件的页面编号加 1
-    int ret = fd2pageno_[fd];
-    fd2pageno_[fd]++;
-    return ret;
+    FileRef file = registry_.Acquire(fd);
+    FileEntry &entry = *file;
+    page_id_t page_no;
+    if (entry.fsm != nullptr) {
+        std::scoped_lock lock{fsm_latch_};
+        page_no = entry.fsm->Allocate();
+        entry.next_page_no = entry.fsm->GetNumPages();
+    } else {
+        page_no = entry.next_page_no++;
+    }
+    if (entry.cmap == nullptr) {
+        // 压缩文件的空间在写入页面时按槽位预留
+        reserve_space(entry, fd, static_cast<off_t>(page_no + 1) * page_size_);
+    }
+    return page_no;
+}
+
+/**
+ * @brief 保证文件在 [0, end) 范围内的磁盘空间已分配，不够时按 extent_size_ 的整数倍一次性预留
+ * @note 文件系统不支持 fallocate 时放弃预分配，退化为写入时逐页扩展
+ */
+void DiskManager::reserve_space(FileEntry &entry, int fd, off_t end) {
+    if (extent_size_ == 0 || end <= entry.reserved.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::scoped_lock lock{extent_latch_};
+    off_t reserved = entry.reserved;
+    if (end <= reserved) {
+        return;
+    }
+    off_t new_reserved = (end + extent_size_ - 1) / extent_size_ * extent_size_;
+    if (fallocate(fd, FALLOC_FL_KEEP_SIZE, reserved, new_reserved - reserved) == -1) {
+        if (errno != EOPNOTSUPP && errno != ENOSYS) {
+            throw UnixError();
+        }
+        new_reserved = std::numeric_limits<off_t>::max();  // 不再尝试
+    }
+    entry.reserved = new_reserved;
 }
 
 /**
  * @brief Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * 将页面记入文件的空闲页面表，之后的 AllocatePage 可以复用；没有空闲页面表的文件不做处理
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+void DiskManager::DeallocatePage(int fd, page_id_t page_no) {
+    FileRef file = registry_.Acquire(fd);
+    if (file->fsm != nullptr) {
+        std::scoped_lock lock{fsm_latch_};
+        file->fsm->Free(page_no);
+    }
+}
+
+void DiskManager::UndoAllocatePage(int fd, page_id_t page_no) {
+    FileRef file = registry_.Acquire(fd);
+    FileEntry &entry = *file;
+    if (entry.fsm != nullptr) {
+        std::scoped_lock lock{fsm_latch_};
+        entry.fsm->Free(page_no);
+        return;
+    }
+    page_id_t expected = page_no + 1;
+    entry.next_page_no.compare_exchange_strong(expected, page_no);
+}
+
+void DiskManager::create_free_space_map(int fd, page_id_t num_pages) {
+    FileRef file = registry_.Acquire(fd);
+    std::scoped_lock lock{fsm_latch_};
+    file->fsm = std::make_unique<FreeSpaceMap>(num_pages);
+    file->next_page_no = num_pages;
+    flush_free_space_map(*file, fd);
+}
+
+bool DiskManager::has_free_space_map(int fd) {
+    FileRef file = registry_.Acquire(fd);
+    std::scoped_lock lock{fsm_latch_};
+    return file->fsm != nullptr;
+}
+
+bool DiskManager::is_free_page(int fd, page_id_t page_no) {
+    FileRef file = registry_.Acquire(fd);
+    std::scoped_lock lock{fsm_latch_};
+    return file->fsm != nullptr && file->fsm->IsFree(page_no);
+}
+
+/**
+ * @brief 将空闲页面表写回文件头页的尾部，调用者需持有 fsm_latch_
+ */
+void DiskManager::flush_free_space_map(FileEntry &entry, int fd) {
+    FreeSpaceMap *fsm = entry.fsm.get();
+    if (fsm == nullptr || !fsm->IsDirty()) {
+        return;
+    }
+    char buf[FreeSpaceMap::SIZE];
+    fsm->Serialize(buf);
+    write_at(fd, static_cast<off_t>(HEADER_PAGE_ID) * page_size_ + FreeSpaceMap::PAGE_OFFSET, buf, sizeof(buf));
+    fsm->ClearDirty();
+}
+
+/**
+ * @brief 设置页面大小，必须是 [PAGE_SIZE, MAX_PAGE_SIZE] 之间 2 的幂
+ */
+void DiskManager::set_page_size(int page_size) {
+    if (!is_valid_page_size(page_size)) {
+        throw InvalidPageSizeError(page_size);
+    }
+    page_size_ = page_size;
+}
 
 bool DiskManager::is_dir(const std::string &path) {
     struct stat st;
@@ -113,6 +459,9 @@ void DiskManager::create_file(const std::string &path) {
         throw UnixError();
     }
     close(fd);
+    if (compression_ && path != LOG_FILE_NAME) {
+        CompressedPageMap(page_size_).Save(path + CompressedPageMap::SUFFIX);
+    }
 }
 
 /**
@@ -125,13 +474,17 @@ void DiskManager::destroy_file(const std::string &path) {
     if (!is_file(path)) {
         throw FileNotFoundError(path);
     }
-    if (path2fd_.count(path)) {
+    if (registry_.FindFd(path) != -1) {
         throw FileNotClosedError(path);
     }
     int ret = unlink(path.c_str());
     if (ret == -1) {
         throw UnixError();
     }
+    std::string cmap_path = path + CompressedPageMap::SUFFIX;
+    if (is_file(cmap_path) && unlink(cmap_path.c_str()) == -1) {
+        throw UnixError();
+    }
 }
 
 /**
@@ -141,39 +494,91 @@ int DiskManager::open_file(const std::string &path) {
     // Todo:
     // 调用 open() 函数，使用 O_RDWR 模式
     // 注意不能重复打开相同文件，并且需要更新文件打开列表
-    if (path2fd_.count(path)) {
+    if (registry_.FindFd(path) != -1) {
         throw FileNotClosedError(path);
     }
     if (!is_file(path)) {
         throw FileNotFoundError(path);
     }
-    int fd = open(path.c_str(), O_RDWR);
+    bool direct = direct_io_ && path != LOG_FILE_NAME;
+    int fd = open(path.c_str(), direct ? O_RDWR | O_DIRECT : O_RDWR);
+    if (fd == -1 && direct && errno == EINVAL) {
+        // 文件系统不支持 O_DIRECT（如 tmpfs），退化为普通 I/O
+        direct = false;
+        fd = open(path.c_str(), O_RDWR);
+    }
     if (fd == -1) {
         throw UnixError();
     }
-    path2fd_[path.c_str()] = fd;
-    fd2path_[fd] = path.c_str();
+    // fd 由内核分配，在关闭前不会分给其他线程，因此可以在登记之前初始化它的文件状态
+    FileEntry &entry = file(fd);
+    try {
+        entry.path = path;
+        entry.direct = direct;
+        std::string cmap_path = path + CompressedPageMap::SUFFIX;
+        if (path != LOG_FILE_NAME && is_file(cmap_path)) {
+            auto cmap = CompressedPageMap::Load(cmap_path);
+            if (cmap->GetPageSize() != page_size_) {
+                throw InvalidPageSizeError(cmap->GetPageSize());
+            }
+            entry.cmap = std::move(cmap);
+        }
+        if (path != LOG_FILE_NAME) {
+            // 加载文件头页尾部的空闲页面表（如果有）
+            char buf[FreeSpaceMap::SIZE];
+            memset(buf, 0, sizeof(buf));
+            read_at(fd, static_cast<off_t>(HEADER_PAGE_ID) * page_size_ + FreeSpaceMap::PAGE_OFFSET, buf, sizeof(buf));
+            std::scoped_lock lock{fsm_latch_};
+            entry.fsm = FreeSpaceMap::Deserialize(buf);
+            if (entry.fsm != nullptr) {
+                entry.next_page_no = entry.fsm->GetNumPages();
+            }
+        }
+        entry.open.store(true);
+        if (!registry_.Register(path, fd)) {
+            // 其他线程同时打开了同一个文件
+            entry.open.store(false);
+            throw FileNotClosedError(path);
+        }
+    } catch (...) {
+        entry.Reset();
+        close(fd);
+        throw;
+    }
     return fd;
 }
 
 /**
  * @brief 用于关闭指定路径文件
+ * @note 先把文件标记为关闭，等待正在读写该文件的线程（持有 FileRef）结束后再真正关闭
  */
 void DiskManager::close_file(int fd) {
     // Todo:
     // 调用 close() 函数
     // 注意不能关闭未打开的文件，并且需要更新文件打开列表
-    int ret;
-    if (fd2path_.count(fd)) {
-        path2fd_.erase(fd2path_[fd]);
-        fd2path_.erase(fd);
-        ret = close(fd);
-        if (ret == -1) {
-            throw UnixError();
-        }
-    } else {
+    FileEntry *entry = registry_.Get(fd);
+    bool expected = true;
+    if (entry == nullptr || !entry->open.compare_exchange_strong(expected, false)) {
         throw FileNotOpenError(fd);
     }
+    {
+        // 最后一个 FileRef 释放时唤醒这里
+        std::unique_lock lock{entry->close_latch};
+        entry->close_cv.wait(lock, [entry] { return entry->refs.load() == 0; });
+    }
+    {
+        std::scoped_lock lock{fsm_latch_};
+        flush_free_space_map(*entry, fd);
+    }
+    if (entry->cmap != nullptr && entry->cmap->IsDirty()) {
+        entry->cmap->Save(entry->path + CompressedPageMap::SUFFIX);
+    }
+    registry_.Unregister(entry->path);
+    // 必须在 close 之前重置：close 之后 fd 可能立即被其他线程重新打开
+    entry->Reset();
+    if (close(fd) == -1) {
+        throw UnixError();
+    }
 }
 
 int DiskManager::GetFileSize(const std::string &file_name) {
@@ -183,17 +588,13 @@ int DiskManager::GetFileSize(const std::string &file_name) {
 }
 
 std::string DiskManager::GetFileName(int fd) {
-    if (!fd2path_.count(fd)) {
-        throw FileNotOpenError(fd);
-    }
-    return fd2path_[fd];
+    FileRef file = registry_.Acquire(fd);
+    return file->path;
 }
 
 int DiskManager::GetFileFd(const std::string &file_name) {
-    if (!path2fd_.count(file_name)) {
-        return open_file(file_name);
-    }
-    return path2fd_[file_name];
+    int fd = registry_.FindFd(file_name);
+    return fd != -1 ? fd : open_file(file_name);
 }
 
 bool DiskManager::ReadLog(char *log_data, int size, int offset, int prev_log_end) {
@@ -208,8 +609,7 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset, int prev_log_end
     }
 
     size = std::min(size, file_size - offset);
-    lseek(log_fd_, offset, SEEK_SET);
-    ssize_t bytes_read = read(log_fd_, log_data, size);
+    ssize_t bytes_read = pread(log_fd_, log_data, size, offset);
     if (bytes_read != size) {
         throw UnixError();
     }
@@ -222,7 +622,14 @@ void DiskManager::WriteLog(char *log_data, int size) {
     }
 
     // write from the file_end
-    lseek(log_fd_, 0, SEEK_END);
+    off_t end = lseek(log_fd_, 0, SEEK_END);
+    if (end == -1) {
+        throw UnixError();
+    }
+    {
+        FileRef file = registry_.Acquire(log_fd_);
+        reserve_space(*file, log_fd_, end + size);
+    }
     ssize_t bytes_write = write(log_fd_, log_data, size);
     if (bytes_write != size) {
         throw UnixError();
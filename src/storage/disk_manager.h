@@ -19,11 +19,18 @@
 #include <atomic>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/config.h"
 #include "errors.h"  // for throw Exception
+#include "storage/async_io.h"
+#include "storage/compressed_page_map.h"
+#include "storage/file_registry.h"
+#include "storage/free_space_map.h"
 
 /**
  * @brief DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading
@@ -41,6 +48,16 @@ class DiskManager {
      */
     void write_page(int fd, page_id_t page_no, const char *offset, int num_bytes);
 
+    /**
+     * @brief 将 num_pages 个编号连续的完整页面一次性写回 diskFile（pwritev）
+     *
+     * @param fd 页面所在文件开启后的文件描述符
+     * @param start_page_no 第一个页面的编号
+     * @param pages pages[i] 为页面 start_page_no + i 的数据，每个大小为 get_page_size()
+     * @param num_pages 页面个数
+     */
+    void write_pages(int fd, page_id_t start_page_no, const char *const *pages, int num_pages);
+
     /**
      * @brief 读取指定编号的页面部分字节到buffer中
      *
@@ -51,6 +68,28 @@ class DiskManager {
      */
     void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+    /**
+     * @brief 异步读取页面：提交后立即返回，通过 IoRequest::Wait()/IsDone() 获取完成状态
+     * @note 在请求完成前，offset 指向的内存必须保持有效
+     */
+    IoRequestPtr async_read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
+
+    /**
+     * @brief 异步写回页面，语义同 write_page，写入不完整时 Wait() 抛出 UnixError
+     */
+    IoRequestPtr async_write_page(int fd, page_id_t page_no, const char *offset, int num_bytes);
+
+    /**
+     * @brief 构造一个页面 I/O 请求但不提交，配合 submit_io() 批量下发以保持较深的 I/O 队列
+     * @note 异步请求不经过对齐缓冲区，O_DIRECT 文件要求 offset 与 num_bytes 按 DIRECT_IO_ALIGNMENT 对齐
+     */
+    IoRequestPtr make_io_request(IoOp op, int fd, page_id_t page_no, char *offset, int num_bytes);
+
+    void submit_io(const std::vector<IoRequestPtr> &requests);
+
+    /** @return 当前使用的异步 I/O 引擎名称（io_uring 或 thread-pool） */
+    const char *io_engine_name() { return get_io_engine()->Name(); }
+
     /**
      * @brief Allocate a page on disk.
      * @return the page_no of the allocated page
@@ -59,9 +98,27 @@ class DiskManager {
 
     /**
      * @brief Deallocate a page on disk.
-     * @param page_id id of the page to deallocate
+     * @param fd 页面所在文件开启后的文件描述符
+     * @param page_no 要释放的页面编号
+     */
+    void DeallocatePage(int fd, page_id_t page_no);
+
+    /**
+     * @brief 撤销一次 AllocatePage（如缓冲池没有空闲帧、新页面无法放入时）
+     * @note 没有空闲页面表的文件只能撤销最后分配的页面，其间其他线程又分配了页面时留下一个空洞
+     */
+    void UndoAllocatePage(int fd, page_id_t page_no);
+
+    /**
+     * @brief 为已打开的文件创建空闲页面表，之后 AllocatePage 优先复用 DeallocatePage 释放的页面
+     * @param num_pages 文件当前已分配的页面数
+     * @note 空闲页面表持久化在文件头页尾部 [FreeSpaceMap::PAGE_OFFSET, FreeSpaceMap::PAGE_OFFSET + FreeSpaceMap::SIZE)，在 open_file 时加载，close_file 时写回
      */
-    void DeallocatePage(page_id_t page_id);
+    void create_free_space_map(int fd, page_id_t num_pages);
+
+    bool has_free_space_map(int fd);
+
+    bool is_free_page(int fd, page_id_t page_no);
 
     // 目录操作
     bool is_dir(const std::string &path);
@@ -87,6 +144,9 @@ class DiskManager {
 
     int GetFileFd(const std::string &file_name);
 
+    /** @return 已打开的文件 file_name 的 fd，未打开时返回 -1，不会打开文件 */
+    int FindFd(const std::string &file_name) const { return registry_.FindFd(file_name); }
+
     // LOG操作
     bool ReadLog(char *log_data, int size, int offset, int prev_log_end);
 
@@ -97,17 +157,89 @@ class DiskManager {
     int GetLogFd() { return log_fd_; }
 
     // 在fd对应文件中，从start_page_no开始分配page_no
-    void set_fd2pageno(int fd, int start_page_no) { fd2pageno_[fd] = start_page_no; }
+    void set_fd2pageno(int fd, int start_page_no) { file(fd).next_page_no = start_page_no; }
+
+    page_id_t get_fd2pageno(int fd) { return file(fd).next_page_no; }
+
+    /**
+     * @brief 开启/关闭 direct I/O，只影响之后打开的数据文件，日志文件始终经过 page cache
+     * @note 开启后 buffer pool 成为页面的唯一缓存；文件系统不支持 O_DIRECT 时自动退化为普通 I/O
+     */
+    void set_direct_io(bool enable) { direct_io_ = enable; }
+
+    /**
+     * @brief 设置文件预分配的粒度：页面或日志写到已预留空间之外时，用 fallocate 一次预留 extent_size 字节
+     * @note 预留空间不改变文件大小（FALLOC_FL_KEEP_SIZE），为 0 时不做预分配
+     */
+    void set_extent_size(size_t extent_size) { extent_size_ = extent_size; }
+
+    /**
+     * @brief 设置数据库的页面大小，页面编号 page_no 在文件中的偏移量为 page_no * page_size
+     * @note 页面大小是数据库级别的属性，在 create_db 时确定并记录在 DbMeta 中，open_db 时通过 BufferPoolManager::SetPageSize 设置
+     */
+    void set_page_size(int page_size);
+
+    int get_page_size() const { return page_size_; }
 
-    page_id_t get_fd2pageno(int fd) { return fd2pageno_[fd]; }
+    static bool is_valid_page_size(int page_size) {
+        return page_size >= PAGE_SIZE && page_size <= MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+    }
 
-    static constexpr int MAX_FD = 8192;
+    /**
+     * @brief 开启/关闭压缩存储，只影响之后创建的数据文件
+     * @note 压缩文件写回页面时用 PageCodec 压缩后存放在变长槽位中，读取时解压；页面位置表存放在
+     * 文件名加 CompressedPageMap::SUFFIX 的旁路文件中，open_file 时根据旁路文件是否存在识别压缩文件
+     */
+    void set_compression(bool enable) { compression_ = enable; }
+
+    /** @return fd 对应的文件是否以压缩方式存储，文件未打开时返回 false */
+    bool is_compressed(int fd);
+
+    /** @return fd 是否以 O_DIRECT 方式打开，文件未打开时返回 false */
+    bool is_direct_io(int fd);
 
    private:
-    // 文件打开列表，用于记录文件是否被打开
-    std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
-    std::unordered_map<int, std::string> fd2path_;  //<Page fd,Page文件磁盘路径>哈希表
+    // fd 对应的文件状态（无锁），调用者需保证 fd 已打开或持有其 FileRef
+    FileEntry &file(int fd) { return *registry_.GetOrCreate(fd); }
+
+    AsyncIoEngine *get_io_engine();
+
+    // 按字节偏移量读写，O_DIRECT 文件上未对齐的读写通过对齐的中转缓冲区完成；
+    // 调用者需持有 fd 的 FileRef，或是 open_file 在登记之前读取
+    void read_at(int fd, off_t pos, char *offset, int num_bytes);
+
+    void write_at(int fd, off_t pos, const char *offset, int num_bytes);
+
+    // 以下辅助函数的 entry 为 fd 的文件状态，由调用者持有其 FileRef（close_file 中则已等待引用归零）
+    void flush_free_space_map(FileEntry &entry, int fd);
+
+    void reserve_space(FileEntry &entry, int fd, off_t end);
+
+    // 压缩文件上除第 0 页之外的页面读写；load_compressed_page 读出完整页面，调用者需持有位置表的 latch
+    bool load_compressed_page(FileEntry &entry, int fd, page_id_t page_no, char *page);
+
+    void read_compressed_page(FileEntry &entry, int fd, page_id_t page_no, char *offset, int num_bytes);
+
+    void write_compressed_page(FileEntry &entry, int fd, page_id_t page_no, const char *offset, int num_bytes);
+
+    // 在调用线程中同步完成压缩文件上的异步请求
+    void run_compressed_io(const IoRequestPtr &request);
+
+    // 文件打开列表，用于记录文件是否被打开，以及每个已打开文件的状态
+    FileRegistry registry_;
+
+    int log_fd_ = -1;            // log file
+    int page_size_ = PAGE_SIZE;  // 页面大小
+
+    bool direct_io_ = USE_DIRECT_IO;  // 新打开的数据文件是否使用 O_DIRECT
+
+    size_t extent_size_ = FILE_EXTENT_SIZE;  // fallocate 预分配的粒度
+    std::mutex extent_latch_;
+
+    std::mutex fsm_latch_;  // 保护各文件的空闲页面表
+
+    bool compression_ = USE_PAGE_COMPRESSION;  // 新创建的数据文件是否压缩存储
 
-    int log_fd_ = -1;                             // log file
-    std::atomic<page_id_t> fd2pageno_[MAX_FD]{};  // 在文件fd中分配的page no个数
+    std::unique_ptr<AsyncIoEngine> io_engine_;  // 首次发起异步 I/O 时创建
+    std::once_flag io_engine_once_;
 };
@@ -11,9 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "disk_manager.h"
+#include "page_codec.h"
 
 #include <cassert>
 #include <cstring>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -159,3 +161,368 @@ TEST_F(DiskManagerTest, PageOperation) {
     disk_manager_->destroy_file(filename);
     EXPECT_EQ(disk_manager_->is_file(filename), false);
 }
+
+/**
+ * @brief 测试异步读写页面：批量提交写请求，再批量异步读回校验，分别覆盖 io_uring 与线程池引擎
+ */
+TEST_F(DiskManagerTest, AsyncPageOperation) {
+    const std::string filename = "AsyncPageOperationTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+
+    std::vector<std::unique_ptr<AsyncIoEngine>> engines;
+    engines.push_back(std::make_unique<ThreadPoolIoEngine>());
+    if (auto uring = IoUringEngine::Create(8)) {  // 队列深度小于页面数，同时覆盖提交时的背压
+        engines.push_back(std::move(uring));
+    }
+
+    std::vector<char> data(MAX_PAGES * PAGE_SIZE);
+    std::vector<char> buf(MAX_PAGES * PAGE_SIZE);
+    for (auto &engine : engines) {
+        rand_buf(data.data(), data.size());
+        std::vector<IoRequestPtr> writes;
+        for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+            writes.push_back(std::make_shared<IoRequest>(IoOp::WRITE, fd, (off_t)page_no * PAGE_SIZE,
+                                                         data.data() + page_no * PAGE_SIZE, PAGE_SIZE));
+        }
+        engine->Submit(writes);
+        for (auto &req : writes) {
+            EXPECT_EQ(req->Wait(), PAGE_SIZE);
+        }
+
+        std::fill(buf.begin(), buf.end(), 0);
+        std::vector<IoRequestPtr> reads;
+        for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+            reads.push_back(std::make_shared<IoRequest>(IoOp::READ, fd, (off_t)page_no * PAGE_SIZE,
+                                                        buf.data() + page_no * PAGE_SIZE, PAGE_SIZE));
+        }
+        engine->Submit(reads);
+        for (auto &req : reads) {
+            EXPECT_EQ(req->Wait(), PAGE_SIZE);
+        }
+        EXPECT_EQ(std::memcmp(buf.data(), data.data(), buf.size()), 0) << engine->Name();
+    }
+
+    // 通过 DiskManager 接口异步写入，同步读回
+    char page[PAGE_SIZE];
+    rand_buf(page, PAGE_SIZE);
+    disk_manager_->async_write_page(fd, 3, page, PAGE_SIZE)->Wait();
+    char out[PAGE_SIZE] = {0};
+    auto req = disk_manager_->async_read_page(fd, 3, out, PAGE_SIZE);
+    EXPECT_EQ(req->Wait(), PAGE_SIZE);
+    EXPECT_TRUE(req->IsDone());
+    EXPECT_EQ(std::memcmp(out, page, PAGE_SIZE), 0);
+
+    disk_manager_->close_file(fd);
+    disk_manager_->destroy_file(filename);
+}
+
+/**
+ * @brief 测试批量写回编号连续的页面 write_pages
+ */
+TEST_F(DiskManagerTest, VectoredPageWrite) {
+    const std::string filename = "VectoredPageWriteTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+
+    std::vector<char> data(MAX_PAGES * PAGE_SIZE);
+    rand_buf(data.data(), data.size());
+    std::vector<const char *> pages;
+    for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+        pages.push_back(data.data() + page_no * PAGE_SIZE);
+    }
+    // 从第 1 页开始写回 MAX_PAGES - 1 个页面，第 0 页单独写
+    disk_manager_->write_pages(fd, 1, pages.data() + 1, MAX_PAGES - 1);
+    disk_manager_->write_page(fd, 0, pages[0], PAGE_SIZE);
+
+    char buf[PAGE_SIZE];
+    for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+        disk_manager_->read_page(fd, page_no, buf, PAGE_SIZE);
+        EXPECT_EQ(std::memcmp(buf, pages[page_no], PAGE_SIZE), 0);
+    }
+    EXPECT_EQ(disk_manager_->GetFileSize(filename), MAX_PAGES * PAGE_SIZE);
+
+    disk_manager_->close_file(fd);
+    disk_manager_->destroy_file(filename);
+}
+
+/**
+ * @brief 测试 direct I/O 模式：对齐的整页读写直接下发，未对齐的部分读写经过中转缓冲区
+ */
+TEST_F(DiskManagerTest, DirectIO) {
+    const std::string filename = "DirectIOTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    disk_manager_->set_direct_io(true);
+    int fd = disk_manager_->open_file(filename);  // 文件系统不支持 O_DIRECT 时退化为普通 I/O，下面的读写语义不变
+
+    char *aligned = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, PAGE_SIZE));
+    char *out = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, PAGE_SIZE));
+    rand_buf(aligned, PAGE_SIZE);
+    disk_manager_->write_page(fd, 1, aligned, PAGE_SIZE);
+    disk_manager_->read_page(fd, 1, out, PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(out, aligned, PAGE_SIZE), 0);
+
+    // 部分写只覆盖页面开头，页面其余部分保持不变
+    char hdr[100];
+    rand_buf(hdr, sizeof(hdr));
+    disk_manager_->write_page(fd, 1, hdr, sizeof(hdr));
+    char small[200];
+    disk_manager_->read_page(fd, 1, small, sizeof(small));
+    EXPECT_EQ(std::memcmp(small, hdr, sizeof(hdr)), 0);
+    EXPECT_EQ(std::memcmp(small + sizeof(hdr), aligned + sizeof(hdr), sizeof(small) - sizeof(hdr)), 0);
+
+    // 未对齐的整页缓冲区
+    std::vector<char> unaligned(PAGE_SIZE + 1);
+    rand_buf(unaligned.data() + 1, PAGE_SIZE);
+    const char *pages[] = {aligned, unaligned.data() + 1};
+    disk_manager_->write_pages(fd, 2, pages, 2);
+    disk_manager_->read_page(fd, 3, out, PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(out, unaligned.data() + 1, PAGE_SIZE), 0);
+
+    std::free(aligned);
+    std::free(out);
+    disk_manager_->close_file(fd);
+    disk_manager_->set_direct_io(false);
+    disk_manager_->destroy_file(filename);
+}
+
+/**
+ * @brief 测试空闲页面表：释放的页面被优先复用，且关闭后重新打开文件时仍然保留
+ */
+TEST_F(DiskManagerTest, FreeSpaceMap) {
+    const std::string filename = "FreeSpaceMapTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+    EXPECT_FALSE(disk_manager_->has_free_space_map(fd));
+
+    // 文件头写在第 0 页开头，不能覆盖空闲页面表
+    char hdr[32];
+    rand_buf(hdr, sizeof(hdr));
+    disk_manager_->create_free_space_map(fd, 1);
+    disk_manager_->write_page(fd, HEADER_PAGE_ID, hdr, sizeof(hdr));
+    for (int page_no = 1; page_no < MAX_PAGES; page_no++) {
+        EXPECT_EQ(disk_manager_->AllocatePage(fd), page_no);
+    }
+    disk_manager_->DeallocatePage(fd, 7);
+    disk_manager_->DeallocatePage(fd, 3);
+    disk_manager_->DeallocatePage(fd, 100);
+    EXPECT_TRUE(disk_manager_->is_free_page(fd, 3));
+    EXPECT_EQ(disk_manager_->AllocatePage(fd), 3);
+    EXPECT_FALSE(disk_manager_->is_free_page(fd, 3));
+    disk_manager_->close_file(fd);
+
+    fd = disk_manager_->open_file(filename);
+    EXPECT_TRUE(disk_manager_->has_free_space_map(fd));
+    char buf[sizeof(hdr)];
+    disk_manager_->read_page(fd, HEADER_PAGE_ID, buf, sizeof(buf));
+    EXPECT_EQ(std::memcmp(buf, hdr, sizeof(hdr)), 0);
+    EXPECT_EQ(disk_manager_->get_fd2pageno(fd), MAX_PAGES);
+    EXPECT_EQ(disk_manager_->AllocatePage(fd), 7);
+    EXPECT_EQ(disk_manager_->AllocatePage(fd), 100);
+    EXPECT_EQ(disk_manager_->AllocatePage(fd), MAX_PAGES);
+
+    disk_manager_->close_file(fd);
+    disk_manager_->destroy_file(filename);
+}
+
+/**
+ * @brief 测试按 extent 预分配：分配页面时用 fallocate 预留磁盘空间，但不改变文件大小
+ */
+TEST_F(DiskManagerTest, ExtentPreallocation) {
+    const std::string filename = "ExtentPreallocationTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+    disk_manager_->set_fd2pageno(fd, 0);
+
+    EXPECT_EQ(disk_manager_->AllocatePage(fd), 0);
+    EXPECT_EQ(disk_manager_->GetFileSize(filename), 0);
+    struct stat st;
+    ASSERT_EQ(fstat(fd, &st), 0);
+    if (st.st_blocks > 0) {  // 文件系统支持 fallocate
+        EXPECT_GE(st.st_blocks * 512, (blkcnt_t)FILE_EXTENT_SIZE);
+    }
+    for (int page_no = 1; page_no < MAX_PAGES; page_no++) {
+        EXPECT_EQ(disk_manager_->AllocatePage(fd), page_no);
+    }
+    char data[PAGE_SIZE];
+    rand_buf(data, PAGE_SIZE);
+    disk_manager_->write_page(fd, MAX_PAGES - 1, data, PAGE_SIZE);
+    EXPECT_EQ(disk_manager_->GetFileSize(filename), MAX_PAGES * PAGE_SIZE);
+
+    disk_manager_->close_file(fd);
+    disk_manager_->destroy_file(filename);
+}
+
+/**
+ * @brief 测试压缩存储：补 0 的页面压缩后占用的空间远小于原页面，不可压缩的页面原样存放，重新打开后内容不变
+ */
+TEST_F(DiskManagerTest, CompressedPageOperation) {
+    const std::string filename = "CompressedPageTestFile";
+    const std::string cmap_filename = filename + CompressedPageMap::SUFFIX;
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->set_compression(true);
+    disk_manager_->create_file(filename);
+    disk_manager_->set_compression(false);
+    EXPECT_TRUE(disk_manager_->is_file(cmap_filename));
+    int fd = disk_manager_->open_file(filename);
+    EXPECT_TRUE(disk_manager_->is_compressed(fd));
+
+    // 每个页面只有开头的少量随机数据，其余为 0
+    std::vector<std::vector<char>> pages(MAX_PAGES, std::vector<char>(PAGE_SIZE, 0));
+    for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+        rand_buf(pages[page_no].data(), 64);
+        disk_manager_->write_page(fd, page_no, pages[page_no].data(), PAGE_SIZE);
+    }
+    // 不可压缩的页面
+    rand_buf(pages[1].data(), PAGE_SIZE);
+    disk_manager_->write_page(fd, 1, pages[1].data(), PAGE_SIZE);
+    // 只写页面开头的部分字节
+    rand_buf(pages[2].data(), 16);
+    disk_manager_->write_page(fd, 2, pages[2].data(), 16);
+
+    char buf[PAGE_SIZE];
+    for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+        disk_manager_->read_page(fd, page_no, buf, PAGE_SIZE);
+        EXPECT_EQ(memcmp(buf, pages[page_no].data(), PAGE_SIZE), 0);
+    }
+    auto req = disk_manager_->async_read_page(fd, 3, buf, PAGE_SIZE);
+    EXPECT_EQ(req->Wait(), PAGE_SIZE);
+    EXPECT_EQ(memcmp(buf, pages[3].data(), PAGE_SIZE), 0);
+    EXPECT_LT(disk_manager_->GetFileSize(filename), MAX_PAGES * PAGE_SIZE / 4);
+
+    disk_manager_->close_file(fd);
+    fd = disk_manager_->open_file(filename);
+    EXPECT_TRUE(disk_manager_->is_compressed(fd));
+    // 原地覆盖以及槽位重新分配后内容不变
+    pages[3].assign(PAGE_SIZE, 0);
+    rand_buf(pages[4].data(), PAGE_SIZE);
+    disk_manager_->write_page(fd, 3, pages[3].data(), PAGE_SIZE);
+    disk_manager_->write_page(fd, 4, pages[4].data(), PAGE_SIZE);
+    for (int page_no = 0; page_no < MAX_PAGES; page_no++) {
+        disk_manager_->read_page(fd, page_no, buf, PAGE_SIZE);
+        EXPECT_EQ(memcmp(buf, pages[page_no].data(), PAGE_SIZE), 0);
+    }
+    disk_manager_->close_file(fd);
+
+    disk_manager_->destroy_file(filename);
+    EXPECT_FALSE(disk_manager_->is_file(cmap_filename));
+}
+
+/**
+ * @brief 测试压缩页面位置表：释放的槽位在位置表写回之前不被重用，写回之后才能分配给其他页面
+ */
+TEST_F(DiskManagerTest, CompressedPageMapSlotReuse) {
+    const std::string cmap_filename = std::string("CompressedPageMapTestFile") + CompressedPageMap::SUFFIX;
+    CompressedPageMap cmap(PAGE_SIZE);
+    CompressedPageMap::Slot old_slot = cmap.Assign(0, 100);
+    cmap.Save(cmap_filename);
+
+    // 页面 0 变大后换到新的槽位，旁路文件中的位置表仍指向原槽位
+    CompressedPageMap::Slot new_slot = cmap.Assign(0, PAGE_SIZE);
+    EXPECT_NE(new_slot.offset, old_slot.offset);
+    EXPECT_NE(cmap.Assign(1, 100).offset, old_slot.offset);
+    EXPECT_EQ(CompressedPageMap::Load(cmap_filename)->Lookup(0).offset, old_slot.offset);
+
+    cmap.Save(cmap_filename);
+    EXPECT_EQ(cmap.Assign(2, 100).offset, old_slot.offset);
+    unlink(cmap_filename.c_str());
+}
+
+/**
+ * @brief 测试页面压缩算法：压缩后能还原，损坏的数据能被检测出来
+ */
+TEST_F(DiskManagerTest, PageCodec) {
+    std::vector<char> page(MAX_PAGE_SIZE, 0);
+    std::vector<char> compressed(MAX_PAGE_SIZE);
+    std::vector<char> out(MAX_PAGE_SIZE);
+    for (int i = 0; i < MAX_PAGE_SIZE; i += 300) {
+        rand_buf(page.data() + i, 40);
+    }
+    int len = PageCodec::Compress(page.data(), MAX_PAGE_SIZE, compressed.data(), MAX_PAGE_SIZE);
+    ASSERT_GT(len, 0);
+    EXPECT_LT(len, MAX_PAGE_SIZE / 4);
+    EXPECT_EQ(PageCodec::Decompress(compressed.data(), len, out.data(), MAX_PAGE_SIZE), MAX_PAGE_SIZE);
+    EXPECT_EQ(memcmp(page.data(), out.data(), MAX_PAGE_SIZE), 0);
+    EXPECT_EQ(PageCodec::Decompress(compressed.data(), len, out.data(), MAX_PAGE_SIZE / 2), -1);
+
+    // 随机数据不可压缩
+    rand_buf(page.data(), MAX_PAGE_SIZE);
+    EXPECT_EQ(PageCodec::Compress(page.data(), MAX_PAGE_SIZE, compressed.data(), MAX_PAGE_SIZE - 1), -1);
+}
+
+/**
+ * @brief 测试多个线程并发地打开、读写、查询和关闭文件
+ */
+TEST_F(DiskManagerTest, ConcurrentFileRegistry) {
+    constexpr int NUM_THREADS = 8;
+    constexpr int ROUNDS = 50;
+    std::vector<std::string> filenames;
+    for (int i = 0; i < NUM_THREADS; i++) {
+        filenames.push_back("ConcurrentFileRegistryTestFile" + std::to_string(i));
+        if (disk_manager_->is_file(filenames[i])) {
+            disk_manager_->destroy_file(filenames[i]);
+        }
+        disk_manager_->create_file(filenames[i]);
+    }
+
+    std::atomic<bool> stop{false};
+    // 不断查询任意 fd 的文件名：文件要么已打开，要么抛出 FileNotOpenError
+    std::thread reader([&] {
+        while (!stop) {
+            for (int fd = 0; fd < 64; fd++) {
+                try {
+                    disk_manager_->GetFileName(fd);
+                } catch (FileNotOpenError &) {
+                }
+            }
+        }
+    });
+    std::vector<std::thread> workers;
+    for (int i = 0; i < NUM_THREADS; i++) {
+        workers.emplace_back([&, i] {
+            char data[PAGE_SIZE];
+            char buf[PAGE_SIZE];
+            memset(data, i, PAGE_SIZE);
+            for (int round = 0; round < ROUNDS; round++) {
+                int fd = disk_manager_->open_file(filenames[i]);
+                EXPECT_EQ(disk_manager_->GetFileFd(filenames[i]), fd);
+                EXPECT_EQ(disk_manager_->GetFileName(fd), filenames[i]);
+                disk_manager_->write_page(fd, round % 4, data, PAGE_SIZE);
+                disk_manager_->read_page(fd, round % 4, buf, PAGE_SIZE);
+                EXPECT_EQ(memcmp(buf, data, PAGE_SIZE), 0);
+                disk_manager_->close_file(fd);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    stop = true;
+    reader.join();
+
+    int fd = disk_manager_->open_file(filenames[0]);
+    disk_manager_->close_file(fd);
+    char buf[PAGE_SIZE];
+    EXPECT_THROW(disk_manager_->read_page(fd, 0, buf, PAGE_SIZE), FileNotOpenError);
+    EXPECT_THROW(disk_manager_->close_file(fd), FileNotOpenError);
+    for (auto &filename : filenames) {
+        disk_manager_->destroy_file(filename);
+    }
+}
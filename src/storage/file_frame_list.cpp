@@ -0,0 +1,50 @@
+#include "file_frame_list.h"
+
+void FileFrameList::Insert(int fd, frame_id_t frame_id) {
+    if (owner_[frame_id] == fd) {
+        return;
+    }
+    Erase(frame_id);
+    Head &head = heads_[fd];
+    next_[frame_id] = head.first;
+    prev_[frame_id] = INVALID_FRAME_ID;
+    if (head.first != INVALID_FRAME_ID) {
+        prev_[head.first] = frame_id;
+    }
+    head.first = frame_id;
+    head.size++;
+    owner_[frame_id] = fd;
+}
+
+void FileFrameList::Erase(frame_id_t frame_id) {
+    int fd = owner_[frame_id];
+    if (fd == NO_FILE) {
+        return;
+    }
+    auto it = heads_.find(fd);
+    frame_id_t prev = prev_[frame_id];
+    frame_id_t next = next_[frame_id];
+    if (prev != INVALID_FRAME_ID) {
+        next_[prev] = next;
+    } else {
+        it->second.first = next;
+    }
+    if (next != INVALID_FRAME_ID) {
+        prev_[next] = prev;
+    }
+    next_[frame_id] = prev_[frame_id] = INVALID_FRAME_ID;
+    owner_[frame_id] = NO_FILE;
+    if (--it->second.size == 0) {
+        heads_.erase(it);
+    }
+}
+
+void FileFrameList::Collect(int fd, std::vector<frame_id_t> *frames) const {
+    auto it = heads_.find(fd);
+    if (it == heads_.end()) {
+        return;
+    }
+    for (frame_id_t frame_id = it->second.first; frame_id != INVALID_FRAME_ID; frame_id = next_[frame_id]) {
+        frames->push_back(frame_id);
+    }
+}
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// file_frame_list.h
+//
+// Identification: src/storage/file_frame_list.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * @brief 按文件把缓冲池分区中的帧串成侵入式双向链表，帧号就是链表结点
+ * @note 前驱、后继按帧号存在定长数组中，插入删除不分配内存；每个帧同一时刻最多在一个文件的链表中。
+ * 修改和遍历都由调用者串行化（BufferPoolInstance 的 latch）
+ */
+class FileFrameList {
+   public:
+    /**
+     * @param num_frames 分区的帧数
+     */
+    explicit FileFrameList(size_t num_frames)
+        : next_(num_frames, INVALID_FRAME_ID), prev_(num_frames, INVALID_FRAME_ID), owner_(num_frames, NO_FILE) {}
+
+    DISALLOW_COPY(FileFrameList);
+
+    /**
+     * @brief 把帧加入文件 fd 的链表，帧已在某个链表中时先移出
+     */
+    void Insert(int fd, frame_id_t frame_id);
+
+    /**
+     * @brief 把帧移出它所在的链表，不在任何链表中时什么也不做
+     */
+    void Erase(frame_id_t frame_id);
+
+    bool Contains(frame_id_t frame_id) const { return owner_[frame_id] != NO_FILE; }
+
+    /** @return 文件 fd 的链表中的帧数 */
+    size_t Size(int fd) const {
+        auto it = heads_.find(fd);
+        return it == heads_.end() ? 0 : it->second.size;
+    }
+
+    /**
+     * @brief 把文件 fd 的链表中的帧追加到 frames
+     */
+    void Collect(int fd, std::vector<frame_id_t> *frames) const;
+
+   private:
+    static constexpr int NO_FILE = -1;
+
+    struct Head {
+        frame_id_t first = INVALID_FRAME_ID;
+        size_t size = 0;
+    };
+
+    /** 每个文件的链表头，链表为空时删除 */
+    std::unordered_map<int, Head> heads_;
+    std::vector<frame_id_t> next_;
+    std::vector<frame_id_t> prev_;
+    /** 帧所在链表的文件，不在链表中时为 NO_FILE */
+    std::vector<int> owner_;
+};
@@ -0,0 +1,93 @@
+#include "storage/file_registry.h"
+
+#include <mutex>
+
+FileRegistry::FileRegistry() {
+    for (auto &chunk : chunks_) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+FileRegistry::~FileRegistry() {
+    for (auto &chunk : chunks_) {
+        Chunk *c = chunk.load(std::memory_order_relaxed);
+        if (c == nullptr) {
+            continue;
+        }
+        for (auto &entry : c->entries) {
+            delete entry.load(std::memory_order_relaxed);
+        }
+        delete c;
+    }
+}
+
+FileEntry *FileRegistry::Get(int fd) const {
+    if (fd < 0 || fd >= CHUNK_SIZE * MAX_CHUNKS) {
+        return nullptr;
+    }
+    Chunk *chunk = chunks_[fd / CHUNK_SIZE].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        return nullptr;
+    }
+    return chunk->entries[fd % CHUNK_SIZE].load(std::memory_order_acquire);
+}
+
+FileEntry *FileRegistry::GetOrCreate(int fd) {
+    if (fd < 0 || fd >= CHUNK_SIZE * MAX_CHUNKS) {
+        throw FileNotOpenError(fd);
+    }
+    auto &chunk_slot = chunks_[fd / CHUNK_SIZE];
+    Chunk *chunk = chunk_slot.load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        auto *new_chunk = new Chunk();
+        for (auto &entry : new_chunk->entries) {
+            entry.store(nullptr, std::memory_order_relaxed);
+        }
+        if (chunk_slot.compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel)) {
+            chunk = new_chunk;
+        } else {
+            delete new_chunk;  // 其他线程已经分配，chunk 为其分配的块
+        }
+    }
+    auto &entry_slot = chunk->entries[fd % CHUNK_SIZE];
+    FileEntry *entry = entry_slot.load(std::memory_order_acquire);
+    if (entry == nullptr) {
+        auto *new_entry = new FileEntry();
+        if (entry_slot.compare_exchange_strong(entry, new_entry, std::memory_order_acq_rel)) {
+            entry = new_entry;
+        } else {
+            delete new_entry;
+        }
+    }
+    return entry;
+}
+
+FileRef FileRegistry::Acquire(int fd) const {
+    FileEntry *entry = Get(fd);
+    if (entry == nullptr) {
+        throw FileNotOpenError(fd);
+    }
+    // 先增加引用计数再检查 open，与 close_file 中先清除 open 再等待引用归零配合
+    entry->refs.fetch_add(1, std::memory_order_seq_cst);
+    FileRef ref(entry);
+    if (!entry->open.load(std::memory_order_seq_cst)) {
+        throw FileNotOpenError(fd);
+    }
+    return ref;
+}
+
+int FileRegistry::FindFd(const std::string &path) const {
+    std::shared_lock lock{path_latch_};
+    auto it = path2fd_.find(path);
+    return it == path2fd_.end() ? -1 : it->second;
+}
+
+bool FileRegistry::Register(const std::string &path, int fd) {
+    std::unique_lock lock{path_latch_};
+    return path2fd_.emplace(path, fd).second;
+}
+
+void FileRegistry::Unregister(const std::string &path) {
+    std::unique_lock lock{path_latch_};
+    path2fd_.erase(path);
+}
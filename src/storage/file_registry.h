@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// file_registry.h
+//
+// Identification: src/storage/file_registry.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "errors.h"
+#include "storage/compressed_page_map.h"
+#include "storage/free_space_map.h"
+
+/**
+ * @brief 一个文件描述符对应的文件状态
+ * @note FileEntry 按 fd 编号分配后一直保留到 FileRegistry 析构，fd 被关闭后再次打开时复用，
+ * 因此无锁查找拿到的指针始终有效；文件是否打开以 open 为准
+ */
+struct FileEntry {
+    std::atomic<bool> open{false};
+    std::atomic<int> refs{0};                // 正在使用该文件的 FileRef 个数，close_file 等待其归零
+    std::mutex close_latch;                  // 与 close_cv 配合，close_file 在其上等待 refs 归零
+    std::condition_variable close_cv;
+    std::string path;                        // 只在 open 为 false 时修改
+    std::atomic<page_id_t> next_page_no{0};  // 在文件中分配的 page no 个数
+    bool direct = false;                     // 是否以 O_DIRECT 方式打开
+    std::atomic<off_t> reserved{0};          // 已用 fallocate 预留到的偏移量
+    std::unique_ptr<FreeSpaceMap> fsm;       // 空闲页面表，没有则为 nullptr，由 DiskManager::fsm_latch_ 保护
+    std::unique_ptr<CompressedPageMap> cmap;  // 压缩文件的页面位置表，非压缩文件为 nullptr
+
+    /** 文件关闭后重置为初始状态 */
+    void Reset() {
+        path.clear();
+        next_page_no = 0;
+        direct = false;
+        reserved = 0;
+        fsm.reset();
+        cmap.reset();
+    }
+};
+
+/**
+ * @brief 持有 FileEntry 的引用计数，析构时释放；持有期间 close_file 不会关闭该文件
+ */
+class FileRef {
+   public:
+    explicit FileRef(FileEntry *entry) : entry_(entry) {}
+
+    FileRef(FileRef &&other) noexcept : entry_(other.entry_) { other.entry_ = nullptr; }
+
+    ~FileRef() {
+        if (entry_ == nullptr) {
+            return;
+        }
+        // 与 close_file 中先清除 open 再检查 refs 配合：两者至少有一方看到对方的修改
+        if (entry_->refs.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+            !entry_->open.load(std::memory_order_seq_cst)) {
+            std::scoped_lock lock{entry_->close_latch};
+            entry_->close_cv.notify_all();
+        }
+    }
+
+    DISALLOW_COPY(FileRef);
+
+    FileEntry *operator->() const { return entry_; }
+
+    FileEntry &operator*() const { return *entry_; }
+
+   private:
+    FileEntry *entry_;
+};
+
+/**
+ * @brief 线程安全的文件注册表：按 fd 无锁查找文件状态，按路径查找 fd
+ * @note fd 表是两级的分块数组，块在首次用到时用 CAS 分配，容量随 fd 增长而无需整体搬移；
+ * 路径表只在打开/关闭文件时修改，用读写锁保护，查询之间互不阻塞
+ */
+class FileRegistry {
+   public:
+    static constexpr int CHUNK_SIZE = 1024;
+    static constexpr int MAX_CHUNKS = 1024;
+
+    FileRegistry();
+
+    ~FileRegistry();
+
+    DISALLOW_COPY(FileRegistry);
+
+    /** @return fd 对应的 FileEntry，从未用过的 fd 返回 nullptr（无锁） */
+    FileEntry *Get(int fd) const;
+
+    /** @return fd 对应的 FileEntry，不存在时创建（无锁） */
+    FileEntry *GetOrCreate(int fd);
+
+    /**
+     * @brief 获取已打开文件的引用
+     * @note 文件未打开或正在关闭时抛出 FileNotOpenError
+     */
+    FileRef Acquire(int fd) const;
+
+    /** @return 已打开的 path 对应的 fd，未打开时返回 -1 */
+    int FindFd(const std::string &path) const;
+
+    /**
+     * @brief 登记已打开的文件
+     * @return path 已被其他线程登记时返回 false
+     */
+    bool Register(const std::string &path, int fd);
+
+    void Unregister(const std::string &path);
+
+   private:
+    struct Chunk {
+        std::atomic<FileEntry *> entries[CHUNK_SIZE];
+    };
+
+    std::atomic<Chunk *> chunks_[MAX_CHUNKS];
+
+    std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
+    mutable std::shared_mutex path_latch_;
+};
@@ -0,0 +1,60 @@
+#include "frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+void FrameArena::Allocate(size_t size) {
+    Release();
+    if (USE_HUGE_PAGES && size >= HUGE_PAGE_SIZE) {
+        // 多映射一个大页，把起始地址对齐到 HUGE_PAGE_SIZE 后归还首尾多余的部分
+        size_t mapped_size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void *raw = mmap(nullptr, mapped_size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw != MAP_FAILED) {
+            auto begin = reinterpret_cast<uintptr_t>(raw);
+            auto aligned = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            if (aligned > begin) {
+                munmap(raw, aligned - begin);
+            }
+            size_t tail = begin + HUGE_PAGE_SIZE - aligned;
+            if (tail > 0) {
+                munmap(reinterpret_cast<void *>(aligned + mapped_size), tail);
+            }
+            // 内核不支持透明大页时 madvise 失败，内存仍可按普通页使用
+            madvise(reinterpret_cast<void *>(aligned), mapped_size, MADV_HUGEPAGE);
+            data_ = reinterpret_cast<char *>(aligned);
+            mapped_size_ = mapped_size;
+            return;
+        }
+    }
+    // 匿名映射的内存已经清零，aligned_alloc 的需要手动清零
+    data_ = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, size));
+    if (data_ == nullptr) {
+        throw std::bad_alloc();
+    }
+    memset(data_, 0, size);
+}
+
+void FrameArena::Release() {
+    if (data_ == nullptr) {
+        return;
+    }
+    if (mapped_size_ > 0) {
+        munmap(data_, mapped_size_);
+    } else {
+        std::free(data_);
+    }
+    data_ = nullptr;
+    mapped_size_ = 0;
+}
+
+void FrameArena::Discard(size_t offset, size_t size) {
+    if (mapped_size_ == 0 || size == 0) {
+        return;
+    }
+    madvise(data_ + offset, size, MADV_DONTNEED);
+}
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// frame_arena.h
+//
+// Identification: src/storage/frame_arena.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * @brief 缓冲池分区中所有帧的页面数据所在的连续内存
+ * @note 不小于 HUGE_PAGE_SIZE 时用匿名 mmap 按 HUGE_PAGE_SIZE 对齐分配，并通过 madvise(MADV_HUGEPAGE)
+ * 请求透明大页，扫描和换页时 TLB 只需覆盖很少几个表项；mmap 失败、内存较小或 USE_HUGE_PAGES 关闭时
+ * 退回 aligned_alloc。两种方式得到的内存都按 DIRECT_IO_ALIGNMENT 对齐并已清零。
+ * mmap 的内存只在第一次访问时才占用物理内存，为在线扩容预留的帧在启用之前不占内存
+ */
+class FrameArena {
+   public:
+    FrameArena() = default;
+
+    ~FrameArena() { Release(); }
+
+    DISALLOW_COPY(FrameArena);
+
+    /**
+     * @brief 释放已有内存后分配 size 字节
+     * @throws std::bad_alloc 分配失败
+     */
+    void Allocate(size_t size);
+
+    /** @brief 释放内存，未分配时什么也不做 */
+    void Release();
+
+    /**
+     * @brief 把 [offset, offset + size) 这段内存还给操作系统，之后再访问时按零页重新分配
+     * @note 只对 mmap 分配的内存有效，aligned_alloc 分配的内存保持不变；用于缓冲池缩小后退役的帧
+     */
+    void Discard(size_t offset, size_t size);
+
+    char *GetData() const { return data_; }
+
+    /** @return 内存是否由 mmap 分配并请求了大页 */
+    bool IsHugePageBacked() const { return mapped_size_ > 0; }
+
+   private:
+    char *data_ = nullptr;
+    /** mmap 映射的字节数，aligned_alloc 分配时为 0 */
+    size_t mapped_size_ = 0;
+};
@@ -0,0 +1,60 @@
+#include "storage/free_space_map.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr size_t FSM_WORDS = (FreeSpaceMap::CAPACITY + 63) / 64;
+
+FreeSpaceMap::FreeSpaceMap(page_id_t num_pages) : num_pages_(num_pages), bitmap_(FSM_WORDS, 0) {}
+
+std::unique_ptr<FreeSpaceMap> FreeSpaceMap::Deserialize(const char *buf) {
+    uint32_t magic;
+    uint32_t num_pages;
+    memcpy(&magic, buf, sizeof(magic));
+    memcpy(&num_pages, buf + sizeof(magic), sizeof(num_pages));
+    if (magic != MAGIC) {
+        return nullptr;
+    }
+    auto fsm = std::make_unique<FreeSpaceMap>(static_cast<page_id_t>(num_pages));
+    memcpy(fsm->bitmap_.data(), buf + 2 * sizeof(uint32_t), CAPACITY / 8);
+    fsm->dirty_ = false;
+    return fsm;
+}
+
+void FreeSpaceMap::Serialize(char *buf) const {
+    uint32_t magic = MAGIC;
+    uint32_t num_pages = num_pages_;
+    memset(buf, 0, SIZE);
+    memcpy(buf, &magic, sizeof(magic));
+    memcpy(buf + sizeof(magic), &num_pages, sizeof(num_pages));
+    memcpy(buf + 2 * sizeof(uint32_t), bitmap_.data(), CAPACITY / 8);
+}
+
+page_id_t FreeSpaceMap::Allocate() {
+    dirty_ = true;
+    for (; hint_ < bitmap_.size(); hint_++) {
+        if (bitmap_[hint_] != 0) {
+            int bit = __builtin_ctzll(bitmap_[hint_]);
+            bitmap_[hint_] &= ~(1ULL << bit);
+            return static_cast<page_id_t>(hint_ * 64 + bit);
+        }
+    }
+    return num_pages_++;
+}
+
+void FreeSpaceMap::Free(page_id_t page_no) {
+    if (page_no < 0 || page_no >= num_pages_ || page_no >= CAPACITY) {
+        return;
+    }
+    size_t word = page_no / 64;
+    bitmap_[word] |= 1ULL << (page_no % 64);
+    hint_ = std::min(hint_, word);
+    dirty_ = true;
+}
+
+bool FreeSpaceMap::IsFree(page_id_t page_no) const {
+    if (page_no < 0 || page_no >= num_pages_ || page_no >= CAPACITY) {
+        return false;
+    }
+    return (bitmap_[page_no / 64] >> (page_no % 64)) & 1;
+}
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// free_space_map.h
+//
+// Identification: src/storage/free_space_map.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * @brief 文件级空闲页面表，记录文件已分配的页面数（高水位）以及被释放、可以复用的页面
+ * @note 持久化在文件第 0 页（文件头页）的 [PAGE_OFFSET, PAGE_SIZE)，PAGE_SIZE 是最小的页面大小，与数据库的页面大小无关；
+ * 第 0 页开头仍由上层存放 file header，因此上层的 file header 不能超过 PAGE_OFFSET 个字节；
+ * 未创建空闲页面表的文件仍按追加方式分配页面
+ */
+class FreeSpaceMap {
+   public:
+    /** 在第 0 页中的起始偏移量 */
+    static constexpr int PAGE_OFFSET = 128;
+    /** 序列化后占用的字节数 */
+    static constexpr int SIZE = PAGE_SIZE - PAGE_OFFSET;
+
+    /**
+     * @param num_pages 文件当前已分配的页面数，新分配的页面编号从 num_pages 开始
+     */
+    explicit FreeSpaceMap(page_id_t num_pages);
+
+    /**
+     * @brief 从第 0 页尾部读出的 SIZE 个字节中恢复空闲页面表
+     * @return 没有合法的空闲页面表（魔数不匹配）时返回 nullptr
+     */
+    static std::unique_ptr<FreeSpaceMap> Deserialize(const char *buf);
+
+    void Serialize(char *buf) const;
+
+    /**
+     * @brief 分配一个页面：优先复用编号最小的空闲页面，否则扩展文件
+     */
+    page_id_t Allocate();
+
+    /**
+     * @brief 释放页面；超出可记录范围的页面不会被复用
+     */
+    void Free(page_id_t page_no);
+
+    bool IsFree(page_id_t page_no) const;
+
+    page_id_t GetNumPages() const { return num_pages_; }
+
+    /** 自上次 ClearDirty() 以来是否被修改过 */
+    bool IsDirty() const { return dirty_; }
+
+    void ClearDirty() { dirty_ = false; }
+
+    /** 可以记录的最大页面编号（不含） */
+    static constexpr page_id_t CAPACITY = (SIZE - 2 * sizeof(uint32_t)) * 8;
+
+   private:
+    static constexpr uint32_t MAGIC = 0x314d5346;  // "FSM1"
+
+    page_id_t num_pages_;
+    std::vector<uint64_t> bitmap_;  // 第 i 位为 1 表示页面 i 空闲
+    size_t hint_ = 0;               // bitmap_ 中第一个可能含有空闲页面的字
+    bool dirty_ = true;
+};
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <cstring>
+
 #include "common/config.h"
 #include "common/rwlatch.h"
 
@@ -38,21 +40,38 @@ struct PageId {
 };
 
 // PageId的自定义哈希算法, 用于构建unordered_map<PageId, frame_id_t, PageIdHash>
+// 把 (fd, page_no) 拼成 64 位整数后用 splitmix64 的终结函数混合，page_no 超过 65536 时也不会与其他文件的页面冲突
 struct PageIdHash {
-    size_t operator()(const PageId &x) const { return (x.fd << 16) | x.page_no; }
+    static uint64_t Key(const PageId &x) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x.fd)) << 32) | static_cast<uint32_t>(x.page_no);
+    }
+
+    static uint64_t Mix(uint64_t h) {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    size_t operator()(const PageId &x) const { return Mix(Key(x)); }
 };
 
 /**
  @brief Page类声明, Page是rucbase数据块的单位.
  @note Page是负责数据操作Record模块的操作对象.
  @note Page对象在磁盘上有文件存储, 若在Buffer中则有帧偏移, 并非特指Buffer或Disk上的数据
+ @note Page 只是帧描述符，页面数据在 BufferPoolInstance 的帧内存中。描述符按缓存行对齐，换页和 pin/unpin
+ 常用的字段集中在第一个缓存行里，相邻帧的描述符不会共享缓存行
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
     friend class BufferPoolManager;
+    friend class BufferPoolInstance;
 
    public:
-    /** Constructor. Zeros out the page data. */
-    Page() { ResetMemory(); }
+    /** Constructor. 页面数据所在的内存由 BufferPoolManager 统一分配后绑定 */
+    Page() = default;
 
     /** Default destructor. */
     ~Page() = default;
@@ -85,22 +104,28 @@ class Page {
     inline void SetPageLsn(lsn_t page_lsn) { memcpy(GetData() + OFFSET_LSN, &page_lsn, sizeof(lsn_t)); }
 
    private:
-    void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }  // 将data_的PAGE_SIZE个字节填充为0
+    void ResetMemory(int page_size) { memset(data_, OFFSET_PAGE_START, page_size); }  // 将data_的page_size个字节填充为0
 
     /** page的唯一标识符 */
     PageId id_;
 
-    /** The actual data that is stored within a page.
-     *  该页面在bufferPool中的偏移地址
-     */
-    char data_[PAGE_SIZE] = {};
+    /** The pin count of this page. */
+    int pin_count_ = 0;
 
     /** 脏页判断 */
     bool is_dirty_ = false;
 
-    /** The pin count of this page. */
-    int pin_count_ = 0;
+    /** 帧正在换入（写回旧页面、读入新页面），由 BufferPoolInstance 的 latch 保护 */
+    bool io_in_progress_ = false;
+
+    /** The actual data that is stored within a page.
+     *  该页面在bufferPool中的偏移地址，指向 BufferPoolManager 按 DIRECT_IO_ALIGNMENT 对齐分配的帧内存
+     */
+    char *data_ = nullptr;
 
     /** Page latch. */
     ReaderWriterLatch rwlatch_;
-};
\ No newline at end of file
+};
+
+static_assert(alignof(Page) == CACHE_LINE_SIZE && sizeof(Page) % CACHE_LINE_SIZE == 0,
+              "frame descriptors must not share cache lines");
@@ -0,0 +1,149 @@
+#include "storage/page_codec.h"
+
+#include <cstdint>
+#include <cstring>
+
+static inline uint32_t load32(const char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 写入 255 进制的扩展长度，空间不足时返回 false
+static inline bool put_length(char *dst, int dst_capacity, int *op, int len) {
+    for (; len >= 255; len -= 255) {
+        if (*op >= dst_capacity) {
+            return false;
+        }
+        dst[(*op)++] = static_cast<char>(255);
+    }
+    if (*op >= dst_capacity) {
+        return false;
+    }
+    dst[(*op)++] = static_cast<char>(len);
+    return true;
+}
+
+// 输出一个序列：[anchor, anchor + lit_len) 的字面量，以及一个偏移为 offset、长度为 match_len 的匹配（match_len 为 0 表示最后一个序列）
+static bool put_sequence(char *dst, int dst_capacity, int *op, const char *literals, int lit_len, int offset,
+                         int match_len) {
+    if (*op >= dst_capacity) {
+        return false;
+    }
+    int token_pos = (*op)++;
+    int lit_code = lit_len >= 15 ? 15 : lit_len;
+    int match_code = 0;
+    if (lit_len >= 15 && !put_length(dst, dst_capacity, op, lit_len - 15)) {
+        return false;
+    }
+    if (*op + lit_len > dst_capacity) {
+        return false;
+    }
+    memcpy(dst + *op, literals, lit_len);
+    *op += lit_len;
+    if (match_len > 0) {
+        if (*op + 2 > dst_capacity) {
+            return false;
+        }
+        dst[(*op)++] = static_cast<char>(offset & 0xff);
+        dst[(*op)++] = static_cast<char>(offset >> 8);
+        int len = match_len - 4;
+        match_code = len >= 15 ? 15 : len;
+        if (len >= 15 && !put_length(dst, dst_capacity, op, len - 15)) {
+            return false;
+        }
+    }
+    dst[token_pos] = static_cast<char>(lit_code << 4 | match_code);
+    return true;
+}
+
+int PageCodec::Compress(const char *src, int src_size, char *dst, int dst_capacity) {
+    int table[1 << HASH_LOG];
+    memset(table, -1, sizeof(table));
+    int ip = 0;
+    int anchor = 0;
+    int op = 0;
+    while (ip + MIN_MATCH <= src_size) {
+        uint32_t seq = load32(src + ip);
+        uint32_t h = (seq * 2654435761u) >> (32 - HASH_LOG);
+        int ref = table[h];
+        table[h] = ip;
+        if (ref < 0 || ip - ref > MAX_OFFSET || load32(src + ref) != seq) {
+            ip++;
+            continue;
+        }
+        int len = MIN_MATCH;
+        while (ip + len < src_size && src[ref + len] == src[ip + len]) {
+            len++;
+        }
+        if (!put_sequence(dst, dst_capacity, &op, src + anchor, ip - anchor, ip - ref, len)) {
+            return -1;
+        }
+        ip += len;
+        anchor = ip;
+    }
+    if (!put_sequence(dst, dst_capacity, &op, src + anchor, src_size - anchor, 0, 0)) {
+        return -1;
+    }
+    return op;
+}
+
+int PageCodec::Decompress(const char *src, int src_size, char *dst, int dst_capacity) {
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(src);
+    int ip = 0;
+    int op = 0;
+    while (ip < src_size) {
+        int token = in[ip++];
+        int lit_len = token >> 4;
+        if (lit_len == 15) {
+            int b;
+            do {
+                if (ip >= src_size) {
+                    return -1;
+                }
+                b = in[ip++];
+                lit_len += b;
+            } while (b == 255);
+        }
+        if (ip + lit_len > src_size || op + lit_len > dst_capacity) {
+            return -1;
+        }
+        memcpy(dst + op, src + ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+        if (ip == src_size) {
+            break;  // 最后一个序列没有匹配
+        }
+        if (ip + 2 > src_size) {
+            return -1;
+        }
+        int offset = in[ip] | in[ip + 1] << 8;
+        ip += 2;
+        int match_len = token & 15;
+        if (match_len == 15) {
+            int b;
+            do {
+                if (ip >= src_size) {
+                    return -1;
+                }
+                b = in[ip++];
+                match_len += b;
+            } while (b == 255);
+        }
+        match_len += MIN_MATCH;
+        if (offset == 0 || offset > op || op + match_len > dst_capacity) {
+            return -1;
+        }
+        // 匹配可能与输出重叠（如偏移量为 1 的连续 0），需要逐字节复制
+        const char *match = dst + op - offset;
+        if (offset >= match_len) {
+            memcpy(dst + op, match, match_len);
+        } else {
+            for (int i = 0; i < match_len; i++) {
+                dst[op + i] = match[i];
+            }
+        }
+        op += match_len;
+    }
+    return op;
+}
@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// page_codec.h
+//
+// Identification: src/storage/page_codec.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+/**
+ * @brief 页面压缩使用的 LZ77 类快速压缩算法，格式与 LZ4 block 格式相同
+ * @note 每个序列为 token（高 4 位为字面量长度，低 4 位为匹配长度 - 4）、扩展长度字节、字面量、
+ * 2 字节小端匹配偏移量；最后一个序列只有字面量。用 CHAR(n) 补 0 的记录页面压缩率很高
+ */
+class PageCodec {
+   public:
+    /**
+     * @brief 压缩 src 中的 src_size 个字节
+     * @param dst_capacity dst 的大小，压缩结果超过该大小时放弃压缩
+     * @return 压缩后的字节数，放弃压缩时返回 -1
+     */
+    static int Compress(const char *src, int src_size, char *dst, int dst_capacity);
+
+    /**
+     * @brief 解压缩 src 中的 src_size 个字节到 dst
+     * @return 解压后的字节数，数据损坏或 dst 空间不足时返回 -1
+     */
+    static int Decompress(const char *src, int src_size, char *dst, int dst_capacity);
+
+   private:
+    static constexpr int MIN_MATCH = 4;
+    static constexpr int HASH_LOG = 12;
+    static constexpr int MAX_OFFSET = 65535;
+};
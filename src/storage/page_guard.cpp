@@ -0,0 +1,85 @@
+#include "page_guard.h"
+
+#include <utility>
+
+#include "buffer_pool_instance.h"
+
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : instance_(that.instance_), frame_id_(that.frame_id_), page_(that.page_), is_dirty_(that.is_dirty_) {
+    that.instance_ = nullptr;
+    that.frame_id_ = INVALID_FRAME_ID;
+    that.page_ = nullptr;
+    that.is_dirty_ = false;
+}
+
+BasicPageGuard &BasicPageGuard::operator=(BasicPageGuard &&that) noexcept {
+    if (this != &that) {
+        Drop();
+        instance_ = that.instance_;
+        frame_id_ = that.frame_id_;
+        page_ = that.page_;
+        is_dirty_ = that.is_dirty_;
+        that.instance_ = nullptr;
+        that.frame_id_ = INVALID_FRAME_ID;
+        that.page_ = nullptr;
+        that.is_dirty_ = false;
+    }
+    return *this;
+}
+
+void BasicPageGuard::Drop() {
+    if (page_ != nullptr) {
+        instance_->UnpinFrame(frame_id_, is_dirty_);
+    }
+    instance_ = nullptr;
+    frame_id_ = INVALID_FRAME_ID;
+    page_ = nullptr;
+    is_dirty_ = false;
+}
+
+ReadPageGuard BasicPageGuard::UpgradeRead() { return ReadPageGuard(std::move(*this)); }
+
+WritePageGuard BasicPageGuard::UpgradeWrite() { return WritePageGuard(std::move(*this)); }
+
+ReadPageGuard::ReadPageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {
+    if (guard_.IsValid()) {
+        guard_.page_->RLatch();
+    }
+}
+
+ReadPageGuard &ReadPageGuard::operator=(ReadPageGuard &&that) noexcept {
+    if (this != &that) {
+        Drop();
+        guard_ = std::move(that.guard_);
+    }
+    return *this;
+}
+
+void ReadPageGuard::Drop() {
+    if (guard_.IsValid()) {
+        // 先释放 latch 再 unpin，unpin 之后页面可能被换出
+        guard_.page_->RUnlatch();
+        guard_.Drop();
+    }
+}
+
+WritePageGuard::WritePageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {
+    if (guard_.IsValid()) {
+        guard_.page_->WLatch();
+    }
+}
+
+WritePageGuard &WritePageGuard::operator=(WritePageGuard &&that) noexcept {
+    if (this != &that) {
+        Drop();
+        guard_ = std::move(that.guard_);
+    }
+    return *this;
+}
+
+void WritePageGuard::Drop() {
+    if (guard_.IsValid()) {
+        guard_.page_->WUnlatch();
+        guard_.Drop();
+    }
+}
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// page_guard.h
+//
+// Identification: src/storage/page_guard.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "page.h"
+
+class BufferPoolInstance;
+class ReadPageGuard;
+class WritePageGuard;
+
+/**
+ * @brief 持有页面一次 pin 的 RAII 对象，析构时按帧号直接 unpin，不必再到页表中查找页面
+ * @note 只能移动、不能复制；不持有页面 latch，用于已由上层的锁保护的页面（如 B+树由 root_latch_ 串行化）。
+ * 通过 GetDataMut/AsMut 修改过页面时，unpin 时自动置脏
+ */
+class BasicPageGuard {
+    friend class ReadPageGuard;
+    friend class WritePageGuard;
+
+   public:
+    BasicPageGuard() = default;
+
+    BasicPageGuard(BufferPoolInstance *instance, frame_id_t frame_id, Page *page)
+        : instance_(instance), frame_id_(frame_id), page_(page) {}
+
+    BasicPageGuard(const BasicPageGuard &) = delete;
+    BasicPageGuard &operator=(const BasicPageGuard &) = delete;
+
+    BasicPageGuard(BasicPageGuard &&that) noexcept;
+
+    BasicPageGuard &operator=(BasicPageGuard &&that) noexcept;
+
+    ~BasicPageGuard() { Drop(); }
+
+    /**
+     * @brief 提前 unpin 页面，之后 guard 为空
+     */
+    void Drop();
+
+    /**
+     * @brief 对页面加读 latch，页面的 pin 转移给返回的 guard
+     */
+    ReadPageGuard UpgradeRead();
+
+    /**
+     * @brief 对页面加写 latch，页面的 pin 和脏标记转移给返回的 guard
+     */
+    WritePageGuard UpgradeWrite();
+
+    /** @return 缓冲池分配失败时 guard 为空 */
+    bool IsValid() const { return page_ != nullptr; }
+
+    PageId GetPageId() const { return page_->GetPageId(); }
+
+    /** @return 页面，只用于读取 */
+    Page *GetPage() const { return page_; }
+
+    /** @return 页面，unpin 时会被置脏 */
+    Page *AsMut() {
+        is_dirty_ = true;
+        return page_;
+    }
+
+    const char *GetData() const { return page_->GetData(); }
+
+    /** @return 页面数据，unpin 时会被置脏 */
+    char *GetDataMut() { return AsMut()->GetData(); }
+
+    void MarkDirty() { is_dirty_ = true; }
+
+   private:
+    BufferPoolInstance *instance_ = nullptr;
+    frame_id_t frame_id_ = INVALID_FRAME_ID;
+    Page *page_ = nullptr;
+    bool is_dirty_ = false;
+};
+
+/**
+ * @brief 持有页面 pin 和读 latch 的 RAII 对象，析构时先释放 latch 再 unpin
+ */
+class ReadPageGuard {
+   public:
+    ReadPageGuard() = default;
+
+    /** 对 guard 中的页面加读 latch */
+    explicit ReadPageGuard(BasicPageGuard &&guard);
+
+    ReadPageGuard(const ReadPageGuard &) = delete;
+    ReadPageGuard &operator=(const ReadPageGuard &) = delete;
+
+    ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
+    ReadPageGuard &operator=(ReadPageGuard &&that) noexcept;
+
+    ~ReadPageGuard() { Drop(); }
+
+    void Drop();
+
+    bool IsValid() const { return guard_.IsValid(); }
+
+    PageId GetPageId() const { return guard_.GetPageId(); }
+
+    Page *GetPage() const { return guard_.GetPage(); }
+
+    const char *GetData() const { return guard_.GetData(); }
+
+   private:
+    BasicPageGuard guard_;
+};
+
+/**
+ * @brief 持有页面 pin 和写 latch 的 RAII 对象，析构时先释放 latch 再 unpin
+ * @note 通过 GetDataMut/AsMut 修改过页面时，unpin 时自动置脏
+ */
+class WritePageGuard {
+   public:
+    WritePageGuard() = default;
+
+    /** 对 guard 中的页面加写 latch */
+    explicit WritePageGuard(BasicPageGuard &&guard);
+
+    WritePageGuard(const WritePageGuard &) = delete;
+    WritePageGuard &operator=(const WritePageGuard &) = delete;
+
+    WritePageGuard(WritePageGuard &&that) noexcept = default;
+
+    WritePageGuard &operator=(WritePageGuard &&that) noexcept;
+
+    ~WritePageGuard() { Drop(); }
+
+    void Drop();
+
+    bool IsValid() const { return guard_.IsValid(); }
+
+    PageId GetPageId() const { return guard_.GetPageId(); }
+
+    Page *GetPage() const { return guard_.GetPage(); }
+
+    Page *AsMut() { return guard_.AsMut(); }
+
+    const char *GetData() const { return guard_.GetData(); }
+
+    char *GetDataMut() { return guard_.GetDataMut(); }
+
+    void MarkDirty() { guard_.MarkDirty(); }
+
+   private:
+    BasicPageGuard guard_;
+};
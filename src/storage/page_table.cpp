@@ -0,0 +1,90 @@
+#include "page_table.h"
+
+#include <cassert>
+
+PageTable::PageTable(size_t max_entries) {
+    size_t capacity = 16;
+    int bits = 4;
+    while (capacity < max_entries * 2) {
+        capacity <<= 1;
+        bits++;
+    }
+    slots_ = std::make_unique<Slot[]>(capacity);
+    mask_ = capacity - 1;
+    shift_ = 64 - bits;
+}
+
+size_t PageTable::Probe(uint64_t key) const {
+    size_t i = Home(key);
+    while (true) {
+        uint64_t k = slots_[i].key.load(std::memory_order_relaxed);
+        if (k == key || k == EMPTY_KEY) {
+            return i;
+        }
+        i = (i + 1) & mask_;
+    }
+}
+
+bool PageTable::Find(PageId page_id, frame_id_t *frame_id) const {
+    uint64_t key = PageIdHash::Key(page_id);
+    while (true) {
+        uint64_t version = version_.load(std::memory_order_acquire);
+        if (version & 1) {
+            continue;  // 修改进行中
+        }
+        // 表中至少有一半是空槽位，探测一定会结束
+        size_t i = Probe(key);
+        bool found = slots_[i].key.load(std::memory_order_relaxed) == key;
+        frame_id_t result = slots_[i].frame_id.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == version) {
+            if (found) {
+                *frame_id = result;
+            }
+            return found;
+        }
+    }
+}
+
+void PageTable::Insert(PageId page_id, frame_id_t frame_id) {
+    uint64_t key = PageIdHash::Key(page_id);
+    size_t i = Probe(key);
+    BeginWrite();
+    if (slots_[i].key.load(std::memory_order_relaxed) == EMPTY_KEY) {
+        slots_[i].key.store(key, std::memory_order_relaxed);
+        size_++;
+    }
+    slots_[i].frame_id.store(frame_id, std::memory_order_relaxed);
+    EndWrite();
+    assert(size_ <= (mask_ + 1) / 2);
+}
+
+bool PageTable::Erase(PageId page_id) {
+    uint64_t key = PageIdHash::Key(page_id);
+    size_t i = Probe(key);
+    if (slots_[i].key.load(std::memory_order_relaxed) != key) {
+        return false;
+    }
+    BeginWrite();
+    // 回移：把探测链上后面的元素移到空出的槽位，只要它的起始槽位不在 (i, j] 之间
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask_;
+        uint64_t k = slots_[j].key.load(std::memory_order_relaxed);
+        if (k == EMPTY_KEY) {
+            break;
+        }
+        size_t home = Home(k);
+        bool in_range = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!in_range) {
+            slots_[i].key.store(k, std::memory_order_relaxed);
+            slots_[i].frame_id.store(slots_[j].frame_id.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            i = j;
+        }
+    }
+    slots_[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+    slots_[i].frame_id.store(INVALID_FRAME_ID, std::memory_order_relaxed);
+    size_--;
+    EndWrite();
+    return true;
+}
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// page_table.h
+//
+// Identification: src/storage/page_table.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "page.h"
+
+/**
+ * @brief 缓冲池的页表：PageId -> frame_id 的定长开放寻址哈希表（线性探测）
+ * @note 容量在构造时按帧数确定（负载因子不超过 1/2），运行期间不分配内存；删除采用回移（backward shift），不留墓碑。
+ * 修改操作由调用者串行化（BufferPoolInstance 的 latch）；Find 不加锁，用版本号校验与并发的修改是否重叠，重叠时重试
+ */
+class PageTable {
+   public:
+    /**
+     * @param max_entries 最多同时存放的页面数，即缓冲池分区的帧数
+     */
+    explicit PageTable(size_t max_entries);
+
+    DISALLOW_COPY(PageTable);
+
+    /**
+     * @brief 查找页面所在的帧，可以与修改操作并发执行
+     * @return 页面不在表中时返回 false
+     */
+    bool Find(PageId page_id, frame_id_t *frame_id) const;
+
+    bool Contains(PageId page_id) const {
+        frame_id_t frame_id;
+        return Find(page_id, &frame_id);
+    }
+
+    /**
+     * @brief 插入页面，页面已存在时修改它所在的帧
+     */
+    void Insert(PageId page_id, frame_id_t frame_id);
+
+    /**
+     * @return 页面是否在表中
+     */
+    bool Erase(PageId page_id);
+
+    size_t Size() const { return size_; }
+
+    bool Empty() const { return size_ == 0; }
+
+    size_t GetCapacity() const { return mask_ + 1; }
+
+   private:
+    /** 空槽位的 key，对应 PageId{-1, -1}，不会是合法的页面 */
+    static constexpr uint64_t EMPTY_KEY = ~0ULL;
+
+    /** 16 字节的槽位，一个 cache line 容纳 4 个 */
+    struct alignas(16) Slot {
+        std::atomic<uint64_t> key{EMPTY_KEY};
+        std::atomic<frame_id_t> frame_id{INVALID_FRAME_ID};
+    };
+
+    /** 取哈希值的高位作为起始槽位：BufferPoolManager 用低位选择分区，同一分区中页面的哈希值低位相同 */
+    size_t Home(uint64_t key) const { return PageIdHash::Mix(key) >> shift_; }
+
+    /** @return key 所在的槽位，不存在时返回探测到的第一个空槽位 */
+    size_t Probe(uint64_t key) const;
+
+    void BeginWrite() {
+        version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void EndWrite() { version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    int shift_;
+    size_t size_ = 0;
+    /** 修改期间为奇数 */
+    std::atomic<uint64_t> version_{0};
+};
@@ -0,0 +1,94 @@
+/**
+ * @brief 页表的微基准：对比 PageTable 与 std::unordered_map（原来的 (fd << 16) | page_no 哈希和新的混合哈希）
+ * @note 用法：page_table_bench [num_frames] [num_ops]
+ * 模拟缓冲池的访问：表中始终有 num_frames 个页面，90% 的操作是命中的查找，其余是换页（删除一个页面、插入一个新页面）
+ */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "page_table.h"
+
+struct ShiftPageIdHash {
+    size_t operator()(const PageId &x) const { return (x.fd << 16) | x.page_no; }
+};
+
+template <typename Hash>
+class MapAdapter {
+   public:
+    explicit MapAdapter(size_t num_frames) { map_.reserve(num_frames); }
+
+    bool Find(PageId page_id, frame_id_t *frame_id) const {
+        auto it = map_.find(page_id);
+        if (it == map_.end()) {
+            return false;
+        }
+        *frame_id = it->second;
+        return true;
+    }
+
+    void Insert(PageId page_id, frame_id_t frame_id) { map_[page_id] = frame_id; }
+
+    bool Erase(PageId page_id) { return map_.erase(page_id) > 0; }
+
+   private:
+    std::unordered_map<PageId, frame_id_t, Hash> map_;
+};
+
+template <typename Table>
+static double run(size_t num_frames, int num_ops) {
+    Table table(num_frames);
+    std::mt19937 rng(0);
+    // 页面编号分布在 [0, 1 << 20)，分属 4 个文件
+    std::uniform_int_distribution<page_id_t> page_dist(0, (1 << 20) - 1);
+    std::vector<PageId> resident(num_frames);
+    frame_id_t frame_id;
+    for (size_t i = 0; i < num_frames; i++) {
+        do {
+            resident[i] = PageId{static_cast<int>(3 + i % 4), page_dist(rng)};
+        } while (table.Find(resident[i], &frame_id));
+        table.Insert(resident[i], static_cast<frame_id_t>(i));
+    }
+
+    std::vector<uint32_t> ops(num_ops);
+    for (auto &op : ops) {
+        op = rng();
+    }
+    long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_ops; i++) {
+        size_t frame = ops[i] % num_frames;
+        if (ops[i] % 10 != 0) {
+            if (table.Find(resident[frame], &frame_id)) {
+                checksum += frame_id;
+            }
+        } else {
+            table.Erase(resident[frame]);
+            PageId page_id = {resident[frame].fd, page_dist(rng)};
+            if (!table.Find(page_id, &frame_id)) {
+                resident[frame] = page_id;
+            }
+            table.Insert(resident[frame], static_cast<frame_id_t>(frame));
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (checksum == -1) {
+        printf("unreachable\n");
+    }
+    return elapsed.count() / num_ops;
+}
+
+int main(int argc, char **argv) {
+    size_t num_frames = argc > 1 ? std::stoul(argv[1]) : BUFFER_POOL_SIZE;
+    int num_ops = argc > 2 ? std::stoi(argv[2]) : 20000000;
+
+    printf("frames = %zu, ops = %d\n", num_frames, num_ops);
+    printf("%-40s %8.2f ns/op\n", "unordered_map, (fd << 16) | page_no",
+           run<MapAdapter<ShiftPageIdHash>>(num_frames, num_ops));
+    printf("%-40s %8.2f ns/op\n", "unordered_map, PageIdHash", run<MapAdapter<PageIdHash>>(num_frames, num_ops));
+    printf("%-40s %8.2f ns/op\n", "PageTable", run<PageTable>(num_frames, num_ops));
+    return 0;
+}
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Rucbase
+//
+// read_ahead.h
+//
+// Identification: src/storage/read_ahead.h
+//
+// Copyright (c) 2022, RUC Deke Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+
+#include "common/config.h"
+
+/**
+ * @brief 扫描的自适应预读窗口
+ * @note 访问保持顺序（页面编号逐个递增）时，每当扫描推进到上一次预读范围的后半段，就预读下一批页面，
+ * 窗口从 READ_AHEAD_MIN_PAGES 开始每次加倍，直到 READ_AHEAD_MAX_PAGES；出现跳跃访问时窗口重置
+ */
+class ReadAheadWindow {
+   public:
+    /**
+     * @brief 记录一次对页面 page_no 的访问
+     * @param end 可预读的页面编号上界（不含），如文件的页面数
+     * @param[out] first 需要预读的第一个页面
+     * @return 需要预读的页面数，为 0 时不需要预读
+     */
+    int OnAccess(page_id_t page_no, page_id_t end, page_id_t *first) {
+        if (page_no == last_) {
+            return 0;
+        }
+        bool sequential = last_ == INVALID_PAGE_ID || page_no == last_ + 1;
+        last_ = page_no;
+        if (!sequential) {
+            window_ = READ_AHEAD_MIN_PAGES;
+            next_ = trigger_ = page_no + 1;
+            return 0;
+        }
+        if (page_no < trigger_) {
+            return 0;
+        }
+        *first = std::max(next_, page_no + 1);
+        int count = std::min<int>(window_, end - *first);
+        if (count <= 0) {
+            return 0;
+        }
+        next_ = *first + count;
+        trigger_ = next_ - count / 2;
+        window_ = std::min(window_ * 2, READ_AHEAD_MAX_PAGES);
+        return count;
+    }
+
+    int GetWindow() const { return window_; }
+
+   private:
+    page_id_t last_ = INVALID_PAGE_ID;  // 上一次访问的页面
+    page_id_t next_ = 0;                // 尚未预读的第一个页面
+    page_id_t trigger_ = 0;             // 访问到该页面时发起下一次预读
+    int window_ = READ_AHEAD_MIN_PAGES;
+};
@@ -4,3 +4,4 @@
 #include <string>
 
 static const std::string DB_META_NAME = "db.meta";
+static const std::string BUFFER_POOL_DUMP_NAME = "buffer_pool.dump";  // 热页面列表，open_db 时据此预热缓冲池
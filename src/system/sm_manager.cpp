@@ -3,6 +3,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 
 #include "index/ix.h"
@@ -14,10 +16,31 @@ bool SmManager::is_dir(const std::string &db_name) {
     return stat(db_name.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
 }
 
-void SmManager::create_db(const std::string &db_name) {
-    // 查询执行 task1 Todo
+void SmManager::create_db(const std::string &db_name, int page_size) {
+    if (is_dir(db_name)) {
+        throw DatabaseExistsError(db_name);
+    }
+    if (!DiskManager::is_valid_page_size(page_size)) {
+        throw InvalidPageSizeError(page_size);
+    }
     // 利用*inx命令创建目录作为数据库
-    // 查询执行 task1 Todo End
+    std::string cmd = "mkdir " + db_name;
+    if (system(cmd.c_str()) < 0) {
+        throw UnixError();
+    }
+    if (chdir(db_name.c_str()) < 0) {
+        throw UnixError();
+    }
+    // 创建元数据文件，页面大小记录在其中，之后 open_db 时据此设置存储层的页面大小
+    DbMeta new_db;
+    new_db.name_ = db_name;
+    new_db.page_size_ = page_size;
+    std::ofstream ofs(DB_META_NAME);
+    ofs << new_db;
+    ofs.close();
+    if (chdir("..") < 0) {
+        throw UnixError();
+    }
 }
 
 void SmManager::drop_db(const std::string &db_name) {
@@ -43,11 +66,14 @@ void SmManager::open_db(const std::string &db_name) {
     std::ifstream ifs(DB_META_NAME);
     // 将ofs打开的DB_META_NAME文件中的信息，按照定义好的operator>>操作符，读出到db_中
     ifs >> db_;  // 注意：此处重载了操作符>>
+    // 按数据库的页面大小设置缓冲池和磁盘管理器
+    buffer_pool_manager_->SetPageSize(db_.page_size_);
     // Open all record files & index files
     for (auto &entry : db_.tabs_) {
         auto &tab = entry.second;
         // fhs_[tab.name] = rm_manager_->open_file(tab.name);
         fhs_.emplace(tab.name, rm_manager_->open_file(tab.name));
+        open_buffer_pool(tab.name, fhs_.at(tab.name)->GetFd());
         for (size_t i = 0; i < tab.cols.size(); i++) {
             auto &col = tab.cols[i];
             if (col.index) {
@@ -55,12 +81,57 @@ void SmManager::open_db(const std::string &db_name) {
                 assert(ihs_.count(index_name) == 0);
                 // ihs_[index_name] = ix_manager_->open_index(tab.name, i);
                 ihs_.emplace(index_name, ix_manager_->open_index(tab.name, i));
+                open_buffer_pool(index_name, ihs_.at(index_name)->GetFd());
             }
         }
     }
+    // 后台按上次转储的热页面列表预热缓冲池，不阻塞之后的请求；之后定期更新转储
+    buffer_pool_manager_->StartPrewarm(BUFFER_POOL_DUMP_NAME);
+    buffer_pool_manager_->StartPageDumper(BUFFER_POOL_DUMP_NAME, BUFFER_POOL_DUMP_INTERVAL_MS);
+}
+
+/**
+ * @brief 按 db_ 中记录的分配把刚打开的文件放入命名缓冲池；该缓冲池在本次启动时没有配置则使用默认缓冲池
+ */
+void SmManager::open_buffer_pool(const std::string &file_name, int fd) {
+    auto pos = db_.buffer_pools_.find(file_name);
+    if (pos == db_.buffer_pools_.end()) {
+        return;
+    }
+    if (!buffer_pool_manager_->HasPool(pos->second)) {
+        LOG_WARN("Buffer pool %s of %s is not configured, use the default buffer pool.", pos->second.c_str(),
+                 file_name.c_str());
+        return;
+    }
+    buffer_pool_manager_->SetFilePool(fd, pos->second);
+}
+
+void SmManager::flush_meta() {
+    // 默认清空文件
+    std::ofstream ofs(DB_META_NAME);
+    ofs << db_;
+}
+
+void SmManager::set_buffer_pool(const std::string &file_name, int fd, const std::string &buffer_pool) {
+    buffer_pool_manager_->SetFilePool(fd, buffer_pool.empty() ? DEFAULT_BUFFER_POOL : buffer_pool);
+    // 缓冲池的名字不区分大小写，按添加时的名字记录
+    const std::string &name = buffer_pool_manager_->GetFilePool(fd);
+    if (name == DEFAULT_BUFFER_POOL) {
+        db_.buffer_pools_.erase(file_name);
+    } else {
+        db_.buffer_pools_[file_name] = name;
+    }
 }
 
 void SmManager::close_db() {
+    // 关闭文件之前转储热页面列表，下次 open_db 时据此预热缓冲池
+    buffer_pool_manager_->StopPageDumper();
+    buffer_pool_manager_->StopPrewarm();
+    try {
+        buffer_pool_manager_->DumpHotPages(BUFFER_POOL_DUMP_NAME);
+    } catch (UnixError &e) {
+        LOG_WARN("Failed to dump the hot pages: %s", e.what());
+    }
     // 查询执行 task1 Todo
     // 清理db_
     // 关闭rm_manager_ ix_manager_文件
@@ -68,6 +139,45 @@ void SmManager::close_db() {
     // 查询执行 task1 Todo End
 }
 
+void SmManager::set_variable(const std::string &var_name, int val, Context *context) {
+    std::string name = var_name;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    const std::string suffix = "_buffer_pool_size";
+    if (name == "buffer_pool_size") {
+        if (val <= 0) {
+            throw InvalidPoolSizeError(val);
+        }
+        buffer_pool_manager_->Resize(val);
+    } else if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0 &&
+               buffer_pool_manager_->HasPool(name.substr(0, name.size() - suffix.size()))) {
+        if (val <= 0) {
+            throw InvalidPoolSizeError(val);
+        }
+        buffer_pool_manager_->Resize(name.substr(0, name.size() - suffix.size()), val);
+    } else {
+        throw UnknownVariableError(var_name);
+    }
+}
+
+void SmManager::show_buffer_pools(Context *context) {
+    std::vector<std::string> captions = {"Buffer pool", "Replacer", "Size", "Max size", "Pages",
+                                         "Hits",        "Misses",   "Hit rate", "Dirty evictions"};
+    RecordPrinter printer(captions.size());
+    printer.print_separator(context);
+    printer.print_record(captions, context);
+    printer.print_separator(context);
+    for (auto &stats : buffer_pool_manager_->GetPoolStats()) {
+        size_t accesses = stats.hits + stats.misses;
+        std::string hit_rate = accesses == 0 ? "-" : std::to_string(stats.hits * 100 / accesses) + "%";
+        printer.print_record({stats.name, stats.replacer_type, std::to_string(stats.pool_size),
+                              std::to_string(stats.max_pool_size), std::to_string(stats.num_pages),
+                              std::to_string(stats.hits), std::to_string(stats.misses), hit_rate,
+                              std::to_string(stats.dirty_evictions)},
+                             context);
+    }
+    printer.print_separator(context);
+}
+
 void SmManager::show_tables(Context *context) {
     RecordPrinter printer(1);
     printer.print_separator(context);
@@ -98,10 +208,14 @@ void SmManager::desc_table(const std::string &tab_name, Context *context) {
     printer.print_separator(context);
 }
 
-void SmManager::create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context) {
+void SmManager::create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context,
+                             const std::string &buffer_pool) {
     if (db_.is_table(tab_name)) {
         throw TableExistsError(tab_name);
     }
+    if (!buffer_pool.empty() && !buffer_pool_manager_->HasPool(buffer_pool)) {
+        throw BufferPoolNotFoundError(buffer_pool);
+    }
     // Create table meta
     int curr_offset = 0;
     TabMeta tab;
@@ -122,6 +236,13 @@ void SmManager::create_table(const std::string &tab_name, const std::vector<ColD
     db_.tabs_[tab_name] = tab;
     // fhs_[tab_name] = rm_manager_->open_file(tab_name);
     fhs_.emplace(tab_name, rm_manager_->open_file(tab_name));
+    set_buffer_pool(tab_name, fhs_.at(tab_name)->GetFd(), buffer_pool);
+}
+
+void SmManager::set_table_buffer_pool(const std::string &tab_name, const std::string &buffer_pool, Context *context) {
+    db_.get_table(tab_name);
+    set_buffer_pool(tab_name, fhs_.at(tab_name)->GetFd(), buffer_pool);
+    flush_meta();
 }
 
 void SmManager::drop_table(const std::string &tab_name, Context *context) {
@@ -132,28 +253,35 @@ void SmManager::drop_table(const std::string &tab_name, Context *context) {
     // 查询执行 task1 Todo End
 }
 
-void SmManager::create_index(const std::string &tab_name, const std::string &col_name, Context *context) {
+void SmManager::create_index(const std::string &tab_name, const std::string &col_name, Context *context,
+                             const std::string &buffer_pool) {
     TabMeta &tab = db_.get_table(tab_name);
     auto col = tab.get_col(col_name);
     if (col->index) {
         throw IndexExistsError(tab_name, col_name);
     }
+    if (!buffer_pool.empty() && !buffer_pool_manager_->HasPool(buffer_pool)) {
+        throw BufferPoolNotFoundError(buffer_pool);
+    }
     // Create index file
     int col_idx = col - tab.cols.begin();
     ix_manager_->create_index(tab_name, col_idx, col->type, col->len);  // 这里调用了
     // Open index file
     auto ih = ix_manager_->open_index(tab_name, col_idx);
+    auto index_name = ix_manager_->get_index_name(tab_name, col_idx);
+    // 建索引时插入的页面就放在索引所在的缓冲池中
+    set_buffer_pool(index_name, ih->GetFd(), buffer_pool);
     // Get record file handle
     auto file_handle = fhs_.at(tab_name).get();
     // Index all records into index
     for (RmScan rm_scan(file_handle); !rm_scan.is_end(); rm_scan.next()) {
-        auto rec = file_handle->get_record(rm_scan.rid(), context);  // rid是record的存储位置，作为value插入到索引里
+        // rid是record的存储位置，作为value插入到索引里；读取大表时通过扫描的环读取，不挤掉缓冲池中的页面
+        auto rec = file_handle->get_record(rm_scan.rid(), context, rm_scan.get_strategy());
         const char *key = rec->data + col->offset;
         // record data里以各个属性的offset进行分隔，属性的长度为col len，record里面每个属性的数据作为key插入索引里
         ih->insert_entry(key, rm_scan.rid(), context->txn_);
     }
     // Store index handle
-    auto index_name = ix_manager_->get_index_name(tab_name, col_idx);
     assert(ihs_.count(index_name) == 0);
     // ihs_[index_name] = std::move(ih);
     ihs_.emplace(index_name, std::move(ih));
@@ -172,5 +300,18 @@ void SmManager::drop_index(const std::string &tab_name, const std::string &col_n
     ix_manager_->close_index(ihs_.at(index_name).get());
     ix_manager_->destroy_index(tab_name, col_idx);
     ihs_.erase(index_name);
+    db_.buffer_pools_.erase(index_name);
     col->index = false;
 }
+
+void SmManager::set_index_buffer_pool(const std::string &tab_name, const std::string &col_name,
+                                      const std::string &buffer_pool, Context *context) {
+    TabMeta &tab = db_.get_table(tab_name);
+    auto col = tab.get_col(col_name);
+    if (!col->index) {
+        throw IndexNotFoundError(tab_name, col_name);
+    }
+    auto index_name = ix_manager_->get_index_name(tab_name, col - tab.cols.begin());
+    set_buffer_pool(index_name, ihs_.at(index_name)->GetFd(), buffer_pool);
+    flush_meta();
+}
@@ -63,27 +63,70 @@ class SmManager {
     // Database management
     bool is_dir(const std::string &db_name);
 
-    void create_db(const std::string &db_name);
+    /**
+     * @param page_size 数据库的页面大小，必须是 [PAGE_SIZE, MAX_PAGE_SIZE] 之间 2 的幂
+     */
+    void create_db(const std::string &db_name, int page_size = PAGE_SIZE);
 
     void drop_db(const std::string &db_name);
 
+    /**
+     * @note 打开文件后在后台按 BUFFER_POOL_DUMP_NAME 中的热页面列表预热缓冲池，并每 BUFFER_POOL_DUMP_INTERVAL_MS
+     * 毫秒更新一次该列表
+     */
     void open_db(const std::string &db_name);
 
+    /**
+     * @note 关闭文件前把缓冲池的热页面列表转储到 BUFFER_POOL_DUMP_NAME
+     */
     void close_db();
 
+    /**
+     * @brief 修改运行时配置，目前支持 buffer_pool_size（在线修改默认缓冲池的帧数，见 BufferPoolManager::Resize）
+     * 和 <name>_buffer_pool_size（修改命名缓冲池 name 的帧数）
+     * @param var_name 变量名，不区分大小写
+     */
+    void set_variable(const std::string &var_name, int val, Context *context);
+
+    /**
+     * @brief 打印各命名缓冲池的大小、替换策略和命中率等统计信息
+     */
+    void show_buffer_pools(Context *context);
+
     // Table management
     void show_tables(Context *context);
 
     void desc_table(const std::string &tab_name, Context *context);
 
-    void create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context);
+    /**
+     * @param buffer_pool 表的页面所在的命名缓冲池，为空时使用默认缓冲池
+     */
+    void create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context,
+                      const std::string &buffer_pool = "");
+
+    /**
+     * @brief 把表移到命名缓冲池 buffer_pool：表已在缓冲池中的页面写回后移出，之后在新的缓冲池中换入
+     * @note 移动期间其他事务对该表的页面访问等待，表还有页面被其他事务 pin 住时抛出 InternalError；
+     * 修改立即写入元数据文件，重启后仍然有效
+     */
+    void set_table_buffer_pool(const std::string &tab_name, const std::string &buffer_pool, Context *context);
 
     void drop_table(const std::string &tab_name, Context *context);
 
     void apply_drop_table(const std::string &tab_name, Context *context);
 
     // Index management
-    void create_index(const std::string &tab_name, const std::string &col_name, Context *context);
+    /**
+     * @param buffer_pool 索引的页面所在的命名缓冲池，为空时使用默认缓冲池
+     */
+    void create_index(const std::string &tab_name, const std::string &col_name, Context *context,
+                      const std::string &buffer_pool = "");
+
+    /**
+     * @brief 把索引移到命名缓冲池 buffer_pool，见 set_table_buffer_pool
+     */
+    void set_index_buffer_pool(const std::string &tab_name, const std::string &col_name,
+                               const std::string &buffer_pool, Context *context);
 
     void drop_index(const std::string &tab_name, const std::string &col_name, Context *context);
 
@@ -147,4 +190,16 @@ class SmManager {
      * @param col_name the name of the column on which index is created
      */
     void rollback_drop_index(const std::string &tab_name, const std::string &col_name, Context *context);
+
+   private:
+    /** 把 db_ 写回元数据文件 DB_META_NAME */
+    void flush_meta();
+
+    void open_buffer_pool(const std::string &file_name, int fd);
+
+    /**
+     * @brief 把表或索引文件 file_name（已打开为 fd）分配到命名缓冲池 buffer_pool，并记录在 db_ 中
+     * @param buffer_pool 为空时使用默认缓冲池
+     */
+    void set_buffer_pool(const std::string &file_name, int fd, const std::string &buffer_pool);
 };
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "common/config.h"
 #include "errors.h"
 #include "sm_defs.h"
 
@@ -84,6 +85,8 @@ class DbMeta {
    private:
     std::string name_;                     // 数据库名称
     std::map<std::string, TabMeta> tabs_;  // 数据库内的表名称和元数据的映射
+    int page_size_ = PAGE_SIZE;            // 数据库的页面大小，create_db 时确定
+    std::map<std::string, std::string> buffer_pools_;  // 表或索引的文件名 -> 所在的命名缓冲池，不在其中的使用默认缓冲池
 
    public:
     // DbMeta(std::string name) : name_(name) {}
@@ -98,12 +101,23 @@ class DbMeta {
         return pos->second;
     }
 
+    int get_page_size() const { return page_size_; }
+
     // 重载操作符 <<
+    // 表之后以 "page_size <n>" 的形式记录页面大小，旧版本的元数据文件没有这一项，读出时使用默认的 PAGE_SIZE；
+    // 之后以 "buffer_pools <n>" 和 n 行 "<文件名> <缓冲池>" 记录分配到命名缓冲池的表和索引，没有时不写
     friend std::ostream &operator<<(std::ostream &os, const DbMeta &db_meta) {
         os << db_meta.name_ << '\n' << db_meta.tabs_.size() << '\n';
         for (auto &entry : db_meta.tabs_) {
             os << entry.second << '\n';  // entry.second是TabMeta类型，然后调用重载的TabMeta的操作符<<
         }
+        os << "page_size " << db_meta.page_size_ << '\n';
+        if (!db_meta.buffer_pools_.empty()) {
+            os << "buffer_pools " << db_meta.buffer_pools_.size() << '\n';
+            for (auto &entry : db_meta.buffer_pools_) {
+                os << entry.first << ' ' << entry.second << '\n';
+            }
+        }
         return os;
     }
 
@@ -115,6 +129,21 @@ class DbMeta {
             is >> tab;
             db_meta.tabs_[tab.name] = tab;
         }
+        std::string key;
+        db_meta.page_size_ = PAGE_SIZE;
+        db_meta.buffer_pools_.clear();
+        while (is >> key) {
+            if (key == "page_size") {
+                is >> db_meta.page_size_;
+            } else if (key == "buffer_pools") {
+                is >> n;
+                for (size_t i = 0; i < n; i++) {
+                    std::string file_name;
+                    is >> file_name;
+                    is >> db_meta.buffer_pools_[file_name];
+                }
+            }
+        }
         return is;
     }
 };